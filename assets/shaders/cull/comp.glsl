@@ -0,0 +1,115 @@
+#version 430 core
+
+layout (local_size_x = 64) in;
+
+struct ResidentChunk {
+    uint num_vertices;
+    uint first_vertex;
+    uint block_offset;
+    uint unused;
+    ivec4 position;
+};
+
+struct DrawCommand {
+    uint count;
+    uint instance_count;
+    uint first;
+    uint base_instance;
+};
+
+layout (std430, binding = 0) readonly buffer ResidentChunks {
+    ResidentChunk resident_chunks[];
+};
+
+//NOTE: survivors are compacted to the front, the rest of the commands stays zeroed (count = 0 draws nothing)
+layout (std430, binding = 1) writeonly buffer DrawCommands {
+    DrawCommand draw_commands[];
+};
+
+layout (std430, binding = 2) writeonly buffer ChunkDraws {
+    ivec4 chunk_draws[];
+};
+
+layout (std430, binding = 3) buffer DrawCount {
+    uint draw_count;
+};
+
+//NOTE: one bit per resident chunk, set if the cave search from the camera's chunk reached it
+layout (std430, binding = 4) readonly buffer CaveVisibility {
+    uint cave_visible[];
+};
+
+uniform int num_resident;
+uniform int chunk_size;
+uniform vec4 frustum_planes[6];
+uniform int cave_culling_enabled;
+
+//NOTE: max-depth pyramid of the previous frame and the view projection it was rendered with
+uniform int occlusion_enabled;
+uniform sampler2D hiz;
+uniform ivec2 hiz_size;
+uniform int hiz_levels;
+uniform mat4 hiz_view_projection;
+
+bool is_box_in_frustum(vec3 box_min, vec3 box_max) {
+    for (int i = 0; i < 6; i++) {
+        vec4 plane = frustum_planes[i];
+        vec3 positive = mix(box_min, box_max, greaterThanEqual(plane.xyz, vec3(0.0)));
+        if (dot(plane.xyz, positive) + plane.w < 0.0) return false;
+    }
+    return true;
+}
+
+bool is_box_occluded(vec3 box_min, vec3 box_max) {
+    vec2 uv_min = vec2(1.0);
+    vec2 uv_max = vec2(0.0);
+    float depth_min = 1.0;
+    for (int i = 0; i < 8; i++) {
+        vec3 corner = mix(box_min, box_max, vec3(i & 1, (i >> 1) & 1, (i >> 2) & 1));
+        vec4 clip = hiz_view_projection * vec4(corner, 1.0);
+        //NOTE: the box reaches behind the previous camera, nothing to test against
+        if (clip.w <= 0.0) return false;
+
+        vec3 ndc = clip.xyz / clip.w;
+        uv_min = min(uv_min, ndc.xy * 0.5 + 0.5);
+        uv_max = max(uv_max, ndc.xy * 0.5 + 0.5);
+        depth_min = min(depth_min, ndc.z * 0.5 + 0.5);
+    }
+    //NOTE: (partly) outside the previous view, the pyramid doesn't know what's there
+    if (any(lessThan(uv_min, vec2(0.0))) || any(greaterThan(uv_max, vec2(1.0)))) return false;
+
+    ivec2 texel_min = clamp(ivec2(uv_min * vec2(hiz_size)), ivec2(0), hiz_size - 1);
+    ivec2 texel_max = clamp(ivec2(uv_max * vec2(hiz_size)), ivec2(0), hiz_size - 1);
+
+    //LEVEL: the smallest one where the rectangle covers at most 2x2 texels
+    int extent = max(texel_max.x - texel_min.x, texel_max.y - texel_min.y);
+    int level = min(extent <= 1 ? 0 : findMSB(extent - 1) + 1, hiz_levels - 1);
+    texel_min >>= level;
+    texel_max >>= level;
+
+    float depth_max = max(
+        max(texelFetch(hiz, texel_min, level).r, texelFetch(hiz, ivec2(texel_max.x, texel_min.y), level).r),
+        max(texelFetch(hiz, ivec2(texel_min.x, texel_max.y), level).r, texelFetch(hiz, texel_max, level).r)
+    );
+    return depth_min > depth_max;
+}
+
+void main() {
+    uint index = gl_GlobalInvocationID.x;
+    if (index >= uint(num_resident)) return;
+
+    ResidentChunk chunk = resident_chunks[index];
+    if (chunk.num_vertices == 0u) return;
+    //NOTE: slots added after the last cave search have no bit yet, they are kept (the search runs again once they draw)
+    uint cave_word = index / 32u;
+    if (cave_culling_enabled != 0 && cave_word < uint(cave_visible.length()) && (cave_visible[cave_word] & (1u << (index % 32u))) == 0u) return;
+
+    vec3 box_min = vec3(chunk.position.xyz);
+    vec3 box_max = box_min + vec3(chunk_size);
+    if (!is_box_in_frustum(box_min, box_max)) return;
+    if (occlusion_enabled != 0 && is_box_occluded(box_min, box_max)) return;
+
+    uint draw = atomicAdd(draw_count, 1u);
+    draw_commands[draw] = DrawCommand(chunk.num_vertices, 1u, chunk.first_vertex, draw);
+    chunk_draws[draw] = ivec4(chunk.position.xyz, int(chunk.block_offset));
+}
\ No newline at end of file
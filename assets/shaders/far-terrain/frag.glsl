@@ -0,0 +1,33 @@
+#version 430 core
+
+layout (location = 0) out vec4 color;
+
+in VS_OUT {
+    vec3 position_world_space;
+    vec3 normal;
+} fs_in;
+
+//NOTE: xyz = camera position, w = voxel render distance in blocks
+uniform vec4 camera;
+uniform vec3 light_direction;
+
+//NOTE: the surface blocks the generator picks by height (Chunk terrain_block_type)
+const vec3 GRASS = vec3(0.36, 0.55, 0.25);
+const vec3 STONE = vec3(0.5, 0.5, 0.5);
+const vec3 SNOW = vec3(0.92, 0.94, 0.96);
+const vec3 HAZE = vec3(0.62, 0.74, 0.86);
+
+void main() {
+    //NOTE: the voxel chunks own everything inside the render distance
+    float distance_xz = length(fs_in.position_world_space.xz - camera.xz);
+    if (distance_xz < camera.w) discard;
+
+    float height = fs_in.position_world_space.y - 1.0;
+    vec3 albedo = height > 128.0 ? SNOW : (height > 96.0 ? STONE : GRASS);
+
+    float ambient = 0.2;
+    float diffuse = max(dot(normalize(fs_in.normal), -normalize(light_direction)), 0.0);
+    //NOTE: fades into the sky towards the horizon
+    float haze = clamp((distance_xz - camera.w) / (8.0 * camera.w), 0.0, 0.6);
+    color = vec4(mix((ambient + diffuse) * albedo, HAZE, haze), 1.0);
+}
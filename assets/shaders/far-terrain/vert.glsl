@@ -0,0 +1,54 @@
+#version 430 core
+#extension GL_ARB_shader_draw_parameters : require
+
+//NOTE: heights of every visible far terrain tile, (FAR_RESOLUTION + 1)^2 per slot (FarTerrainRenderer)
+layout (std430, binding = 5) readonly buffer FarHeights {
+    float heights[];
+};
+
+//NOTE: one entry per multi-draw command, xy = world xz of the tile's first sample, z = sample spacing, w = first height of the tile's slot
+layout (std430, binding = 6) readonly buffer FarTiles {
+    vec4 tiles[];
+};
+
+//NOTE: own projection, the far terrain lies beyond the camera's far plane
+uniform mat4 view_projection;
+
+out VS_OUT {
+    vec3 position_world_space;
+    vec3 normal;
+} vs_out;
+
+//NOTE: FAR_RESOLUTION is defined by the renderer, corners of the two triangles of a cell (bit 0 = +x, bit 1 = +z)
+const uint CELL_CORNERS[6] = uint[6](0u, 2u, 1u, 1u, 2u, 3u);
+const int SAMPLES_PER_EDGE = FAR_RESOLUTION + 1;
+//NOTE: in samples, deep enough to cover the height difference to a coarser neighbour
+const float SKIRT_DEPTH = 4.0;
+
+float height_at(int first_height, ivec2 sample_position) {
+    ivec2 clamped = clamp(sample_position, ivec2(0), ivec2(FAR_RESOLUTION));
+    return heights[first_height + clamped.x + clamped.y * SAMPLES_PER_EDGE];
+}
+
+void main() {
+    vec4 tile = tiles[gl_DrawIDARB];
+    int first_height = int(tile.w);
+
+    //NOTE: cells -1 and FAR_RESOLUTION are the skirt ring, their outer corners hang below the tile border
+    int cell = gl_VertexID / 6;
+    uint corner = CELL_CORNERS[gl_VertexID % 6];
+    ivec2 grid = ivec2(cell % (FAR_RESOLUTION + 2), cell / (FAR_RESOLUTION + 2)) - 1 + ivec2(corner & 1u, corner >> 1u);
+    ivec2 sample_position = clamp(grid, ivec2(0), ivec2(FAR_RESOLUTION));
+    bool skirt = grid != sample_position;
+
+    float spacing = tile.z;
+    float height = height_at(first_height, sample_position) - (skirt ? SKIRT_DEPTH * spacing : 0.0);
+    vec3 position_world_space = vec3(tile.x + sample_position.x * spacing, height, tile.y + sample_position.y * spacing);
+
+    //NOTE: central differences, one-sided at the tile border
+    float dx = height_at(first_height, sample_position + ivec2(1, 0)) - height_at(first_height, sample_position - ivec2(1, 0));
+    float dz = height_at(first_height, sample_position + ivec2(0, 1)) - height_at(first_height, sample_position - ivec2(0, 1));
+    vs_out.normal = normalize(vec3(-dx, 2.0 * spacing, -dz));
+    vs_out.position_world_space = position_world_space;
+    gl_Position = view_projection * vec4(position_world_space, 1.0);
+}
@@ -15,6 +15,7 @@ in VS_OUT {
     vec3 vertex;
     vec3 normal;
     vec4 frag_pos_world_space;
+    flat uint block_offset;
 } fs_in;
 
 uniform mat4 light_space_matrix;
@@ -39,13 +40,13 @@ float shadow_calculation(vec4 _frag_pos) {
 }
 
  uint access_block_type(int x, int y, int z) {
-    int SIZE = 16;
+    int SIZE = CHUNK_SIZE;
     int SIZE_VALUE_IN_BITS = 8;
     int NUM_VALUES_IN_ONE_UINT = 4;
 
     int linear_index = x + (y * SIZE) + (z * SIZE * SIZE);
     int block_index = linear_index / NUM_VALUES_IN_ONE_UINT;
-    uint area = blockData.blockTypes[block_index];
+    uint area = blockData.blockTypes[fs_in.block_offset + uint(block_index)];
     int bit_position = (linear_index % NUM_VALUES_IN_ONE_UINT) * SIZE_VALUE_IN_BITS;
     uint block = uint((area >> bit_position) & 0xFF);
     return block;
@@ -54,7 +55,7 @@ float shadow_calculation(vec4 _frag_pos) {
 void main() {
     const float epsilon = 0.5;
     ivec3 block_coords = ivec3(fs_in.vertex - normalize(fs_in.normal) * .01);
-    block_coords = clamp(block_coords, ivec3(0), ivec3(15));
+    block_coords = clamp(block_coords, ivec3(0), ivec3(CHUNK_SIZE - 1));
 
     uint block_type = access_block_type(block_coords.x, block_coords.y, block_coords.z);
 
@@ -1,29 +1,58 @@
 #version 430 core
-
-layout (location = 0) in uint vertex;
+#extension GL_ARB_shader_draw_parameters : require
 
 layout (std140, binding = 0) uniform Matrices {
     uniform mat4 projection;
     uniform mat4 view;
 };
 
-uniform mat4 model;
+//NOTE: one entry per multi-draw command, xyz = chunk position, w = first uint of the chunk's block types
+layout (std430, binding = 1) readonly buffer ChunkDraws {
+    ivec4 chunk_draws[];
+};
 
 out VS_OUT  {
     vec2 uv;
     vec3 vertex;
     vec3 normal;
     vec4 frag_pos_world_space;
+    flat uint block_offset;
 } vs_out;
 
+//NOTE: every quad of every chunk (quad arena), one packed quad per uvec2, see Mesh::pack_quad
+layout (std430, binding = 2) readonly buffer ChunkQuads {
+    uvec2 quads[];
+};
+
+//NOTE: CHUNK_SIZE is defined by the renderer (chunk size of the build)
+//NOTE: the tables mirror Mesh::QUAD_AXES / QUAD_WINDING, the axes a quad spans and the corners of its two triangles
+const ivec2 QUAD_AXES[6] = ivec2[6](ivec2(0, 2), ivec2(0, 2), ivec2(1, 2), ivec2(1, 2), ivec2(1, 0), ivec2(1, 0));
+const uint QUAD_WINDING[12] = uint[12](0u, 1u, 2u, 1u, 3u, 2u, 2u, 1u, 0u, 2u, 3u, 1u);
+const int NORMAL_AXIS[3] = int[3](1, 0, 2);
+
 void main() {
-    vec3 position_object_space = vec3((vertex >> 27u) & 0x1Fu, (vertex >> 22u) & 0x1Fu, (vertex >> 17u) & 0x1Fu);
-    vec4 position_world_space = model * vec4(position_object_space, 1.0);
+    //NOTE: no index buffer, 6 vertices per quad and gl_VertexID already includes the command's first vertex
+    uvec2 quad = quads[gl_VertexID / 6];
+    uint direction = (quad.x >> 24u) & 0x7u;
+    bool reversed = direction == 0u || direction == 3u || direction == 4u;
+    uint corner = QUAD_WINDING[(reversed ? 6 : 0) + gl_VertexID % 6];
+
+    vec3 position_object_space = vec3(quad.x & 0xFFu, (quad.x >> 8u) & 0xFFu, (quad.x >> 16u) & 0xFFu);
+    ivec2 axes = QUAD_AXES[direction];
+    position_object_space[axes.x] += float((corner & 1u) * (quad.y & 0xFFu));
+    position_object_space[axes.y] += float((corner >> 1u) * ((quad.y >> 8u) & 0xFFu));
+
+    ivec4 chunk_draw = chunk_draws[gl_DrawIDARB];
+    vec4 position_world_space = vec4(position_object_space + vec3(chunk_draw.xyz), 1.0);
     gl_Position = projection * view * position_world_space;
 
     vs_out.vertex = position_object_space;
-    vs_out.uv = vec2((vertex >> 12u) & 0x1Fu, (vertex >> 7u) & 0x1Fu);
-    int norm_flip = int((vertex >> 6u) & 0x1u);
-    vs_out.normal = ((norm_flip * 2) - 1) * vec3((vertex >> 5u) & 0x1u, (vertex >> 4u) & 0x1u, (vertex >> 3u) & 0x1u);
+    vec3 axis = vec3(0.0);
+    axis[NORMAL_AXIS[direction / 2u]] = 1.0;
+    //NOTE: even directions face along the positive axis
+    vs_out.normal = ((direction & 1u) == 0u ? 1.0 : -1.0) * axis;
+    //NOTE: the textures repeat per block, the block coordinates across the face are the texture coordinates
+    vs_out.uv = axis.y > 0.0 ? position_object_space.xz : vec2(axis.x > 0.0 ? position_object_space.z : position_object_space.x, -position_object_space.y);
     vs_out.frag_pos_world_space = position_world_space;
+    vs_out.block_offset = uint(chunk_draw.w);
 }
@@ -0,0 +1,31 @@
+#version 430 core
+
+layout (local_size_x = 8, local_size_y = 8) in;
+
+layout (r32f, binding = 0) uniform writeonly image2D destination;
+
+//NOTE: source_level = -1 copies the depth texture into level 0, otherwise the pyramid's source_level is reduced
+uniform sampler2D depth;
+uniform sampler2D pyramid;
+uniform int source_level;
+uniform ivec2 source_size;
+uniform ivec2 destination_size;
+
+void main() {
+    ivec2 texel = ivec2(gl_GlobalInvocationID.xy);
+    if (any(greaterThanEqual(texel, destination_size))) return;
+
+    if (source_level < 0) {
+        imageStore(destination, texel, vec4(texelFetch(depth, texel, 0).r));
+        return;
+    }
+
+    //NOTE: odd sizes, the last row/column only has one texel to reduce
+    ivec2 base = texel * 2;
+    ivec2 last = source_size - 1;
+    float depth_max = max(
+        max(texelFetch(pyramid, min(base, last), source_level).r, texelFetch(pyramid, min(base + ivec2(1, 0), last), source_level).r),
+        max(texelFetch(pyramid, min(base + ivec2(0, 1), last), source_level).r, texelFetch(pyramid, min(base + ivec2(1, 1), last), source_level).r)
+    );
+    imageStore(destination, texel, vec4(depth_max));
+}
\ No newline at end of file
@@ -0,0 +1,76 @@
+#include "allocation_counter.h"
+
+#include <cstdlib>
+#include <new>
+#include <Jolt/Jolt.h>
+
+namespace Voxel::Game::Benchmark {
+    //NOTE: per thread, the counting itself must not allocate or contend
+    static thread_local AllocationStats allocation_stats;
+
+    static void count_allocation(std::size_t bytes) {
+        allocation_stats.num_allocations++;
+        allocation_stats.num_bytes += bytes;
+    }
+
+    void reset_allocation_stats() {
+        allocation_stats = {};
+    }
+
+    AllocationStats get_allocation_stats() {
+        return allocation_stats;
+    }
+
+    static JPH::AllocateFunction jolt_allocate {nullptr};
+    static JPH::ReallocateFunction jolt_reallocate {nullptr};
+    static JPH::AlignedAllocateFunction jolt_aligned_allocate {nullptr};
+
+    void install_jolt_allocation_hooks() {
+        if (jolt_allocate) return;
+
+        JPH::RegisterDefaultAllocator();
+        jolt_allocate = JPH::Allocate;
+        jolt_reallocate = JPH::Reallocate;
+        jolt_aligned_allocate = JPH::AlignedAllocate;
+
+        JPH::Allocate = [](std::size_t size) {
+            count_allocation(size);
+            return jolt_allocate(size);
+        };
+        JPH::Reallocate = [](void* block, std::size_t old_size, std::size_t new_size) {
+            count_allocation(new_size);
+            return jolt_reallocate(block, old_size, new_size);
+        };
+        JPH::AlignedAllocate = [](std::size_t size, std::size_t alignment) {
+            count_allocation(size);
+            return jolt_aligned_allocate(size, alignment);
+        };
+    }
+}
+
+//GLOBAL-NEW: counted, otherwise plain malloc/free
+void* operator new(std::size_t size) {
+    Voxel::Game::Benchmark::count_allocation(size);
+    if (void* memory = std::malloc(size > 0 ? size : 1)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory) noexcept {
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
+
+void operator delete[](void* memory, std::size_t) noexcept {
+    std::free(memory);
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include <cstddef>
+
+namespace Voxel::Game::Benchmark {
+    //NOTE: allocations of the calling thread, global operator new and (once hooked) Jolt's allocation functions
+    struct AllocationStats {
+        std::size_t num_allocations {0};
+        std::size_t num_bytes {0};
+    };
+
+    void reset_allocation_stats();
+    AllocationStats get_allocation_stats();
+    //NOTE: registers Jolt's default allocator and wraps it, Jolt containers and objects don't go through operator new
+    void install_jolt_allocation_hooks();
+}
\ No newline at end of file
@@ -0,0 +1,2235 @@
+#include "benchmark.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <glm/gtc/matrix_transform.hpp>
+#include <fstream>
+#include <future>
+#include <numeric>
+#include <print>
+#include <random>
+#include <thread>
+#include <Jolt/Core/JobSystemSingleThreaded.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include "core/log.h"
+#include "allocation_counter.h"
+#include "engine/job_system.h"
+#include "engine/frustum.h"
+#include "engine/ring_allocator.h"
+#include "engine/tlsf_allocator.h"
+#include "game/chunk_draw_list.h"
+#include "game/chunk_visibility.h"
+#include "game/chunk_compound.h"
+#include "game/chunk_manager.h"
+#include "game/far_terrain.h"
+#include "game/chunk_upload_queue.h"
+#include "game/physics_streaming.h"
+#include "game/voxel_collision.h"
+#include "game/voxel_shape.h"
+
+namespace Voxel::Game::Benchmark {
+    static std::vector<glm::vec3> compound_positions_in_radius(int compound_radius, glm::ivec3 origin) {
+        std::vector<glm::vec3> positions;
+        for (int x = -compound_radius; x <= compound_radius; x++) {
+            for (int z = -compound_radius; z <= compound_radius; z++) {
+                if (x * x + z * z <= compound_radius * compound_radius) {
+                    positions.push_back(glm::vec3(origin.x + x * SIZE, 0, origin.z + z * SIZE));
+                }
+            }
+        }
+        return positions;
+    }
+
+    //FIXTURE: the compounds within compound_radius of origin, generated and (unless build_meshes is false) meshed,
+    //         unloaded and collected from the registry again when it goes out of scope
+    struct BenchWorld {
+        Noise noise;
+        std::vector<std::unique_ptr<ChunkCompound>> compounds;
+
+        BenchWorld(int compound_radius, glm::ivec3 origin, bool build_meshes = true) {
+            for (auto& position : compound_positions_in_radius(compound_radius, origin)) {
+                compounds.push_back(std::make_unique<ChunkCompound>(noise, position));
+            }
+            if (!build_meshes) return;
+            for (auto& compound : compounds) compound->build_chunk_meshes();
+        }
+
+        ~BenchWorld() {
+            for (auto& compound : compounds) compound->unload();
+            compounds.clear();
+            ChunkRegistry::get_instance().collect();
+        }
+
+        BenchWorld(const BenchWorld&) = delete;
+        BenchWorld& operator=(const BenchWorld&) = delete;
+    };
+
+    void run_generation_scaling(int compound_radius) {
+        Noise noise;
+
+        std::vector<unsigned int> thread_counts;
+        const unsigned int max_threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int threads {1}; threads < max_threads; threads *= 2) thread_counts.push_back(threads);
+        thread_counts.push_back(max_threads);
+
+        plog("generation benchmark: radius={} compounds, {} hardware threads", compound_radius, max_threads);
+
+        for (std::size_t run {0}; run < thread_counts.size(); run++) {
+            //NOTE: every run gets its own untouched region, otherwise cached neighbours would skew the numbers
+            const glm::ivec3 origin(static_cast<int>(run + 1) * SIZE * 1024, 0, 0);
+            const auto positions = compound_positions_in_radius(compound_radius, origin);
+
+            JobSystem job_system(thread_counts[run]);
+            std::vector<std::unique_ptr<ChunkCompound>> compounds(positions.size());
+
+            auto start = std::chrono::steady_clock::now();
+
+            std::vector<JobSystem::Job> jobs;
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                jobs.push_back(JobSystem::Job {
+                    [i, &positions, &compounds, &noise] {
+                        compounds[i] = std::make_unique<ChunkCompound>(noise, positions[i]);
+                    },
+                    static_cast<int>(glm::dot(positions[i] - glm::vec3(origin), positions[i] - glm::vec3(origin)))
+                });
+            }
+            job_system.submit_batch(jobs);
+            job_system.wait();
+
+            auto generated = std::chrono::steady_clock::now();
+
+            for (auto& compound : compounds) {
+                compound->collect_mesh_jobs(jobs, 0);
+            }
+            job_system.submit_batch(jobs);
+            job_system.wait();
+
+            auto meshed = std::chrono::steady_clock::now();
+
+            const double generation_seconds = std::chrono::duration<double>(generated - start).count();
+            const double total_seconds = std::chrono::duration<double>(meshed - start).count();
+            plog(
+                "threads={:>3} compounds={} generation={:.1f} ms meshing={:.1f} ms -> {:.1f} compounds/sec",
+                thread_counts[run],
+                compounds.size(),
+                generation_seconds * 1000.,
+                (total_seconds - generation_seconds) * 1000.,
+                compounds.size() / total_seconds
+            );
+
+            //DETERMINISM: the last run's compounds generated again on this thread in reverse order, the blocks must not change
+            //             (which worker got which compound, and when, must not show up in the world)
+            if (run + 1 == thread_counts.size()) {
+                constexpr std::size_t BLOCKS_COUNT = RegionStorage::NUM_BLOCKS_PER_COMPOUND;
+                std::vector<uint8_t> blocks_reference(compounds.size() * BLOCKS_COUNT);
+                std::vector<uint8_t> blocks(BLOCKS_COUNT);
+                for (std::size_t i {0}; i < compounds.size(); i++) compounds[i]->copy_blocks(&blocks_reference[i * BLOCKS_COUNT]);
+                for (auto& compound : compounds) compound->unload();
+                compounds.clear();
+                ChunkRegistry::get_instance().collect();
+
+                std::size_t num_mismatching {0};
+                for (std::size_t i = positions.size(); i-- > 0;) {
+                    ChunkCompound compound(noise, positions[i]);
+                    compound.copy_blocks(blocks.data());
+                    if (std::memcmp(&blocks_reference[i * BLOCKS_COUNT], blocks.data(), BLOCKS_COUNT) != 0) num_mismatching++;
+                }
+                ChunkRegistry::get_instance().collect();
+
+                if (num_mismatching == 0) plog("generation is deterministic: {} compounds identical in reverse order on one thread", positions.size());
+                else plog_error("generation: {} of {} compounds differ when generated in another order", num_mismatching, positions.size());
+            }
+
+            for (auto& compound : compounds) {
+                compound->unload();
+            }
+            compounds.clear();
+            ChunkRegistry::get_instance().collect();
+        }
+    }
+
+    void run_generation_paths(int compound_radius) {
+        Noise noise;
+        const auto positions = compound_positions_in_radius(compound_radius, glm::ivec3(-SIZE * 1024, 0, 0));
+        const double voxels = static_cast<double>(positions.size()) * NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC;
+        constexpr std::size_t BLOCKS_COUNT = RegionStorage::NUM_BLOCKS_PER_COMPOUND;
+
+        std::vector<uint8_t> blocks_reference(positions.size() * BLOCKS_COUNT);
+        std::vector<uint8_t> blocks(BLOCKS_COUNT);
+        std::size_t mismatching_compounds {0};
+
+        for (bool column_aware : { false, true }) {
+            Chunk::column_aware_generation = column_aware;
+            double seconds {0.};
+
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                //NOTE: trees and diamonds come from the compound's GenerationRandom, both passes draw the same sequence
+                auto start = std::chrono::steady_clock::now();
+                ChunkCompound compound(noise, positions[i]);
+                seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                uint8_t* reference = &blocks_reference[i * BLOCKS_COUNT];
+                if (!column_aware) compound.copy_blocks(reference);
+                else {
+                    compound.copy_blocks(blocks.data());
+                    if (std::memcmp(reference, blocks.data(), BLOCKS_COUNT) != 0) mismatching_compounds++;
+                }
+            }
+
+            plog(
+                "{:<12} compounds={} {:.1f} ms -> {:.2f} Mvoxels/sec",
+                column_aware ? "column-aware" : "full-scan",
+                positions.size(),
+                seconds * 1000.,
+                (voxels / seconds) / 1000000.
+            );
+        }
+
+        Chunk::column_aware_generation = true;
+        if (mismatching_compounds == 0) plog("column-aware output is identical to the full scan");
+        else plog_error("column-aware output differs from the full scan in {} compounds", mismatching_compounds);
+    }
+
+    void run_noise_kernels(int compound_radius) {
+        Noise noise;
+        const auto positions = compound_positions_in_radius(compound_radius, glm::ivec3(SIZE * 512, 0, -SIZE * 3072));
+        if (!Noise::vectorization_supported()) plog_warn("noise kernels: not used in this build (no avx2 or the startup probe failed), comparing anyway");
+
+        //NOTE: per compound, its height map and the cave grid of every chunk below the surface (like ChunkCompound/Chunk request them)
+        std::vector<int> heights_reference(positions.size() * SIZE * SIZE);
+        std::vector<float> caves_reference(positions.size() * NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC);
+        std::vector<int> heights(SIZE * SIZE);
+        std::vector<float> caves(NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC);
+        int cave_column_heights[SIZE * SIZE];
+        std::size_t num_cave_samples {0}, num_differing_heights {0}, num_differing_caves {0};
+
+        for (bool vectorized : { false, true }) {
+            noise.set_vectorized(vectorized);
+            double height_seconds {0.}, cave_seconds {0.};
+
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                const glm::vec3 position = positions[i];
+                int* height_map = vectorized ? heights.data() : &heights_reference[i * SIZE * SIZE];
+                float* cave_values = vectorized ? caves.data() : &caves_reference[i * NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC];
+                //NOTE: samples above a column's surface are never written, both sides start from the same contents
+                std::fill(cave_values, cave_values + NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC, -1.f);
+
+                auto start = std::chrono::steady_clock::now();
+                noise.fetch_heightmap_grid(position.x, position.z, SIZE, height_map);
+                auto generated = std::chrono::steady_clock::now();
+                for (int chunk {0}; chunk < NUM_CHUNKS_PER_COMPOUND; chunk++) {
+                    for (int column {0}; column < SIZE * SIZE; column++) {
+                        cave_column_heights[column] = std::clamp(height_map[column] - chunk * SIZE + 1, 0, SIZE);
+                        if (!vectorized) num_cave_samples += cave_column_heights[column];
+                    }
+                    noise.fetch_cave_columns(position.x, chunk * SIZE, position.z, SIZE, cave_column_heights, cave_values + chunk * SIZE_CUBIC);
+                }
+                height_seconds += std::chrono::duration<double>(generated - start).count();
+                cave_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - generated).count();
+
+                if (!vectorized) continue;
+                if (std::memcmp(height_map, &heights_reference[i * SIZE * SIZE], SIZE * SIZE * sizeof(int)) != 0) num_differing_heights++;
+                if (std::memcmp(cave_values, &caves_reference[i * NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC], NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC * sizeof(float)) != 0) num_differing_caves++;
+            }
+
+            plog(
+                "noise {:<6} compounds={} height maps {:.1f} Mcolumns/sec, caves {:.1f} Msamples/sec",
+                vectorized ? "avx2" : "scalar",
+                positions.size(),
+                positions.size() * SIZE * SIZE / height_seconds / 1000000.,
+                num_cave_samples / cave_seconds / 1000000.
+            );
+        }
+
+        noise.set_vectorized(Noise::vectorization_supported());
+        if (num_differing_heights == 0 && num_differing_caves == 0) plog("noise kernels: height maps and cave grids are bit-identical to the scalar path");
+        else plog_error("noise kernels: {} height maps and {} cave grids differ from the scalar path", num_differing_heights, num_differing_caves);
+    }
+
+    void run_region_loading(int compound_radius) {
+        Noise noise;
+        const auto positions = compound_positions_in_radius(compound_radius, glm::ivec3(0, 0, -SIZE * 1024));
+        constexpr std::size_t BLOCKS_COUNT = RegionStorage::NUM_BLOCKS_PER_COMPOUND;
+
+        const auto directory = std::filesystem::temp_directory_path() / "voxel-region-benchmark";
+        std::filesystem::remove_all(directory);
+
+        std::vector<uint8_t> blocks_reference(positions.size() * BLOCKS_COUNT);
+        std::vector<uint8_t> blocks(BLOCKS_COUNT);
+        double generate_seconds {0.}, save_seconds {0.}, load_seconds {0.};
+        std::size_t mismatching_compounds {0}, missing_compounds {0};
+
+        {
+            RegionStorage storage(directory);
+
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                auto start = std::chrono::steady_clock::now();
+                ChunkCompound compound(noise, positions[i]);
+                auto generated = std::chrono::steady_clock::now();
+                compound.save(storage);
+                auto saved = std::chrono::steady_clock::now();
+
+                generate_seconds += std::chrono::duration<double>(generated - start).count();
+                save_seconds += std::chrono::duration<double>(saved - generated).count();
+                compound.copy_blocks(&blocks_reference[i * BLOCKS_COUNT]);
+            }
+            ChunkRegistry::get_instance().collect();
+        }
+
+        {
+            //NOTE: fresh storage, the region files are mapped again like after a restart
+            RegionStorage storage(directory);
+
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                auto start = std::chrono::steady_clock::now();
+                auto compound = ChunkCompound::load(storage, positions[i]);
+                load_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                if (!compound) {
+                    missing_compounds++;
+                    continue;
+                }
+                compound->copy_blocks(blocks.data());
+                if (std::memcmp(&blocks_reference[i * BLOCKS_COUNT], blocks.data(), BLOCKS_COUNT) != 0) mismatching_compounds++;
+            }
+            ChunkRegistry::get_instance().collect();
+        }
+
+        auto directory_bytes = [&directory] {
+            std::size_t bytes {0};
+            for (auto& entry : std::filesystem::directory_iterator(directory)) bytes += entry.file_size();
+            return bytes;
+        };
+        const std::size_t bytes_on_disk = directory_bytes();
+
+        //RESAVE: every compound rewritten NUM_RESAVES times, odd passes scatter stone through the top chunks (larger records),
+        //        even passes restore the blocks, the space of replaced records has to be reused
+        constexpr int NUM_RESAVES = 6;
+        std::size_t bytes_peak {bytes_on_disk};
+        {
+            RegionStorage storage(directory);
+            int height_map[SIZE * SIZE];
+            for (int pass {1}; pass <= NUM_RESAVES; pass++) {
+                for (std::size_t i {0}; i < positions.size(); i++) {
+                    if (!storage.load_compound(positions[i], height_map, blocks.data())) {
+                        missing_compounds++;
+                        continue;
+                    }
+                    if (pass % 2 == 1) {
+                        for (std::size_t block {BLOCKS_COUNT / 2}; block < BLOCKS_COUNT; block += 5 + pass) blocks[block] = BlockType::Stone;
+                    } else {
+                        std::memcpy(blocks.data(), &blocks_reference[i * BLOCKS_COUNT], BLOCKS_COUNT);
+                    }
+                    storage.save_compound(positions[i], height_map, blocks.data());
+                }
+                bytes_peak = std::max(bytes_peak, directory_bytes());
+            }
+
+            for (std::size_t i {0}; i < positions.size(); i++) {
+                if (!storage.load_compound(positions[i], height_map, blocks.data())) missing_compounds++;
+                else if (std::memcmp(&blocks_reference[i * BLOCKS_COUNT], blocks.data(), BLOCKS_COUNT) != 0) mismatching_compounds++;
+            }
+        }
+        const std::size_t bytes_resaved = directory_bytes();
+        std::filesystem::remove_all(directory);
+
+        const double num_compounds = static_cast<double>(positions.size());
+        plog(
+            "region storage: compounds={} generate={:.3f} ms save={:.3f} ms load={:.3f} ms per compound ({:.1f}x), {:.1f} KB/compound on disk",
+            positions.size(),
+            generate_seconds * 1000. / num_compounds,
+            save_seconds * 1000. / num_compounds,
+            load_seconds * 1000. / num_compounds,
+            generate_seconds / load_seconds,
+            bytes_on_disk / num_compounds / 1000.
+        );
+
+        plog(
+            "region storage: after {} rewrites of every compound {:.1f} KB/compound on disk (peak {:.1f}, {:.2f}x the first save)",
+            NUM_RESAVES, bytes_resaved / num_compounds / 1000., bytes_peak / num_compounds / 1000., static_cast<double>(bytes_resaved) / bytes_on_disk
+        );
+
+        if (missing_compounds == 0 && mismatching_compounds == 0) plog("loaded compounds are identical to the generated ones");
+        else plog_error("region storage: {} compounds missing, {} differ from the generated ones", missing_compounds, mismatching_compounds);
+    }
+
+    void run_block_edits(int compound_radius, int num_edits) {
+        const glm::ivec3 origin(SIZE * 1024, 0, SIZE * 1024);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& registry = ChunkRegistry::get_instance();
+        //NOTE: edits stay one compound away from the border, every touched chunk has its horizontal neighbours
+        const int extent = std::max(compound_radius - 1, 1) * SIZE;
+        srand(1);
+
+        double incremental_seconds {0.}, incremental_max {0.}, full_seconds {0.}, full_max {0.};
+        std::size_t num_incremental {0}, num_full {0}, mismatching_meshes {0};
+        for (int i {0}; i < num_edits; i++) {
+            const int x = origin.x - extent + rand() % (2 * extent);
+            const int z = origin.z - extent + rand() % (2 * extent);
+
+            //SURFACE: topmost solid block of the column
+            int y = NUM_CHUNKS_PER_COMPOUND * SIZE - 1;
+            uint8_t block = BlockType::Air;
+            {
+                ChunkRegistry::Guard guard;
+                for (; y >= 0 && block == BlockType::Air; y--) {
+                    const glm::ivec3 chunk_position((x / SIZE) * SIZE, (y / SIZE) * SIZE, (z / SIZE) * SIZE);
+                    Chunk* chunk = registry.find(chunk_position);
+                    if (!chunk) continue;
+                    const glm::ivec3 local = glm::ivec3(x, y, z) - chunk_position;
+                    block = chunk->blocks.get(local.x + (local.y * SIZE) + (local.z * SIZE * SIZE));
+                }
+                y++;
+            }
+            if (block == BlockType::Air) continue;
+
+            //BREAK + PLACE: both go through the incremental path
+            for (uint8_t edit : { static_cast<uint8_t>(BlockType::Air), block }) {
+                auto start = std::chrono::steady_clock::now();
+                Chunk::set_block_world(x, y, z, edit);
+                const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                incremental_seconds += seconds;
+                incremental_max = std::max(incremental_max, seconds);
+                num_incremental++;
+            }
+
+            //NOTE: the full rebuild doubles as the check, both have to produce the same quads
+            ChunkRegistry::Guard guard;
+            Chunk* chunk = registry.find(glm::ivec3((x / SIZE) * SIZE, (y / SIZE) * SIZE, (z / SIZE) * SIZE));
+            if (!chunk || !chunk->mesh) continue;
+            const std::vector<ChunkMesh::PackedQuad> quads = chunk->mesh->quads;
+
+            auto start = std::chrono::steady_clock::now();
+            chunk->remesh(true);
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            full_seconds += seconds;
+            full_max = std::max(full_max, seconds);
+            num_full++;
+
+            if (quads != chunk->mesh->quads) mismatching_meshes++;
+        }
+
+        plog(
+            "block edits: edits={} incremental mean={:.3f} ms max={:.3f} ms, full chunk rebuild mean={:.3f} ms max={:.3f} ms",
+            num_incremental,
+            num_incremental ? incremental_seconds * 1000. / num_incremental : 0.,
+            incremental_max * 1000.,
+            num_full ? full_seconds * 1000. / num_full : 0.,
+            full_max * 1000.
+        );
+        if (mismatching_meshes == 0) plog("incremental meshes are identical to full rebuilds");
+        else plog_error("block edits: {} incremental meshes differ from a full rebuild", mismatching_meshes);
+    }
+
+    struct StageTimings {
+        std::vector<double> samples;
+        double total_seconds {0.};
+
+        void add(double seconds) {
+            samples.push_back(seconds);
+            total_seconds += seconds;
+        }
+
+        double percentile_ms(double percentile) {
+            if (samples.empty()) return 0.;
+            std::sort(samples.begin(), samples.end());
+            const std::size_t index = std::min(samples.size() - 1, static_cast<std::size_t>(percentile * samples.size()));
+            return samples[index] * 1000.;
+        }
+    };
+
+    void run_pipeline(int world_size, unsigned int seed, const std::string& json_path) {
+        Noise noise;
+        //NOTE: noise is always seeded the same, the seed drives trees and diamonds (GenerationRandom)
+        const uint64_t previous_seed = ChunkCompound::seed;
+        ChunkCompound::seed = seed;
+
+        //NOTE: the outer ring is only generated, its chunks miss horizontal neighbours and can't be meshed
+        const glm::ivec3 origin(-SIZE * 2048, 0, SIZE * 2048);
+        std::vector<std::unique_ptr<ChunkCompound>> compounds;
+        StageTimings generation, meshing;
+        for (int x {-1}; x <= world_size; x++) {
+            for (int z {-1}; z <= world_size; z++) {
+                auto start = std::chrono::steady_clock::now();
+                compounds.push_back(std::make_unique<ChunkCompound>(noise, glm::vec3(origin.x + x * SIZE, 0, origin.z + z * SIZE)));
+                generation.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+        }
+
+        auto& registry = ChunkRegistry::get_instance();
+        std::size_t num_chunks {0}, num_meshed_chunks {0}, num_quads {0}, gpu_bytes {0}, cpu_bytes {0};
+        {
+            ChunkRegistry::Guard guard;
+            for (int x {0}; x < world_size; x++) {
+                for (int z {0}; z < world_size; z++) {
+                    for (int y {0}; y < NUM_CHUNKS_PER_COMPOUND; y++) {
+                        Chunk* chunk = registry.find(glm::ivec3(origin.x + x * SIZE, y * SIZE, origin.z + z * SIZE));
+                        if (!chunk) continue;
+                        num_chunks++;
+                        if (chunk->is_empty) continue;
+
+                        auto start = std::chrono::steady_clock::now();
+                        chunk->build_mesh();
+                        meshing.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+                        if (!chunk->mesh) continue;
+
+                        //NOTE: gpu = packed quads + block ssbo of the slot
+                        num_meshed_chunks++;
+                        num_quads += chunk->mesh->quads.size();
+                        gpu_bytes += chunk->mesh->quads.size() * sizeof(ChunkMesh::PackedQuad) + (SIZE_CUBIC / NUM_VALUES_IN_ONE_UINT) * sizeof(unsigned int);
+                        cpu_bytes += chunk->estimate_memory_usage();
+                    }
+                }
+            }
+        }
+
+        const double generated_voxels = static_cast<double>(compounds.size()) * NUM_CHUNKS_PER_COMPOUND * SIZE_CUBIC;
+        const double meshed_voxels = static_cast<double>(num_chunks) * SIZE_CUBIC;
+        const double generation_ns_per_voxel = generation.total_seconds * 1e9 / generated_voxels;
+        const double meshing_ns_per_voxel = num_chunks ? meshing.total_seconds * 1e9 / meshed_voxels : 0.;
+        const double meshed = static_cast<double>(std::max<std::size_t>(num_meshed_chunks, 1));
+        const double quads_per_chunk = num_quads / meshed;
+        const double gpu_bytes_per_chunk = gpu_bytes / meshed;
+        const double cpu_bytes_per_chunk = cpu_bytes / meshed;
+
+        const double generation_p50 = generation.percentile_ms(.5), generation_p99 = generation.percentile_ms(.99);
+        const double meshing_p50 = meshing.percentile_ms(.5), meshing_p99 = meshing.percentile_ms(.99);
+
+        plog("pipeline: world={}x{} seed={} compounds={} chunks={} meshed={}", world_size, world_size, seed, compounds.size(), num_chunks, num_meshed_chunks);
+        plog("  generation: {:.2f} ns/voxel, per compound p50={:.3f} ms p99={:.3f} ms", generation_ns_per_voxel, generation_p50, generation_p99);
+        plog("  meshing   : {:.2f} ns/voxel, per chunk p50={:.3f} ms p99={:.3f} ms", meshing_ns_per_voxel, meshing_p50, meshing_p99);
+        plog("  {:.1f} quads/chunk, {:.1f} KB gpu/chunk, {:.1f} KB cpu/chunk", quads_per_chunk, gpu_bytes_per_chunk / 1000., cpu_bytes_per_chunk / 1000.);
+
+        if (!json_path.empty()) {
+            std::ofstream file(json_path);
+            std::print(
+                file,
+                "{{\n"
+                "  \"benchmark\": \"pipeline\",\n"
+                "  \"world_size\": {},\n"
+                "  \"seed\": {},\n"
+                "  \"chunk_size\": {},\n"
+                "  \"compounds\": {},\n"
+                "  \"chunks\": {},\n"
+                "  \"meshed_chunks\": {},\n"
+                "  \"quads_per_chunk\": {:.3f},\n"
+                "  \"gpu_bytes_per_chunk\": {:.1f},\n"
+                "  \"cpu_bytes_per_chunk\": {:.1f},\n"
+                "  \"stages\": {{\n"
+                "    \"generation\": {{ \"ns_per_voxel\": {:.3f}, \"p50_ms\": {:.4f}, \"p99_ms\": {:.4f}, \"samples\": {} }},\n"
+                "    \"meshing\": {{ \"ns_per_voxel\": {:.3f}, \"p50_ms\": {:.4f}, \"p99_ms\": {:.4f}, \"samples\": {} }}\n"
+                "  }}\n"
+                "}}\n",
+                world_size, seed, SIZE, compounds.size(), num_chunks, num_meshed_chunks,
+                quads_per_chunk, gpu_bytes_per_chunk, cpu_bytes_per_chunk,
+                generation_ns_per_voxel, generation_p50, generation_p99, generation.samples.size(),
+                meshing_ns_per_voxel, meshing_p50, meshing_p99, meshing.samples.size()
+            );
+            if (!file) plog_error("failed to write benchmark results to {}", json_path);
+        }
+
+        for (auto& compound : compounds) {
+            compound->unload();
+        }
+        compounds.clear();
+        registry.collect();
+        ChunkCompound::seed = previous_seed;
+    }
+
+    void run_arena_allocator(int num_operations) {
+        //NOTE: starts small on purpose, the arena has to grow like the quad arena does in game
+        TlsfAllocator allocator(1 << 16);
+        std::mt19937 rng(1);
+        //NOTE: quads of a chunk mesh, mostly a few hundred with a tail of dense chunks
+        std::lognormal_distribution<double> quad_count(5.6, 1.);
+
+        std::vector<TlsfAllocator::Allocation> live;
+        double allocate_seconds {0.}, free_seconds {0.};
+        std::size_t num_allocations {0}, num_frees {0}, num_grows {0};
+
+        for (int i {0}; i < num_operations; i++) {
+            //NOTE: slightly more allocations than frees until the working set is ~4096 chunks
+            const bool should_allocate = live.empty() || (rng() % 100) < (live.size() < 4096 ? 60u : 50u);
+            if (should_allocate) {
+                const uint32_t count = static_cast<uint32_t>(std::clamp(quad_count(rng), 1., 16384.));
+
+                auto start = std::chrono::steady_clock::now();
+                auto allocation = allocator.allocate(count);
+                if (!allocation.is_valid()) {
+                    allocator.grow(std::max(allocator.get_capacity() * 2, allocator.get_capacity() + count + count / 16 + 1));
+                    allocation = allocator.allocate(count);
+                    num_grows++;
+                }
+                allocate_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                num_allocations++;
+                live.push_back(allocation);
+            }
+            else {
+                const std::size_t index = rng() % live.size();
+                auto start = std::chrono::steady_clock::now();
+                allocator.free(live[index]);
+                free_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                num_frees++;
+                live[index] = live.back();
+                live.pop_back();
+            }
+        }
+
+        //VALIDATION: live ranges are inside the arena and never overlap
+        std::size_t num_invalid {0};
+        std::sort(live.begin(), live.end(), [](const auto& a, const auto& b) { return a.offset < b.offset; });
+        uint64_t end {0};
+        for (const auto& allocation : live) {
+            if (!allocation.is_valid() || allocation.offset < end) num_invalid++;
+            end = static_cast<uint64_t>(allocation.offset) + allocation.size;
+        }
+        if (end > allocator.get_capacity()) num_invalid++;
+
+        //NOTE: the running counters of get_stats() against the live ranges
+        const auto stats = allocator.get_stats();
+        uint64_t live_units {0};
+        for (const auto& allocation : live) live_units += allocation.size;
+        if (stats.used != live_units || stats.num_allocations != live.size() || stats.largest_free_block > stats.free) num_invalid++;
+        plog(
+            "arena allocator: ops={} allocate={:.1f} ns free={:.1f} ns grows={} live={} used={:.1f}% fragmentation={:.1f}% free blocks={}",
+            num_operations,
+            num_allocations ? allocate_seconds * 1e9 / num_allocations : 0.,
+            num_frees ? free_seconds * 1e9 / num_frees : 0.,
+            num_grows,
+            stats.num_allocations,
+            stats.capacity ? 100. * stats.used / stats.capacity : 0.,
+            stats.fragmentation() * 100.,
+            stats.num_free_blocks
+        );
+        if (num_invalid == 0) plog("arena allocator ranges are disjoint");
+        else plog_error("arena allocator: {} overlapping or out of range allocations", num_invalid);
+    }
+
+    void run_draw_commands(int compound_radius, int num_frames) {
+        const glm::ivec3 origin(SIZE * 3072, 0, -SIZE * 3072);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+
+        //ARENA-RANGES: same bookkeeping as the renderer, chunk.slot indexes them (allocated stays false, nothing to release)
+        struct Ranges {
+            TlsfAllocator::Allocation quads, blocks;
+            uint32_t num_quads {0};
+            glm::ivec3 position {0};
+        };
+        TlsfAllocator quad_allocator(1 << 18), block_allocator(512);
+        std::vector<Ranges> ranges;
+
+        auto allocate = [](TlsfAllocator& allocator, uint32_t count) {
+            auto allocation = allocator.allocate(count);
+            if (!allocation.is_valid()) {
+                allocator.grow(std::max(allocator.get_capacity() * 2, allocator.get_capacity() + count + count / 16 + 1));
+                allocation = allocator.allocate(count);
+            }
+            return allocation;
+        };
+        for (auto& compound : compounds) {
+            compound->visit_chunks([&](Chunk& chunk) {
+                if (!chunk.built || !chunk.mesh || chunk.mesh->quads.empty()) return;
+                chunk.slot = static_cast<unsigned int>(ranges.size());
+                ranges.push_back(Ranges {
+                    allocate(quad_allocator, static_cast<uint32_t>(chunk.mesh->quads.size())),
+                    allocate(block_allocator, 1),
+                    static_cast<uint32_t>(chunk.mesh->quads.size()),
+                    glm::ivec3(chunk.position)
+                });
+            });
+        }
+
+        //NOTE: the camera circles the world center at player height, one full turn over all frames
+        const glm::mat4 projection = glm::perspective(glm::radians(90.f), 16.f / 9.f, .1f, 1000.f);
+        const glm::vec3 eye = glm::vec3(origin) + glm::vec3(0.f, 80.f, 0.f);
+        const uint32_t block_unit = SIZE_CUBIC / NUM_VALUES_IN_ONE_UINT;
+
+        ChunkDrawList draw_list;
+        //NOTE: slot of every emitted command, filled outside the timed part
+        std::vector<unsigned int> drawn_slots;
+        StageTimings frames;
+        std::size_t num_draws {0}, num_mismatching {0};
+        for (int frame {0}; frame < num_frames; frame++) {
+            const float angle = glm::radians(360.f) * frame / num_frames;
+            const glm::mat4 view = glm::lookAt(eye, eye + glm::vec3(std::cos(angle), -.3f, std::sin(angle)), glm::vec3(0.f, 1.f, 0.f));
+            Plane frustum[6];
+            get_frustum(frustum, projection, view);
+
+            auto start = std::chrono::steady_clock::now();
+            draw_list.clear();
+            //NOTE: cpu version of the culling compute shader (the per-frame cpu work before it moved to the gpu)
+            for (auto& compound : compounds) {
+                if (!is_box_in_frustum(frustum, compound->position, compound->position + glm::vec3(SIZE, SIZE * NUM_CHUNKS_PER_COMPOUND, SIZE)))
+                    continue;
+
+                compound->visit_visible_chunks(frustum, [&](Chunk& chunk) {
+                    if (!chunk.built || !chunk.mesh || chunk.mesh->quads.empty()) return;
+
+                    const auto& range = ranges[chunk.slot];
+                    draw_list.add(range.num_quads * 6, range.quads.offset * 6, glm::ivec3(chunk.position), range.blocks.offset * block_unit);
+                });
+            }
+            frames.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            num_draws += draw_list.size();
+
+            drawn_slots.clear();
+            for (auto& compound : compounds) {
+                if (!is_box_in_frustum(frustum, compound->position, compound->position + glm::vec3(SIZE, SIZE * NUM_CHUNKS_PER_COMPOUND, SIZE)))
+                    continue;
+                compound->visit_visible_chunks(frustum, [&](Chunk& chunk) {
+                    if (chunk.built && chunk.mesh && !chunk.mesh->quads.empty()) drawn_slots.push_back(chunk.slot);
+                });
+            }
+
+            //VALIDATION: every command covers exactly its chunk's ranges and points at its draw data (base_instance = gl_DrawID)
+            if (drawn_slots.size() != draw_list.size()) num_mismatching++;
+            for (std::size_t i {0}; i < std::min(draw_list.size(), drawn_slots.size()); i++) {
+                const auto& command = draw_list.commands[i];
+                const auto& draw = draw_list.draws[i];
+                const auto& range = ranges[drawn_slots[i]];
+                const bool matching = command.instance_count == 1 && command.base_instance == i
+                    && command.first == range.quads.offset * 6 && command.count == range.num_quads * 6
+                    && range.quads.size >= range.num_quads
+                    && draw.position == range.position && draw.block_offset == range.blocks.offset * block_unit;
+                if (!matching) num_mismatching++;
+            }
+        }
+
+        const double mean_seconds = num_frames > 0 ? frames.total_seconds / num_frames : 0.;
+        plog(
+            "draw commands: frames={} meshed chunks={} draws/frame={:.1f} build mean={:.3f} ms p50={:.3f} ms p99={:.3f} ms ({:.1f} ns/draw) {:.1f} KB uploaded/frame",
+            num_frames,
+            ranges.size(),
+            num_frames > 0 ? static_cast<double>(num_draws) / num_frames : 0.,
+            mean_seconds * 1000.,
+            frames.percentile_ms(.5),
+            frames.percentile_ms(.99),
+            num_draws ? frames.total_seconds * 1e9 / num_draws : 0.,
+            num_frames > 0 ? static_cast<double>(num_draws) / num_frames * (sizeof(DrawArraysIndirectCommand) + sizeof(ChunkDrawData)) / 1000. : 0.
+        );
+        if (num_mismatching == 0) plog("draw commands match the chunk ranges");
+        else plog_error("draw commands: {} commands don't match their chunk", num_mismatching);
+    }
+
+    static uint64_t face_connectivity_per_voxel(const ChunkRow* voxels) {
+        //NOTE: reference for ChunkVisibility::compute_face_connectivity, one voxel at a time flood fill
+        auto is_air = [voxels](int x, int y, int z) { return !voxels || !((voxels[z + y * SIZE] >> x) & 1); };
+        std::vector<int> component(SIZE_CUBIC, -1);
+        uint64_t connectivity {0};
+        int num_components {0};
+        for (int start {0}; start < SIZE_CUBIC; start++) {
+            const int sx = start % SIZE, sy = (start / SIZE) % SIZE, sz = start / (SIZE * SIZE);
+            if (component[start] >= 0 || !is_air(sx, sy, sz)) continue;
+
+            uint8_t faces {0};
+            std::vector<int> stack { start };
+            component[start] = num_components;
+            while (!stack.empty()) {
+                const int index = stack.back();
+                stack.pop_back();
+                const int x = index % SIZE, y = (index / SIZE) % SIZE, z = index / (SIZE * SIZE);
+                if (x == 0) faces |= 1 << NeighbourLeft;
+                if (x == SIZE - 1) faces |= 1 << NeighbourRight;
+                if (z == 0) faces |= 1 << NeighbourFront;
+                if (z == SIZE - 1) faces |= 1 << NeighbourBack;
+                if (y == 0) faces |= 1 << NeighbourBottom;
+                if (y == SIZE - 1) faces |= 1 << NeighbourTop;
+
+                for (const auto& offset : ChunkRegistry::NEIGHBOUR_OFFSETS) {
+                    const int nx = x + offset[0], ny = y + offset[1], nz = z + offset[2];
+                    if (nx < 0 || ny < 0 || nz < 0 || nx >= SIZE || ny >= SIZE || nz >= SIZE) continue;
+                    const int neighbour = nx + ny * SIZE + nz * SIZE * SIZE;
+                    if (component[neighbour] >= 0 || !is_air(nx, ny, nz)) continue;
+                    component[neighbour] = num_components;
+                    stack.push_back(neighbour);
+                }
+            }
+            num_components++;
+
+            for (int a {0}; a < NumNeighbours; a++) {
+                for (int b {0}; b < NumNeighbours; b++) {
+                    if ((faces & (1 << a)) && (faces & (1 << b))) connectivity |= 1ull << (a * NumNeighbours + b);
+                }
+            }
+        }
+        return connectivity;
+    }
+
+    void run_cave_culling(int compound_radius) {
+        const glm::ivec3 origin(-SIZE * 3072, 0, -SIZE * 3072);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+
+        //CONNECTIVITY: row parallel fill vs the per-voxel reference on every non-empty chunk
+        double connectivity_seconds {0.};
+        std::size_t num_chunks {0}, num_drawable {0}, num_mismatching {0};
+        for (auto& compound : compounds) {
+            compound->visit_chunks([&](Chunk& chunk) {
+                auto start = std::chrono::steady_clock::now();
+                const uint64_t connectivity = ChunkVisibility::compute_face_connectivity(chunk.voxels.get());
+                connectivity_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                num_chunks++;
+                if (chunk.built && chunk.mesh && !chunk.mesh->quads.empty()) num_drawable++;
+                if (connectivity != face_connectivity_per_voxel(chunk.voxels.get())) num_mismatching++;
+            });
+        }
+
+        plog(
+            "cave culling: connectivity {:.2f} us/chunk over {} non-empty chunks",
+            num_chunks ? connectivity_seconds * 1e6 / num_chunks : 0.,
+            num_chunks
+        );
+        if (num_mismatching == 0) plog("face connectivity matches the per-voxel flood fill");
+        else plog_error("cave culling: {} chunks differ from the per-voxel flood fill", num_mismatching);
+
+        //SEARCH: from the sky above the center, from the surface and from deep underground
+        auto& registry = ChunkRegistry::get_instance();
+        const int max_distance = std::max(compound_radius, 2) * SIZE;
+        for (const int camera_y : { NUM_CHUNKS_PER_COMPOUND * SIZE - 8, 72, 8 }) {
+            ChunkRegistry::Guard guard;
+            Chunk* start = registry.find(glm::ivec3(origin.x, (camera_y / SIZE) * SIZE, origin.z));
+            if (!start) continue;
+
+            std::size_t num_reached {0};
+            auto begin = std::chrono::steady_clock::now();
+            ChunkVisibility::find_visible_chunks(start, max_distance, [&num_reached](Chunk& chunk) {
+                if (chunk.built && chunk.mesh && !chunk.mesh->quads.empty()) num_reached++;
+            });
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+            plog(
+                "  camera y={}: {} of {} drawable chunks reached, {:.1f}% culled, search {:.3f} ms",
+                camera_y, num_reached, num_drawable,
+                num_drawable ? 100. * (num_drawable - num_reached) / num_drawable : 0.,
+                seconds * 1000.
+            );
+        }
+    }
+
+    //NOTE: the meshed chunks with their neighbour rows, exactly what the mesher sees
+    struct MeshInput {
+        const ChunkRow* voxels;
+        std::array<ChunkRow*, NumNeighbours> neighbours;
+    };
+
+    //NOTE: the rows stay owned by the compounds, only the neighbour links need the guard
+    static std::vector<MeshInput> collect_mesh_inputs(std::vector<std::unique_ptr<ChunkCompound>>& compounds) {
+        std::vector<MeshInput> inputs;
+        ChunkRegistry::Guard guard;
+        for (auto& compound : compounds) {
+            compound->visit_chunks([&inputs](Chunk& chunk) {
+                if (!chunk.built || !chunk.voxels) return;
+                MeshInput input { chunk.voxels.get(), {} };
+                for (int i {0}; i < NumNeighbours; i++) {
+                    Chunk* neighbour = chunk.neighbour_chunks[i].load();
+                    input.neighbours[i] = neighbour ? neighbour->voxels.get() : nullptr;
+                }
+                inputs.push_back(input);
+            });
+        }
+        return inputs;
+    }
+
+    void run_face_culling(int compound_radius) {
+        const glm::ivec3 origin(SIZE * 2048, 0, -SIZE * 2048);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+
+        const auto inputs = collect_mesh_inputs(compounds);
+
+        const uint64_t all_slices[ChunkMesh::NUM_FACE_DIRECTIONS] { ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull };
+
+        //CHECK: bit-exact against the scatter, for full builds and for random dirty slices (block edits)
+        std::size_t num_mismatching {0};
+        std::mt19937_64 random(1);
+        for (auto& input : inputs) {
+            uint64_t edit_slices[ChunkMesh::NUM_FACE_DIRECTIONS];
+            for (auto& slices : edit_slices) slices = random();
+
+            for (const uint64_t* dirty_slices : { all_slices, static_cast<const uint64_t*>(edit_slices) }) {
+                ChunkMesh::FaceRows culled, scattered;
+                ChunkMesh::cull_faces(input.voxels, input.neighbours.data(), dirty_slices, culled);
+                ChunkMesh::cull_faces_scatter(input.voxels, input.neighbours.data(), dirty_slices, scattered);
+                if (std::memcmp(culled, scattered, sizeof(ChunkMesh::FaceRows)) != 0) num_mismatching++;
+            }
+        }
+
+        //KERNELS: every chunk a few times, the rows are checksummed so the work can't be dropped
+        const int num_passes = 16;
+        uint64_t checksum {0};
+        auto time_kernel = [&](auto&& kernel) {
+            auto start = std::chrono::steady_clock::now();
+            for (int pass {0}; pass < num_passes; pass++) {
+                for (auto& input : inputs) {
+                    ChunkMesh::FaceRows faces;
+                    kernel(input.voxels, input.neighbours.data(), all_slices, faces);
+                    checksum += faces[pass % ChunkMesh::NUM_FACE_DIRECTIONS][input.voxels[0] % (SIZE * SIZE)];
+                }
+            }
+            return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        };
+        const double row_seconds = time_kernel(ChunkMesh::cull_faces);
+        const double scatter_seconds = time_kernel(ChunkMesh::cull_faces_scatter);
+
+        //MESHING: whole constructor (culling, greedy meshing)
+        auto start = std::chrono::steady_clock::now();
+        for (auto& input : inputs) {
+            ChunkMesh mesh(input.voxels, input.neighbours.data());
+            checksum += mesh.quads.size();
+        }
+        const double mesh_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double num_culled = static_cast<double>(inputs.size()) * num_passes;
+        plog(
+            "face culling: chunks={} row-parallel {:.2f} us/chunk ({:.0f} chunks/sec), scatter {:.2f} us/chunk ({:.0f} chunks/sec), {:.1f}x",
+            inputs.size(),
+            num_culled > 0 ? row_seconds * 1e6 / num_culled : 0.,
+            row_seconds > 0. ? num_culled / row_seconds : 0.,
+            num_culled > 0 ? scatter_seconds * 1e6 / num_culled : 0.,
+            scatter_seconds > 0. ? num_culled / scatter_seconds : 0.,
+            row_seconds > 0. ? scatter_seconds / row_seconds : 0.
+        );
+        plog(
+            "  full mesh: {:.0f} chunks meshed/sec ({:.2f} us/chunk), checksum {}",
+            mesh_seconds > 0. ? inputs.size() / mesh_seconds : 0.,
+            inputs.empty() ? 0. : mesh_seconds * 1e6 / inputs.size(),
+            checksum
+        );
+        if (num_mismatching == 0) plog("row-parallel face rows are identical to the per-bit scatter");
+        else plog_error("face culling: {} chunks differ from the per-bit scatter", num_mismatching);
+    }
+
+    //NOTE: dense blocks of a world_width x WORLD_HEIGHT x world_width box, index x + (z + y * world_width) * world_width
+    struct ChunkSizeResult {
+        std::size_t num_chunks {0}, num_drawable {0}, num_quads {0}, gpu_bytes {0};
+        double seconds {0.};
+    };
+
+    template <typename Row>
+    static ChunkSizeResult mesh_with_chunk_size(const std::vector<uint8_t>& world, int world_width) {
+        using SizedMesh = QuadMesh<Row>;
+        constexpr int N = static_cast<int>(SizedMesh::ROW_SIZE);
+        const int chunks_x = world_width / N, chunks_y = WORLD_HEIGHT / N;
+        auto chunk_index = [chunks_x](int x, int y, int z) { return x + (z + y * chunks_x) * chunks_x; };
+
+        //OCCUPANCY: the same three row orientations Chunk::set_voxel writes, chunks without a solid block stay empty
+        std::vector<std::vector<Row>> rows(chunks_x * chunks_x * chunks_y);
+        for (int y {0}; y < WORLD_HEIGHT; y++) {
+            for (int z {0}; z < world_width; z++) {
+                for (int x {0}; x < world_width; x++) {
+                    if (world[x + (z + y * world_width) * world_width] == BlockType::Air) continue;
+
+                    auto& chunk = rows[chunk_index(x / N, y / N, z / N)];
+                    if (chunk.empty()) chunk.resize(N * N * 3);
+                    const int lx = x % N, ly = y % N, lz = z % N;
+                    chunk[lz + (ly * N)] |= Row {1} << lx;
+                    chunk[lx + (ly * N) + (N * N)] |= Row {1} << lz;
+                    chunk[lx + (lz * N) + (N * N * 2)] |= Row {1} << ly;
+                }
+            }
+        }
+
+        ChunkSizeResult result;
+        result.num_chunks = rows.size();
+        for (int cy {0}; cy < chunks_y; cy++) {
+            for (int cz {0}; cz < chunks_x; cz++) {
+                for (int cx {0}; cx < chunks_x; cx++) {
+                    auto& chunk = rows[chunk_index(cx, cy, cz)];
+                    if (chunk.empty()) continue;
+
+                    //NOTE: ChunkNeighbour order, the box border has no neighbours (air) for every size alike
+                    auto neighbour = [&](int x, int y, int z) -> Row* {
+                        if (x < 0 || y < 0 || z < 0 || x >= chunks_x || y >= chunks_y || z >= chunks_x) return nullptr;
+                        auto& rows_neighbour = rows[chunk_index(x, y, z)];
+                        return rows_neighbour.empty() ? nullptr : rows_neighbour.data();
+                    };
+                    Row* neighbours[NumNeighbours] {
+                        neighbour(cx - 1, cy, cz), neighbour(cx + 1, cy, cz),
+                        neighbour(cx, cy, cz - 1), neighbour(cx, cy, cz + 1),
+                        neighbour(cx, cy - 1, cz), neighbour(cx, cy + 1, cz)
+                    };
+
+                    auto start = std::chrono::steady_clock::now();
+                    SizedMesh mesh(chunk.data(), neighbours);
+                    result.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                    if (mesh.quads.empty()) continue;
+                    result.num_drawable++;
+                    result.num_quads += mesh.quads.size();
+                    result.gpu_bytes += mesh.quads.size() * sizeof(typename SizedMesh::PackedQuad) + (N * N * N / NUM_VALUES_IN_ONE_UINT) * sizeof(unsigned int);
+                }
+            }
+        }
+        return result;
+    }
+
+    void run_chunk_sizes(int world_width) {
+        //NOTE: multiple of the largest chunk size, so every size tiles the same box
+        world_width = std::max(64, (world_width / 64) * 64);
+
+        //WORLD: generated with the chunk size of this build, then re-tiled into 16/32/64 chunks
+        Noise noise;
+        const glm::ivec3 origin(SIZE * 4096, 0, SIZE * 4096);
+        std::vector<uint8_t> world(static_cast<std::size_t>(world_width) * WORLD_HEIGHT * world_width);
+        std::vector<uint8_t> compound_blocks(RegionStorage::NUM_BLOCKS_PER_COMPOUND);
+        for (int compound_z {0}; compound_z < world_width / SIZE; compound_z++) {
+            for (int compound_x {0}; compound_x < world_width / SIZE; compound_x++) {
+                ChunkCompound compound(noise, glm::vec3(origin.x + compound_x * SIZE, 0, origin.z + compound_z * SIZE));
+                compound.copy_blocks(compound_blocks.data());
+
+                for (int y {0}; y < WORLD_HEIGHT; y++) {
+                    for (int z {0}; z < SIZE; z++) {
+                        for (int x {0}; x < SIZE; x++) {
+                            //NOTE: copy_blocks is chunk after chunk, x + y * SIZE + z * SIZE * SIZE within a chunk
+                            const uint8_t block = compound_blocks[(y / SIZE) * SIZE_CUBIC + x + ((y % SIZE) * SIZE) + (z * SIZE * SIZE)];
+                            world[(compound_x * SIZE + x) + ((compound_z * SIZE + z) + y * world_width) * world_width] = block;
+                        }
+                    }
+                }
+            }
+        }
+        ChunkRegistry::get_instance().collect();
+
+        const double num_voxels = static_cast<double>(world.size());
+        plog("chunk sizes: {}x{}x{} blocks, built with SIZE={}", world_width, WORLD_HEIGHT, world_width, SIZE);
+        auto report = [num_voxels](int size, const ChunkSizeResult& result) {
+            plog(
+                "  {:>2}^3: chunks={} drawable={} (draws + jolt bodies) quads={} meshing {:.1f} ms ({:.2f} ns/voxel, {:.1f} Mvoxels/sec), {:.1f} MB gpu",
+                size, result.num_chunks, result.num_drawable, result.num_quads,
+                result.seconds * 1000., result.seconds * 1e9 / num_voxels,
+                result.seconds > 0. ? num_voxels / result.seconds / 1000000. : 0.,
+                result.gpu_bytes / 1000000.
+            );
+        };
+        report(16, mesh_with_chunk_size<uint16_t>(world, world_width));
+        report(32, mesh_with_chunk_size<uint32_t>(world, world_width));
+        report(64, mesh_with_chunk_size<uint64_t>(world, world_width));
+    }
+
+    void run_mesh_allocations(int compound_radius) {
+        install_jolt_allocation_hooks();
+
+        const glm::ivec3 origin(-SIZE * 2048, 0, SIZE * 2048);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+        const auto inputs = collect_mesh_inputs(compounds);
+
+        struct AllocationSummary {
+            std::size_t total {0};
+            std::size_t max {0};
+            std::size_t bytes {0};
+
+            void add(const AllocationStats& stats) {
+                total += stats.num_allocations;
+                max = std::max(max, stats.num_allocations);
+                bytes += stats.num_bytes;
+            }
+        };
+
+        //NOTE: building the compounds already grew this thread's arena, like a worker that meshed a few chunks
+        std::vector<std::unique_ptr<ChunkMesh>> meshes(inputs.size());
+        AllocationSummary builds, edits;
+        std::size_t num_quads {0};
+        for (std::size_t i {0}; i < inputs.size(); i++) {
+            reset_allocation_stats();
+            meshes[i] = std::make_unique<ChunkMesh>(inputs[i].voxels, inputs[i].neighbours.data());
+            builds.add(get_allocation_stats());
+            num_quads += meshes[i]->quads.size();
+        }
+
+        //EDITS: one dirty slice per direction, like a block edit in the middle of the chunk
+        const uint64_t edit_slices[ChunkMesh::NUM_FACE_DIRECTIONS] {
+            1ull << (SIZE / 2), 1ull << (SIZE / 2 + 1), 1ull << (SIZE / 2), 1ull << (SIZE / 2 - 1), 1ull << (SIZE / 2), 1ull << (SIZE / 2 - 1)
+        };
+        for (std::size_t i {0}; i < inputs.size(); i++) {
+            reset_allocation_stats();
+            meshes[i]->remesh(inputs[i].voxels, inputs[i].neighbours.data(), edit_slices);
+            edits.add(get_allocation_stats());
+        }
+
+        const double num_meshed = static_cast<double>(std::max<std::size_t>(inputs.size(), 1));
+        plog(
+            "mesh allocations: chunks={} quads/chunk={:.1f} arena={} KB (operator new + jolt, the persistent mesh included)",
+            inputs.size(), num_quads / num_meshed, ChunkMesh::scratch_arena().get_capacity() / 1000
+        );
+        auto report = [num_meshed](const char* name, const AllocationSummary& summary) {
+            plog(
+                "  {}: {:.1f} allocations/chunk (max {}), {:.1f} KB/chunk",
+                name, summary.total / num_meshed, summary.max, summary.bytes / num_meshed / 1000.
+            );
+        };
+        report("build", builds);
+        report("remesh (one slice per direction)", edits);
+    }
+
+    void run_quad_packing(int compound_radius) {
+        using Quad = ChunkMesh::Quad;
+        constexpr int R = static_cast<int>(ChunkMesh::ROW_SIZE);
+
+        //ROUND-TRIP: every field at random within its range (positions 0 to SIZE, sizes 1 to SIZE)
+        std::size_t num_mismatching_packs {0};
+        std::mt19937 random(1);
+        auto field = [&random](int min, int max) { return static_cast<uint8_t>(min + static_cast<int>(random() % (max - min + 1))); };
+        for (int i {0}; i < 1000000; i++) {
+            const Quad quad { field(0, R), field(0, R), field(0, R), field(0, 5), field(1, R), field(1, R) };
+            if (ChunkMesh::unpack_quad(ChunkMesh::pack_quad(quad)) != quad) num_mismatching_packs++;
+        }
+
+        const glm::ivec3 origin(SIZE * 1024, 0, SIZE * 1024);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+        const auto inputs = collect_mesh_inputs(compounds);
+
+        //COVERAGE: the decoded quads of a chunk cover exactly the culled faces (no gaps, no overlaps), both triangles of
+        //          every quad face along its normal (the winding the vertex shader uses)
+        const uint64_t all_slices[ChunkMesh::NUM_FACE_DIRECTIONS] { ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull };
+        std::size_t num_quads {0}, num_mismatching_chunks {0}, num_wrong_windings {0};
+        for (auto& input : inputs) {
+            ChunkMesh mesh(input.voxels, input.neighbours.data());
+            num_quads += mesh.quads.size();
+
+            ChunkMesh::FaceRows culled, covered {};
+            ChunkMesh::cull_faces(input.voxels, input.neighbours.data(), all_slices, culled);
+            bool matching = true;
+
+            for (const auto packed : mesh.quads) {
+                const Quad quad = ChunkMesh::unpack_quad(packed);
+                if (ChunkMesh::pack_quad(quad) != packed) matching = false;
+
+                //NOTE: face row layout of cull_faces, the positive directions sit one voxel further along their normal
+                const int k = quad.direction;
+                const int plus = (k % 2 == 0) ? 1 : 0;
+                for (int b {0}; b < quad.size_b; b++) {
+                    std::size_t row;
+                    int first_bit;
+                    if (k < 2) { row = (quad.z + b) + (quad.y - plus) * R; first_bit = quad.x; }
+                    else if (k < 4) { row = (quad.x - plus) + (quad.z + b) * R; first_bit = quad.y; }
+                    else { row = (quad.x + b) + (quad.z - plus) * R; first_bit = quad.y; }
+
+                    for (int a {0}; a < quad.size_a; a++) {
+                        const ChunkRow bit = ChunkRow {1} << (first_bit + a);
+                        if (covered[k][row] & bit) matching = false;
+                        covered[k][row] |= bit;
+                    }
+                }
+
+                const uint8_t* winding = ChunkMesh::QUAD_WINDING[ChunkMesh::is_winding_reversed(k)];
+                const int normal_axis[3] { 1, 0, 2 };
+                for (int triangle {0}; triangle < 2; triangle++) {
+                    glm::vec3 corners[3];
+                    for (int i {0}; i < 3; i++) {
+                        const auto corner = ChunkMesh::quad_corner(quad, winding[triangle * 3 + i]);
+                        corners[i] = glm::vec3(corner[0], corner[1], corner[2]);
+                    }
+                    const glm::vec3 face_normal = glm::cross(corners[1] - corners[0], corners[2] - corners[0]);
+                    if (face_normal[normal_axis[k / 2]] * (plus ? 1.f : -1.f) <= 0.f) num_wrong_windings++;
+                }
+            }
+
+            if (!matching || std::memcmp(covered, culled, sizeof(ChunkMesh::FaceRows)) != 0) num_mismatching_chunks++;
+        }
+
+        //NOTE: before, 4 uint32_t vertices and 6 uint32_t indices per quad
+        constexpr std::size_t INDEXED_BYTES_PER_QUAD = 4 * sizeof(uint32_t) + 6 * sizeof(unsigned int);
+        plog(
+            "quad packing: chunks={} quads={} {:.1f} KB gpu geometry ({} bytes/quad), indexed vertices {:.1f} KB ({} bytes/quad), {:.1f}x smaller",
+            inputs.size(), num_quads,
+            num_quads * sizeof(ChunkMesh::PackedQuad) / 1000., sizeof(ChunkMesh::PackedQuad),
+            num_quads * INDEXED_BYTES_PER_QUAD / 1000., INDEXED_BYTES_PER_QUAD,
+            static_cast<double>(INDEXED_BYTES_PER_QUAD) / sizeof(ChunkMesh::PackedQuad)
+        );
+        if (num_mismatching_packs == 0 && num_mismatching_chunks == 0 && num_wrong_windings == 0) {
+            plog("packed quads round-trip and cover exactly the culled faces");
+        } else {
+            plog_error(
+                "quad packing: {} random quads don't round-trip, {} chunks don't match their faces, {} triangles face the wrong way",
+                num_mismatching_packs, num_mismatching_chunks, num_wrong_windings
+            );
+        }
+    }
+
+    //NOTE: entry fraction of the segment origin + t * direction (t in [0, max_fraction]) into the unit box of a voxel, -1 = miss
+    static float ray_box_entry(glm::vec3 origin, glm::vec3 direction, float max_fraction, glm::ivec3 voxel) {
+        float t_enter {0.0f};
+        float t_exit {max_fraction};
+        for (int axis {0}; axis < 3; axis++) {
+            if (direction[axis] == 0.0f) {
+                if (origin[axis] < voxel[axis] || origin[axis] > voxel[axis] + 1) return -1.0f;
+                continue;
+            }
+            float t0 = (voxel[axis] - origin[axis]) / direction[axis];
+            float t1 = (voxel[axis] + 1 - origin[axis]) / direction[axis];
+            if (t0 > t1) std::swap(t0, t1);
+            t_enter = std::max(t_enter, t0);
+            t_exit = std::min(t_exit, t1);
+        }
+        return t_enter <= t_exit ? t_enter : -1.0f;
+    }
+
+    void run_voxel_collision(int compound_radius) {
+        const glm::ivec3 origin(-SIZE * 1024, 0, SIZE * 1024);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+        const auto inputs = collect_mesh_inputs(compounds);
+
+        //RAYS: segments that start around and inside the chunk, up to twice the chunk size long
+        std::mt19937 random(7);
+        std::uniform_real_distribution<float> coordinate(-4.0f, SIZE + 4.0f);
+        std::uniform_real_distribution<float> offset(-2.0f * SIZE, 2.0f * SIZE);
+        auto random_ray = [&](glm::vec3& ray_origin, glm::vec3& ray_direction) {
+            ray_origin = glm::vec3(coordinate(random), coordinate(random), coordinate(random));
+            ray_direction = glm::vec3(offset(random), offset(random), offset(random));
+            //NOTE: axis aligned rays hit voxel edges all the time, keep some of them
+            if (random() % 8 == 0) ray_direction[random() % 3] = 0.0f;
+        };
+
+        //DDA: against the closest entry over all solid voxels (first chunks only, the reference is a scan of every voxel per ray)
+        constexpr int NUM_CHECKED_CHUNKS = 32;
+        constexpr int NUM_CHECKED_RAYS = 64;
+        std::size_t num_rays {0}, num_hits {0}, num_mismatching_rays {0};
+        for (std::size_t c {0}; c < std::min<std::size_t>(inputs.size(), NUM_CHECKED_CHUNKS); c++) {
+            const ChunkRow* rows = inputs[c].voxels;
+            for (int r {0}; r < NUM_CHECKED_RAYS; r++) {
+                glm::vec3 ray_origin, ray_direction;
+                random_ray(ray_origin, ray_direction);
+
+                float closest {-1.0f};
+                for (int y {0}; y < SIZE; y++) {
+                    for (int z {0}; z < SIZE; z++) {
+                        for (ChunkRow bits = rows[z + y * SIZE]; bits != 0; bits &= bits - 1) {
+                            const float entry = ray_box_entry(ray_origin, ray_direction, 1.0f, glm::ivec3(std::countr_zero(bits), y, z));
+                            if (entry >= 0.0f && (closest < 0.0f || entry < closest)) closest = entry;
+                        }
+                    }
+                }
+
+                float fraction;
+                int voxel;
+                const bool hit = VoxelCollision::cast_ray(rows, ray_origin, ray_direction, 1.0f, true, fraction, voxel);
+                num_rays++;
+                num_hits += hit;
+
+                //NOTE: ties at voxel edges may pick another voxel, it has to be solid and entered at the same fraction
+                bool matching = hit == (closest >= 0.0f);
+                if (matching && hit) {
+                    const glm::ivec3 cell(voxel % SIZE, (voxel / SIZE) % SIZE, voxel / (SIZE * SIZE));
+                    const float entry = ray_box_entry(ray_origin, ray_direction, 1.0f, cell);
+                    matching = VoxelCollision::is_solid(rows, cell.x, cell.y, cell.z) && std::abs(fraction - closest) < 1e-4f && std::abs(entry - fraction) < 1e-4f;
+                }
+                if (!matching) num_mismatching_rays++;
+            }
+        }
+
+        //SURFACE-VOXELS: random ranges (and the whole chunk) against a per-voxel neighbour check
+        std::size_t num_solid {0}, num_surface {0}, num_mismatching_ranges {0};
+        std::uniform_int_distribution<int> range_coordinate(-2, SIZE + 1);
+        for (auto& input : inputs) {
+            const ChunkRow* rows = input.voxels;
+            for (int r {0}; r < 4; r++) {
+                glm::ivec3 min(0), max(SIZE - 1);
+                if (r > 0) {
+                    min = glm::ivec3(range_coordinate(random), range_coordinate(random), range_coordinate(random));
+                    max = min + glm::ivec3(random() % SIZE, random() % SIZE, random() % SIZE);
+                }
+
+                std::vector<bool> visited(SIZE_CUBIC, false);
+                bool matching = true;
+                VoxelCollision::visit_surface_voxels(rows, min, max, [&](int x, int y, int z) {
+                    const int index = VoxelCollision::voxel_index(x, y, z);
+                    if (visited[index]) matching = false;
+                    visited[index] = true;
+                    return true;
+                });
+
+                for (int z {0}; z < SIZE; z++) {
+                    for (int y {0}; y < SIZE; y++) {
+                        for (int x {0}; x < SIZE; x++) {
+                            const bool solid = VoxelCollision::is_solid(rows, x, y, z);
+                            const bool enclosed =
+                                x > 0 && y > 0 && z > 0 && x < SIZE - 1 && y < SIZE - 1 && z < SIZE - 1 &&
+                                VoxelCollision::is_solid(rows, x - 1, y, z) && VoxelCollision::is_solid(rows, x + 1, y, z) &&
+                                VoxelCollision::is_solid(rows, x, y - 1, z) && VoxelCollision::is_solid(rows, x, y + 1, z) &&
+                                VoxelCollision::is_solid(rows, x, y, z - 1) && VoxelCollision::is_solid(rows, x, y, z + 1);
+                            const bool in_range = glm::all(glm::greaterThanEqual(glm::ivec3(x, y, z), min)) && glm::all(glm::lessThanEqual(glm::ivec3(x, y, z), max));
+                            const bool expected = solid && !enclosed && in_range;
+                            if (visited[VoxelCollision::voxel_index(x, y, z)] != expected) matching = false;
+
+                            if (r == 0) {
+                                num_solid += solid;
+                                num_surface += expected;
+                            }
+                        }
+                    }
+                }
+                if (!matching) num_mismatching_ranges++;
+            }
+        }
+
+        //BORDERS: lookups one voxel across the chunk's faces and exposed normals against the neighbours' own rows
+        auto world_solid = [](const MeshInput& input, glm::ivec3 cell) {
+            const ChunkRow* rows = input.voxels;
+            for (int axis {0}; axis < 3; axis++) {
+                if (cell[axis] >= 0 && cell[axis] < SIZE) continue;
+                if (rows != input.voxels) return false;
+
+                //NOTE: x, y, z -> ChunkNeighbour -x/+x, -y/+y, -z/+z
+                rows = input.neighbours[(axis == 0 ? 0 : axis == 1 ? 4 : 2) + (cell[axis] >= SIZE)];
+                if (!rows) return false;
+                cell[axis] += cell[axis] < 0 ? SIZE : -SIZE;
+            }
+            return VoxelCollision::is_solid(rows, cell.x, cell.y, cell.z);
+        };
+        std::size_t num_mismatching_borders {0}, num_mismatching_normals {0}, num_normals {0};
+        std::uniform_real_distribution<float> component(-1.0f, 1.0f);
+        for (std::size_t c {0}; c < std::min<std::size_t>(inputs.size(), NUM_CHECKED_CHUNKS); c++) {
+            const MeshInput& input = inputs[c];
+            VoxelCollision::BorderRows borders;
+            VoxelCollision::copy_borders(input.neighbours.data(), borders);
+            for (int z {-1}; z <= SIZE; z++) {
+                for (int y {-1}; y <= SIZE; y++) {
+                    for (int x {-1}; x <= SIZE; x++) {
+                        if (VoxelCollision::is_solid(input.voxels, borders, x, y, z) != world_solid(input, glm::ivec3(x, y, z))) num_mismatching_borders++;
+                    }
+                }
+            }
+
+            //NOTE: zero only for a voxel covered on all 6 faces, never leans into a covered face, keeps the signs of a normal that has exposed parts
+            VoxelCollision::visit_surface_voxels(input.voxels, glm::ivec3(0), glm::ivec3(SIZE - 1), [&](int x, int y, int z) {
+                const glm::vec3 normal(component(random), component(random), component(random));
+                const glm::vec3 offset = glm::vec3(component(random), component(random), component(random)) * 0.5f;
+                const glm::vec3 exposed = VoxelCollision::exposed_normal(input.voxels, borders, x, y, z, normal, offset);
+
+                bool any_exposed {false}, normal_exposed {false};
+                bool matching {true};
+                for (int axis {0}; axis < 3; axis++) {
+                    for (const int sign : { -1, 1 }) {
+                        glm::ivec3 across(x, y, z);
+                        across[axis] += sign;
+                        const bool covered = world_solid(input, across);
+                        any_exposed |= !covered;
+                        normal_exposed |= !covered && normal[axis] * sign > 0.0f;
+                        if (covered && exposed[axis] * sign > 0.0f) matching = false;
+                    }
+                }
+                if ((exposed == glm::vec3(0.0f)) == any_exposed) matching = false;
+                if (any_exposed && std::abs(glm::length(exposed) - 1.0f) > 1e-4f) matching = false;
+                for (int axis {0}; axis < 3 && normal_exposed; axis++) {
+                    if (exposed[axis] * normal[axis] < 0.0f) matching = false;
+                }
+                num_normals++;
+                if (!matching) num_mismatching_normals++;
+                return true;
+            });
+        }
+
+        //THROUGHPUT: building the shape of every chunk (copy + bounds) and dda rays
+        uint64_t checksum {0};
+        auto start = std::chrono::steady_clock::now();
+        for (auto& input : inputs) {
+            JPH::Ref<JPH::Shape> shape = new VoxelShape(input.voxels, input.neighbours.data());
+            checksum += shape->GetStats().mSizeBytes;
+        }
+        const double shape_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        constexpr int NUM_TIMED_RAYS = 256;
+        std::vector<glm::vec3> ray_origins(NUM_TIMED_RAYS), ray_directions(NUM_TIMED_RAYS);
+        for (int r {0}; r < NUM_TIMED_RAYS; r++) random_ray(ray_origins[r], ray_directions[r]);
+        start = std::chrono::steady_clock::now();
+        for (auto& input : inputs) {
+            for (int r {0}; r < NUM_TIMED_RAYS; r++) {
+                float fraction;
+                int voxel;
+                if (VoxelCollision::cast_ray(input.voxels, ray_origins[r], ray_directions[r], 1.0f, true, fraction, voxel)) checksum += voxel;
+            }
+        }
+        const double ray_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        const double num_chunks = static_cast<double>(std::max<std::size_t>(inputs.size(), 1));
+        const double num_timed_rays = num_chunks * NUM_TIMED_RAYS;
+        plog(
+            "voxel collision: chunks={} shape build {:.2f} us/chunk ({} bytes), dda {:.0f} ns/ray ({:.1f} M rays/sec), surface voxels {:.1f}% of solid (checksum {})",
+            inputs.size(), shape_seconds * 1e6 / num_chunks, sizeof(VoxelShape),
+            ray_seconds * 1e9 / num_timed_rays, ray_seconds > 0. ? num_timed_rays / ray_seconds / 1e6 : 0.,
+            num_solid > 0 ? 100. * num_surface / num_solid : 0., checksum
+        );
+        if (num_mismatching_rays == 0 && num_mismatching_ranges == 0 && num_mismatching_borders == 0 && num_mismatching_normals == 0) {
+            plog("dda matches the per-voxel ray scan ({} of {} rays hit), surface voxels match the neighbour check, borders and {} exposed normals match the neighbours", num_hits, num_rays, num_normals);
+        } else {
+            plog_error(
+                "voxel collision: {} of {} rays don't match the per-voxel scan, {} surface voxel ranges don't match, {} border lookups and {} of {} exposed normals don't match the neighbours",
+                num_mismatching_rays, num_rays, num_mismatching_ranges, num_mismatching_borders, num_mismatching_normals, num_normals
+            );
+        }
+    }
+
+    void run_voxel_shape_physics(int num_steps) {
+        //NOTE: the manager registers jolt's types and the voxel shape collisions, the scene gets a physics system of its own
+        Physics::PhysicsManager::get_instance();
+
+        //FLOOR: FLOOR voxels high over NUM_CHUNKS chunks along x, each shape knows the slices of its neighbours
+        constexpr int NUM_CHUNKS = 3;
+        constexpr int FLOOR = 4;
+        std::vector<ChunkRow> voxels(SIZE * SIZE * 3, 0);
+        for (int y {0}; y < FLOOR; y++) {
+            for (int z {0}; z < SIZE; z++) {
+                for (int x {0}; x < SIZE; x++) {
+                    voxels[z + (y * SIZE)] |= ChunkRow {1} << x;
+                    voxels[x + (y * SIZE) + (SIZE * SIZE)] |= ChunkRow {1} << z;
+                    voxels[x + (z * SIZE) + ((SIZE * SIZE) * 2)] |= ChunkRow {1} << y;
+                }
+            }
+        }
+
+        Physics::BasicBroadPhaseLayerInterface broad_phase_layer_interface;
+        Physics::BasicObjectVsBroadPhaseLayerFilter object_vs_broadphase_layer_filter;
+        Physics::BasicObjectLayerVsObjectLayerFilter object_vs_object_layer_filter;
+        PhysicsSystem physics_system;
+        physics_system.Init(1024, 0, 1024, 1024, broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_vs_object_layer_filter);
+        TempAllocatorImpl temp_allocator(10 * 1024 * 1024);
+        JobSystemSingleThreaded job_system(cMaxPhysicsJobs);
+        BodyInterface& bodies = physics_system.GetBodyInterface();
+
+        std::vector<BodyID> chunk_bodies;
+        for (int c {0}; c < NUM_CHUNKS; c++) {
+            std::array<const ChunkRow*, NumNeighbours> neighbours {};
+            neighbours[NeighbourLeft] = c > 0 ? voxels.data() : nullptr;
+            neighbours[NeighbourRight] = c < NUM_CHUNKS - 1 ? voxels.data() : nullptr;
+            const BodyCreationSettings settings(new VoxelShape(voxels.data(), neighbours.data()), RVec3(c * SIZE, 0, 0), Quat::sIdentity(), EMotionType::Static, PhysicsLayers::NON_MOVING);
+            chunk_bodies.push_back(bodies.CreateAndAddBody(settings, EActivation::DontActivate));
+        }
+
+        //BODIES: start a few voxels before the first seam, at 4 m/s the sliding ones cross it within the first second
+        const float rest_height = FLOOR + 0.5f;
+        const float start_x = SIZE - 3.0f;
+        auto add_dynamic = [&](const Shape* shape, RVec3 position, Vec3 velocity, Vec3 angular_velocity, float friction) {
+            BodyCreationSettings settings(shape, position, Quat::sIdentity(), EMotionType::Dynamic, PhysicsLayers::MOVING);
+            settings.mLinearVelocity = velocity;
+            settings.mAngularVelocity = angular_velocity;
+            settings.mFriction = friction;
+            settings.mLinearDamping = 0.0f;
+            settings.mAngularDamping = 0.0f;
+            return bodies.CreateAndAddBody(settings, EActivation::Activate);
+        };
+        const RefConst<Shape> box = new BoxShape(Vec3::sReplicate(0.5f));
+        const RefConst<Shape> sphere = new SphereShape(0.5f);
+        const BodyID resting = add_dynamic(box, RVec3(SIZE * 0.5f + 0.25f, rest_height + 1.5f, SIZE * 0.5f + 0.25f), Vec3::sZero(), Vec3::sZero(), 0.5f);
+        const BodyID rolling = add_dynamic(sphere, RVec3(start_x, rest_height, SIZE * 0.5f - 3.0f), Vec3(4.0f, 0, 0), Vec3(0, 0, -8.0f), 0.5f);
+        const BodyID sliding = add_dynamic(box, RVec3(start_x, rest_height, SIZE * 0.5f + 3.0f), Vec3(4.0f, 0, 0), Vec3::sZero(), 0.0f);
+        physics_system.OptimizeBroadPhase();
+
+        //SIMULATION: spikes in vertical velocity or height of the moving bodies are contacts with internal voxel faces,
+        //            the first SETTLE_STEPS (the bodies finding their contacts, well before the seam) are not measured
+        constexpr int SETTLE_STEPS = 15;
+        float max_vertical_speed {0.0f}, max_height_error {0.0f};
+        double step_seconds {0.};
+        for (int step {0}; step < num_steps; step++) {
+            const auto start = std::chrono::steady_clock::now();
+            physics_system.Update(Physics::cDeltaTime, Physics::cCollisionSteps, &temp_allocator, &job_system);
+            step_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (step < SETTLE_STEPS) continue;
+
+            for (const BodyID id : { rolling, sliding }) {
+                max_vertical_speed = std::max(max_vertical_speed, std::abs(bodies.GetLinearVelocity(id).GetY()));
+                max_height_error = std::max(max_height_error, std::abs(static_cast<float>(bodies.GetCenterOfMassPosition(id).GetY()) - rest_height));
+            }
+        }
+        const float resting_error = std::abs(static_cast<float>(bodies.GetCenterOfMassPosition(resting).GetY()) - rest_height);
+        const float resting_speed = bodies.GetLinearVelocity(resting).Length();
+        const float rolled = static_cast<float>(bodies.GetCenterOfMassPosition(rolling).GetX()) - start_x;
+        const float slid = static_cast<float>(bodies.GetCenterOfMassPosition(sliding).GetX()) - start_x;
+        const float sliding_speed = bodies.GetLinearVelocity(sliding).GetX();
+        const float seconds = num_steps * Physics::cDeltaTime;
+
+        //QUERIES: rays and sphere casts straight down onto random points of the floor hit its top at the floor height, normal up
+        std::mt19937 random(19);
+        std::uniform_real_distribution<float> coordinate(0.0f, NUM_CHUNKS * SIZE);
+        std::uniform_real_distribution<float> across(1.0f, SIZE - 1.0f);
+        const NarrowPhaseQuery& query = physics_system.GetNarrowPhaseQuery();
+        const SpecifiedObjectLayerFilter chunks_only(PhysicsLayers::NON_MOVING);
+        constexpr int NUM_QUERIES = 256;
+        constexpr float QUERY_HEIGHT = 10.0f;
+        int num_mismatching_rays {0}, num_mismatching_casts {0};
+        for (int q {0}; q < NUM_QUERIES; q++) {
+            const float x = coordinate(random);
+            const float z = across(random);
+            //NOTE: every other query lands exactly on a voxel edge
+            const float edge_x = q % 2 == 0 ? std::floor(x) : x;
+
+            RayCastResult ray_hit;
+            const RRayCast ray(RVec3(edge_x, QUERY_HEIGHT, z), Vec3(0, -QUERY_HEIGHT, 0));
+            const bool hit = query.CastRay(ray, ray_hit, { }, chunks_only);
+            const int chunk = std::min(static_cast<int>(edge_x) / SIZE, NUM_CHUNKS - 1);
+            const bool ray_matching = hit && std::abs(QUERY_HEIGHT * (1.0f - ray_hit.mFraction) - FLOOR) < 1e-3f &&
+                (ray_hit.mBodyID == chunk_bodies[chunk] || (chunk > 0 && std::floor(edge_x) == chunk * SIZE && ray_hit.mBodyID == chunk_bodies[chunk - 1]));
+            if (!ray_matching) num_mismatching_rays++;
+
+            const RShapeCast cast = RShapeCast::sFromWorldTransform(sphere, Vec3::sOne(), RMat44::sTranslation(RVec3(edge_x, QUERY_HEIGHT, z)), Vec3(0, -QUERY_HEIGHT, 0));
+            ShapeCastSettings cast_settings;
+            ClosestHitCollisionCollector<CastShapeCollector> cast_hit;
+            query.CastShape(cast, cast_settings, RVec3::sZero(), cast_hit, { }, chunks_only);
+            const bool cast_matching = cast_hit.HadHit() &&
+                std::abs(QUERY_HEIGHT * (1.0f - cast_hit.mHit.mFraction) - rest_height) < 1e-3f &&
+                cast_hit.mHit.mPenetrationAxis.Normalized().GetY() < -0.999f;
+            if (!cast_matching) num_mismatching_casts++;
+        }
+
+        plog(
+            "voxel shape physics: {} steps {:.1f} us/step, resting box {:.4f} above the floor at {:.4f} m/s, rolling sphere {:.1f} m, "
+            "frictionless box {:.1f} m at {:.2f} m/s, max vertical speed {:.4f} m/s, max height error {:.4f}",
+            num_steps, step_seconds * 1e6 / std::max(num_steps, 1), resting_error, resting_speed, rolled, slid, sliding_speed, max_vertical_speed, max_height_error
+        );
+        const bool resting_matching = resting_error < 0.03f && resting_speed < 0.05f;
+        const bool moving_matching = max_vertical_speed < 0.1f && max_height_error < 0.05f && rolled > SIZE - start_x && slid > 0.95f * 4.0f * seconds && sliding_speed > 3.9f;
+        if (resting_matching && moving_matching && num_mismatching_rays == 0 && num_mismatching_casts == 0) {
+            plog("the box rests, the sphere and the box cross voxel edges and the chunk seam without ghost contacts, {} rays and {} sphere casts hit the floor", NUM_QUERIES, NUM_QUERIES);
+        } else {
+            plog_error(
+                "voxel shape physics: resting {}, crossing {}, {} of {} rays and {} of {} sphere casts don't hit the floor as expected",
+                resting_matching, moving_matching, num_mismatching_rays, NUM_QUERIES, num_mismatching_casts, NUM_QUERIES
+            );
+        }
+
+        for (const BodyID id : { resting, rolling, sliding }) {
+            bodies.RemoveBody(id);
+            bodies.DestroyBody(id);
+        }
+        for (const BodyID id : chunk_bodies) {
+            bodies.RemoveBody(id);
+            bodies.DestroyBody(id);
+        }
+    }
+
+    void run_physics_streaming(int compound_radius, int num_frames) {
+        const glm::ivec3 origin(SIZE * 4096, 0, SIZE * 4096);
+        BenchWorld world(std::max(compound_radius, 2), origin);
+        auto& compounds = world.compounds;
+
+        std::vector<Chunk*> shaped_chunks;
+        for (auto& compound : compounds) {
+            compound->visit_chunks([&shaped_chunks](Chunk& chunk) { if (chunk.shape) shaped_chunks.push_back(&chunk); });
+        }
+
+        //INSERTION: every shaped chunk (what the render set used to add) one body at a time vs one batch
+        auto& physics_manager = Physics::PhysicsManager::get_instance();
+        std::vector<BodyCreationSettings> settings;
+        for (Chunk* chunk : shaped_chunks) {
+            settings.emplace_back(chunk->shape, RVec3(chunk->position.x, chunk->position.y, chunk->position.z), Quat::sIdentity(), EMotionType::Static, PhysicsLayers::NON_MOVING);
+        }
+        std::vector<unsigned int> slots(settings.size());
+
+        auto start = std::chrono::steady_clock::now();
+        for (std::size_t i {0}; i < settings.size(); i++) physics_manager.add_body(settings[i], slots[i]);
+        const double single_add_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        for (const unsigned int slot : slots) physics_manager.remove_body(slot);
+        const double single_remove_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        start = std::chrono::steady_clock::now();
+        const std::size_t num_batched = physics_manager.add_bodies(settings, slots);
+        const double batch_add_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        start = std::chrono::steady_clock::now();
+        physics_manager.remove_bodies(std::span<const unsigned int>(slots.data(), num_batched));
+        const double batch_remove_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        //RING: a body walking across the world at surface height, the ring follows it
+        const float radius = Physics::PhysicsManager::default_streaming_radius;
+        const float world_extent = std::max(compound_radius, 2) * SIZE;
+        std::size_t max_bodies {0}, sum_bodies {0}, num_mismatching_frames {0};
+        double update_seconds {0.}, max_update_seconds {0.};
+        const auto before = PhysicsStreaming::get_stats();
+        for (int frame {0}; frame < num_frames; frame++) {
+            const float t = num_frames > 1 ? static_cast<float>(frame) / (num_frames - 1) : 0.f;
+            const glm::vec4 sphere(origin.x - world_extent * .75f + t * world_extent * 1.5f, 72.f, origin.z + 0.5f, radius);
+
+            start = std::chrono::steady_clock::now();
+            PhysicsStreaming::update({ sphere });
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            update_seconds += seconds;
+            max_update_seconds = std::max(max_update_seconds, seconds);
+
+            //NOTE: exactly the shaped chunks in range have a body, and every chunk touching the sphere itself is one of them
+            std::size_t num_bodies {0};
+            bool matching = true;
+            for (Chunk* chunk : shaped_chunks) {
+                const glm::vec3 closest = glm::clamp(glm::vec3(sphere), glm::vec3(chunk->position), glm::vec3(chunk->position + SIZE));
+                const glm::vec3 offset = closest - glm::vec3(sphere);
+                const bool in_range = PhysicsStreaming::is_in_range(chunk->position, sphere);
+                if (chunk->affected_by_physics != in_range) matching = false;
+                if (glm::dot(offset, offset) <= radius * radius && !chunk->affected_by_physics) matching = false;
+                num_bodies += chunk->affected_by_physics;
+            }
+            if (!matching) num_mismatching_frames++;
+            max_bodies = std::max(max_bodies, num_bodies);
+            sum_bodies += num_bodies;
+        }
+        const auto after = PhysicsStreaming::get_stats();
+        PhysicsStreaming::clear();
+
+        //DEFERRED: a chunk a worker is meshing (mesh_mutex held) is skipped without waiting, the next update adds its body
+        const glm::vec4 held_sphere(origin.x + 0.5f, 72.f, origin.z + 0.5f, radius);
+        auto held = std::find_if(shaped_chunks.begin(), shaped_chunks.end(), [&](Chunk* chunk) { return PhysicsStreaming::is_in_range(chunk->position, held_sphere); });
+        bool deferral_matching {held != shaped_chunks.end()};
+        double held_seconds {0.};
+        if (deferral_matching) {
+            std::promise<void> locked, released;
+            std::thread worker([&] {
+                std::lock_guard<std::mutex> mesh_lock((*held)->mesh_mutex);
+                locked.set_value();
+                released.get_future().wait();
+            });
+            locked.get_future().wait();
+
+            const std::size_t num_deferred = PhysicsStreaming::get_stats().num_deferred;
+            start = std::chrono::steady_clock::now();
+            PhysicsStreaming::update({ held_sphere });
+            held_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            deferral_matching = !(*held)->affected_by_physics && PhysicsStreaming::get_stats().num_deferred > num_deferred;
+            released.set_value();
+            worker.join();
+
+            PhysicsStreaming::update({ held_sphere });
+            deferral_matching = deferral_matching && (*held)->affected_by_physics;
+            PhysicsStreaming::clear();
+        }
+
+        const double num_shaped = static_cast<double>(std::max<std::size_t>(shaped_chunks.size(), 1));
+        const double num_updates = static_cast<double>(std::max(num_frames, 1));
+        plog(
+            "physics streaming: chunks with a shape={} (all bodies before), ring of {:.0f} blocks: {:.1f} bodies avg, {} max ({:.1f}% of all)",
+            shaped_chunks.size(), radius, sum_bodies / num_updates, max_bodies, 100. * max_bodies / num_shaped
+        );
+        plog(
+            "  insertion: single {:.2f} us/body, batched {:.2f} us/body; removal: single {:.2f} us/body, batched {:.2f} us/body",
+            single_add_seconds * 1e6 / num_shaped, batch_add_seconds * 1e6 / num_shaped,
+            single_remove_seconds * 1e6 / num_shaped, batch_remove_seconds * 1e6 / num_shaped
+        );
+        plog(
+            "  ring updates: {:.2f} us/frame avg, {:.2f} us max, {} rebuilds, {} bodies added, {} removed over {} frames",
+            update_seconds * 1e6 / num_updates, max_update_seconds * 1e6, after.num_rebuilds - before.num_rebuilds,
+            after.num_added - before.num_added, after.num_removed - before.num_removed, num_frames
+        );
+        plog("  update with a chunk being meshed: {:.2f} us (the chunk is skipped, the next update adds it)", held_seconds * 1e6);
+        if (num_mismatching_frames == 0 && num_batched == settings.size() && deferral_matching) {
+            plog("only the chunks within the ring have a body, a chunk being meshed is skipped and picked up by the next update");
+        } else {
+            plog_error(
+                "physics streaming: {} frames with bodies outside/missing inside the ring, {} of {} batched bodies added, deferred chunk {}",
+                num_mismatching_frames, num_batched, settings.size(), deferral_matching ? "picked up" : "not skipped/not picked up"
+            );
+        }
+    }
+    void run_upload_queue(int compound_radius, int budget_kb) {
+        //NOTE: copies of a batch are read once the frame FENCE_LATENCY frames later ran (what glClientWaitSync polls for)
+        static constexpr int FENCE_LATENCY = 2;
+        static constexpr uint32_t RING_BYTES = 16 * 1000 * 1000;
+
+        const glm::ivec3 origin(SIZE * 8192, 0, SIZE * 4096);
+        BenchWorld world(std::max(compound_radius, 2), origin, false);
+        auto& compounds = world.compounds;
+
+        //NOTE: the "gpu" side, uploads are keyed by chunk position, a ticket per position stands in for the slot's
+        struct Resident {
+            std::vector<ChunkMesh::PackedQuad> quads;
+            uint32_t ticket {0};
+        };
+        struct Pending {
+            int frame;
+            glm::ivec3 position;
+            uint32_t ticket;
+            std::vector<ChunkMesh::PackedQuad> quads;
+        };
+        ChunkUploadQueue queue;
+        std::unordered_map<uint64_t, Resident> resident;
+        std::deque<Pending> pending;
+        auto key_of = [](glm::ivec3 position) {
+            return (static_cast<uint64_t>(static_cast<uint32_t>(position.x)) << 32) ^ (static_cast<uint64_t>(static_cast<uint32_t>(position.z)) << 8) ^ static_cast<uint64_t>(position.y);
+        };
+        Chunk::stage_render_upload = [&queue](const Chunk& chunk) { queue.stage(chunk); };
+        Chunk::release_render_slot = [&](Chunk& chunk) {
+            queue.cancel(chunk.position);
+            auto& entry = resident[key_of(chunk.position)];
+            entry.quads.clear();
+            entry.ticket++;
+        };
+
+        //STAGING: the mesh jobs copy their meshes out, like the chunk manager's workers
+        JobSystem job_system(std::max(1u, std::thread::hardware_concurrency()));
+        for (auto& compound : compounds) compound->enter_render_set();
+        std::vector<JobSystem::Job> jobs;
+        for (auto& compound : compounds) compound->collect_mesh_jobs(jobs, 0);
+        auto start = std::chrono::steady_clock::now();
+        job_system.submit_batch(jobs);
+        job_system.wait();
+        const double meshing_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        const auto staged = queue.get_stats();
+
+        //DRAIN: one drain + one fence per frame, edits into the first compounds and unloads of the last ones meanwhile
+        const std::size_t budget_bytes = static_cast<std::size_t>(std::max(budget_kb, 1)) * 1000;
+        RingAllocator ring(RING_BYTES);
+        auto& registry = ChunkRegistry::get_instance();
+        std::vector<std::size_t> frame_bytes;
+        std::size_t max_depth {0}, num_over_budget {0}, num_ring_full {0}, num_edits {0};
+        int num_drain_frames {0};
+        double drain_seconds {0.}, max_drain_seconds {0.};
+        //NOTE: half of them unload before their meshes were drained (cancelled), the other half with uploads in flight
+        const std::size_t num_unloaded = std::max<std::size_t>(compounds.size() / 16, 1) * 2;
+        std::mt19937 random(3);
+        for (int frame {0}; !pending.empty() || queue.get_stats().num_staged > 0 || frame < 8; frame++) {
+            //COMPLETE: the fence of frame - FENCE_LATENCY signalled (batch ids are frame + 1)
+            while (!pending.empty() && pending.front().frame + FENCE_LATENCY <= frame) {
+                Pending& upload = pending.front();
+                auto& entry = resident[key_of(upload.position)];
+                if (entry.ticket == upload.ticket) entry.quads = std::move(upload.quads);
+                pending.pop_front();
+            }
+            if (frame >= FENCE_LATENCY) ring.release(static_cast<uint64_t>(frame - FENCE_LATENCY + 1));
+
+            if (frame < 6) {
+                //EDITS: surface blocks broken in the first compounds, their chunks are staged again (possibly still queued)
+                for (int i {0}; i < 20; i++) {
+                    const int x = static_cast<int>(compounds[0]->position.x) + static_cast<int>(random() % SIZE);
+                    const int z = static_cast<int>(compounds[0]->position.z) + static_cast<int>(random() % SIZE);
+                    for (int y = NUM_CHUNKS_PER_COMPOUND * SIZE - 1; y >= 0; y--) {
+                        if (Chunk::set_block_world(x, y, z, BlockType::Air)) {
+                            num_edits++;
+                            break;
+                        }
+                    }
+                }
+            }
+            if (frame < 2) {
+                const std::size_t first = compounds.size() - (frame == 0 ? num_unloaded : num_unloaded / 2);
+                for (std::size_t i {first}; i < first + num_unloaded / 2; i++) compounds[i]->unload();
+            }
+
+            max_depth = std::max(max_depth, queue.get_stats().num_staged);
+            start = std::chrono::steady_clock::now();
+            std::size_t num_meshes {0};
+            const std::size_t bytes = queue.drain(budget_bytes, [&](StagedMesh& mesh) {
+                ChunkRegistry::Guard guard;
+                Chunk* chunk = registry.find(mesh.position);
+                if (!chunk) return true;
+                {
+                    std::lock_guard<std::mutex> mesh_lock(chunk->mesh_mutex);
+                    if (!chunk->in_render_set) return true;
+                }
+                if (ring.allocate(static_cast<uint32_t>(mesh.size_bytes()), 16) == RingAllocator::INVALID) {
+                    num_ring_full++;
+                    return false;
+                }
+                pending.push_back(Pending { frame, mesh.position, resident[key_of(mesh.position)].ticket, std::move(mesh.quads) });
+                num_meshes++;
+                return true;
+            });
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ring.close_batch();
+
+            drain_seconds += seconds;
+            max_drain_seconds = std::max(max_drain_seconds, seconds);
+            if (bytes > budget_bytes && num_meshes > 1) num_over_budget++;
+            if (bytes > 0) num_drain_frames = frame + 1;
+            frame_bytes.push_back(bytes);
+        }
+
+        //CHECK: the chunks of loaded compounds are resident with their current mesh, unloaded ones have nothing
+        std::size_t num_resident {0}, num_mismatching {0};
+        for (std::size_t i {0}; i < compounds.size(); i++) {
+            const bool loaded = i < compounds.size() - num_unloaded;
+            compounds[i]->visit_chunks([&](Chunk& chunk) {
+                const auto it = resident.find(key_of(chunk.position));
+                const std::vector<ChunkMesh::PackedQuad> empty;
+                const auto& uploaded = it != resident.end() ? it->second.quads : empty;
+                const auto& expected = loaded && chunk.mesh ? chunk.mesh->quads : empty;
+                if (uploaded != expected) num_mismatching++;
+                num_resident += !uploaded.empty();
+            });
+        }
+        Chunk::stage_render_upload = nullptr;
+        Chunk::release_render_slot = nullptr;
+
+        const std::size_t total_bytes = std::accumulate(frame_bytes.begin(), frame_bytes.end(), std::size_t {0});
+        const std::size_t max_bytes = frame_bytes.empty() ? 0 : *std::max_element(frame_bytes.begin(), frame_bytes.end());
+        const auto stats = queue.get_stats();
+        plog(
+            "upload queue: {} chunks staged ({:.1f} MB) by the mesh jobs in {:.1f} ms, budget {} KB/frame: {} frames to drain, "
+            "{:.2f} MB max/frame (all at once: {:.1f} MB in one frame)",
+            staged.num_staged, staged.staged_bytes / 1000000., meshing_seconds * 1000., budget_kb, num_drain_frames,
+            max_bytes / 1000000., staged.staged_bytes / 1000000.
+        );
+        plog(
+            "  queue depth {} max, {:.3f} ms/frame drain avg ({:.3f} max), {} uploads ({:.1f} MB), {} replaced by {} edits, {} cancelled, ring full {} times",
+            max_depth, drain_seconds * 1000. / std::max<std::size_t>(frame_bytes.size(), 1), max_drain_seconds * 1000.,
+            stats.num_drained, total_bytes / 1000000., stats.num_replaced, num_edits, stats.num_cancelled, num_ring_full
+        );
+        if (num_mismatching == 0 && num_over_budget == 0) {
+            plog("every frame stayed within the budget, {} resident chunks hold their current mesh", num_resident);
+        } else {
+            plog_error("upload queue: {} chunks with a stale/missing/unexpected mesh, {} frames over the budget", num_mismatching, num_over_budget);
+        }
+    }
+    void run_render_set(int render_distance, int num_moves) {
+        const auto directory = std::filesystem::temp_directory_path() / "voxel-render-set-benchmark";
+        std::filesystem::remove_all(directory);
+
+        const int previous_distance = ChunkManager::chunk_render_distance;
+        const std::string previous_directory = ChunkManager::world_directory;
+        const std::size_t previous_budget_mb = ChunkManager::cache_budget_mb;
+        const std::size_t previous_budget_compounds = ChunkManager::cache_budget_compounds;
+        ChunkManager::chunk_render_distance = render_distance;
+        ChunkManager::world_directory = directory.string();
+        //NOTE: about one render set and a half, walking back reloads evicted compounds from their region files
+        const int num_visible = static_cast<int>(compound_positions_in_radius(render_distance, glm::ivec3(0)).size());
+        ChunkManager::cache_budget_mb = 0;
+        ChunkManager::cache_budget_compounds = static_cast<std::size_t>(num_visible + num_visible / 2);
+
+        StageTimings updates;
+        std::size_t num_snapshots {0};
+        uint64_t last_version {0};
+        std::size_t num_not_entered {0}, num_not_unloaded {0}, num_visible_chunks {0};
+        std::size_t registered {0}, expected_registered {0};
+        bool deferral_matching {false};
+        double held_unload_ms {0.};
+        const std::size_t num_deferred_before = ChunkManager::num_deferred_syncs.load();
+        {
+            const glm::ivec3 origin(SIZE * 16384, 0, SIZE * 2048);
+            ChunkManager manager(origin);
+
+            //NOTE: one move per snapshot (the worker coalesces moves it didn't get to), out along +x and back again
+            auto frame = [&](glm::ivec3 position) {
+                auto start = std::chrono::steady_clock::now();
+                manager.update(position);
+                updates.add(std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+                const auto snapshot = manager.get_render_set();
+                if (snapshot && snapshot->version != last_version) {
+                    last_version = snapshot->version;
+                    num_snapshots++;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            };
+            glm::ivec3 position = origin;
+            for (int move {0}; move < 2 * num_moves; move++) {
+                position.x += (move < num_moves ? 1 : -1) * SIZE;
+                const uint64_t version = last_version;
+                for (int i {0}; i < 2000 && last_version == version; i++) frame(position);
+            }
+
+            //SETTLE: until the worker published nothing new for a while
+            for (int quiet {0}; quiet < 200; quiet++) {
+                const uint64_t version = last_version;
+                frame(position);
+                if (last_version != version) quiet = 0;
+            }
+
+            //DEFERRED: a compound with a chunk a worker is meshing (mesh_mutex held) unloads without waiting for it,
+            //          the held chunk stays in the render set until a later try, entering it again restores the snapshot
+            const auto snapshot = manager.get_render_set();
+            if (snapshot && !snapshot->compounds.empty()) {
+                ChunkCompound& compound = *snapshot->compounds.front();
+                Chunk* held {nullptr};
+                compound.visit_chunks([&held](Chunk& chunk) { if (!held) held = &chunk; });
+                if (held) {
+                    std::promise<void> locked, released;
+                    std::thread worker([&] {
+                        std::lock_guard<std::mutex> mesh_lock(held->mesh_mutex);
+                        locked.set_value();
+                        released.get_future().wait();
+                    });
+                    locked.get_future().wait();
+
+                    const auto start = std::chrono::steady_clock::now();
+                    const bool unloaded_while_held = compound.try_unload();
+                    held_unload_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+                    const bool held_stayed = held->in_render_set;
+                    released.set_value();
+                    worker.join();
+
+                    deferral_matching = !unloaded_while_held && held_stayed && compound.try_unload() && !held->in_render_set && compound.try_enter_render_set();
+                }
+            }
+
+            //CHECK: chunks of snapshot compounds are in the render set, every other registered chunk around the path is not
+            std::unordered_set<uint64_t> visible;
+            if (snapshot) {
+                for (auto& compound : snapshot->compounds) {
+                    visible.insert((static_cast<uint64_t>(static_cast<uint32_t>(compound->position.x)) << 32) | static_cast<uint32_t>(compound->position.z));
+                }
+            }
+            manager.visit_chunks([&](Chunk& chunk) {
+                std::lock_guard<std::mutex> mesh_lock(chunk.mesh_mutex);
+                if (!chunk.in_render_set) num_not_entered++;
+                num_visible_chunks++;
+            });
+
+            auto& registry = ChunkRegistry::get_instance();
+            const int reach = render_distance + num_moves + 1;
+            ChunkRegistry::Guard guard;
+            for (int x = -reach; x <= reach + num_moves; x++) {
+                for (int z = -reach; z <= reach; z++) {
+                    const glm::ivec3 compound_position = origin + glm::ivec3(x, 0, z) * SIZE;
+                    const uint64_t key = (static_cast<uint64_t>(static_cast<uint32_t>(compound_position.x)) << 32) | static_cast<uint32_t>(compound_position.z);
+                    if (visible.contains(key)) continue;
+                    for (int y {0}; y < NUM_CHUNKS_PER_COMPOUND; y++) {
+                        Chunk* chunk = registry.find(compound_position + glm::ivec3(0, y * SIZE, 0));
+                        if (!chunk) continue;
+                        std::lock_guard<std::mutex> mesh_lock(chunk->mesh_mutex);
+                        if (chunk->in_render_set) num_not_unloaded++;
+                    }
+                }
+            }
+            //NOTE: evicted compounds are gone from the registry once no snapshot holds them (no position registered twice)
+            registered = registry.size();
+            expected_registered = static_cast<std::size_t>(ChunkManager::num_chunks) * NUM_CHUNKS_PER_COMPOUND;
+        }
+        ChunkRegistry::get_instance().collect();
+
+        plog(
+            "render set: distance {} compounds, {} moves out and back: {} snapshots synced, update() p50={:.3f} ms p99={:.3f} ms max={:.3f} ms, {} evicted",
+            render_distance, num_moves, num_snapshots, updates.percentile_ms(.5), updates.percentile_ms(.99), updates.percentile_ms(1.),
+            ChunkManager::num_evicted.load()
+        );
+        plog(
+            "  {} compound syncs put off a frame (a chunk was being meshed), unload with a chunk held {:.3f} ms",
+            ChunkManager::num_deferred_syncs.load() - num_deferred_before, held_unload_ms
+        );
+        if (num_not_entered == 0 && num_not_unloaded == 0 && registered == expected_registered && deferral_matching) {
+            plog("render set membership matches the last snapshot ({} visible chunks), a chunk being meshed is unloaded later instead of waited for", num_visible_chunks);
+        } else {
+            plog_error(
+                "render set: {} snapshot chunks not entered, {} chunks outside still entered, {} chunks registered for {} cached, held chunk {}",
+                num_not_entered, num_not_unloaded, registered, expected_registered, deferral_matching ? "deferred" : "not deferred/not unloaded later"
+            );
+        }
+
+        ChunkManager::chunk_render_distance = previous_distance;
+        ChunkManager::world_directory = previous_directory;
+        ChunkManager::cache_budget_mb = previous_budget_mb;
+        ChunkManager::cache_budget_compounds = previous_budget_compounds;
+        std::filesystem::remove_all(directory);
+    }
+
+    void run_teleport(int render_distance) {
+        const auto directory = std::filesystem::temp_directory_path() / "voxel-teleport-benchmark";
+
+        const int previous_distance = ChunkManager::chunk_render_distance;
+        const std::string previous_directory = ChunkManager::world_directory;
+        const std::size_t previous_wave = ChunkManager::compounds_per_wave;
+        ChunkManager::chunk_render_distance = render_distance;
+        ChunkManager::world_directory = directory.string();
+        const std::size_t num_visible = compound_positions_in_radius(render_distance, glm::ivec3(0)).size();
+
+        struct Mode {
+            const char* name;
+            std::size_t compounds_per_wave;
+        };
+        for (const Mode& mode : { Mode { "all at once", SIZE_MAX }, Mode { "waves", 0 } }) {
+            std::filesystem::remove_all(directory);
+            ChunkManager::compounds_per_wave = mode.compounds_per_wave;
+
+            const glm::ivec3 origin(SIZE * 16384, 0, SIZE * 16384);
+            const glm::ivec3 first = origin + glm::ivec3(SIZE * 1024, 0, 0);
+            const glm::ivec3 target = origin + glm::ivec3(0, 0, SIZE * 1024);
+            const glm::vec3 view_direction(1, 0, 0);
+
+            double ground_ms {-1.}, complete_ms {-1.};
+            std::size_t num_cancelled {0};
+            {
+                ChunkManager manager(origin);
+                auto is_complete = [&](glm::ivec3 center) {
+                    const auto snapshot = manager.get_render_set();
+                    if (!snapshot || snapshot->compounds.size() != num_visible || ChunkManager::num_requests_pending > 0) return false;
+                    for (auto& compound : snapshot->compounds) {
+                        const glm::ivec3 offset = (glm::ivec3(compound->position) - center) / SIZE;
+                        if (offset.x * offset.x + offset.z * offset.z > render_distance * render_distance) return false;
+                    }
+                    return true;
+                };
+
+                //SETTLE: the start position is fully streamed in
+                for (int i {0}; i < 60000 && !is_complete(origin); i++) {
+                    manager.update(origin, view_direction);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+                const std::size_t cancelled_before = ChunkManager::num_cancelled;
+
+                //TELEPORT: twice, the first request set is abandoned after a few frames
+                for (int frame {0}; frame < 5; frame++) {
+                    manager.update(first, view_direction);
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                }
+
+                auto has_ground = [&] {
+                    const auto snapshot = manager.get_render_set();
+                    if (!snapshot) return false;
+                    for (auto& compound : snapshot->compounds) {
+                        if (compound->position.x != target.x || compound->position.z != target.z) continue;
+
+                        bool ground {false};
+                        compound->visit_chunks([&](Chunk& chunk) {
+                            std::lock_guard<std::mutex> mesh_lock(chunk.mesh_mutex);
+                            if (chunk.built && chunk.mesh && !chunk.mesh->quads.empty()) ground = true;
+                        });
+                        return ground;
+                    }
+                    return false;
+                };
+
+                const auto start = std::chrono::steady_clock::now();
+                auto elapsed_ms = [&start] { return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count(); };
+                for (int i {0}; i < 60000 && complete_ms < 0.; i++) {
+                    manager.update(target, view_direction);
+                    if (ground_ms < 0. && has_ground()) ground_ms = elapsed_ms();
+                    if (is_complete(target)) complete_ms = elapsed_ms();
+                    std::this_thread::sleep_for(std::chrono::microseconds(200));
+                }
+                num_cancelled = ChunkManager::num_cancelled - cancelled_before;
+            }
+            ChunkRegistry::get_instance().collect();
+
+            if (ground_ms < 0. || complete_ms < 0.) {
+                plog_error("teleport ({}): the render set around the target never completed", mode.name);
+                continue;
+            }
+            plog(
+                "teleport ({}): distance {} compounds, ground under the player after {:.1f} ms, {} compounds complete after {:.1f} ms, {} requests cancelled",
+                mode.name, render_distance, ground_ms, num_visible, complete_ms, num_cancelled
+            );
+        }
+
+        ChunkManager::chunk_render_distance = previous_distance;
+        ChunkManager::world_directory = previous_directory;
+        ChunkManager::compounds_per_wave = previous_wave;
+        std::filesystem::remove_all(directory);
+    }
+
+    void run_lod(int compound_radius) {
+        const glm::ivec3 origin(SIZE * 2048, 0, -SIZE * 4096);
+        const int radius = std::max(compound_radius, 4);
+        const auto previous_distances = ChunkManager::lod_distances;
+        const int previous_render_distance = ChunkManager::chunk_render_distance;
+        ChunkManager::chunk_render_distance = radius;
+        ChunkManager::lod_distances = { 0.25f, 0.5f, 0.75f };
+
+        BenchWorld world(radius, origin, false);
+        auto& compounds = world.compounds;
+
+        struct Ring {
+            std::size_t num_compounds {0};
+            std::size_t quads_full {0}, quads_reduced {0};
+            double seconds_full {0.}, seconds_reduced {0.};
+        };
+        std::array<Ring, ChunkManager::MAX_LOD + 1> rings;
+
+        auto count_quads = [](ChunkCompound& compound) {
+            std::size_t quads {0};
+            compound.visit_chunks([&quads](Chunk& chunk) { if (chunk.mesh) quads += chunk.mesh->quads.size(); });
+            return quads;
+        };
+        auto ring_of = [&origin](const ChunkCompound& compound) {
+            const glm::ivec3 offset = (glm::ivec3(compound.position) - origin) / SIZE;
+            return ChunkManager::select_lod(offset.x, offset.z);
+        };
+
+        //FULL: every compound generated first, the mesher needs the horizontal neighbours
+        for (auto& compound : compounds) {
+            Ring& ring = rings[ring_of(*compound)];
+            auto start = std::chrono::steady_clock::now();
+            compound->build_chunk_meshes();
+            ring.seconds_full += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ring.quads_full += count_quads(*compound);
+            ring.num_compounds++;
+        }
+
+        //REDUCED: the compounds of the outer rings remeshed at the level of their ring
+        for (auto& compound : compounds) {
+            const uint8_t lod = ring_of(*compound);
+            if (lod == 0) continue;
+            Ring& ring = rings[lod];
+            auto start = std::chrono::steady_clock::now();
+            compound->build_chunk_meshes(lod);
+            ring.seconds_reduced += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ring.quads_reduced += count_quads(*compound);
+        }
+
+        //MISSING-NEIGHBOUR: a built chunk whose +x neighbour is gone keeps its level and mesh, the level changes once it is back
+        bool kept_level {true};
+        std::size_t num_level_checks {0};
+        auto& registry = ChunkRegistry::get_instance();
+        for (auto& compound : compounds) {
+            if (num_level_checks > 0) break;
+            if (ring_of(*compound) == 0) continue;
+            compound->visit_chunks([&](Chunk& chunk) {
+                if (num_level_checks > 0 || !chunk.built || !chunk.mesh) return;
+                Chunk* neighbour = registry.find(chunk.position + glm::ivec3(SIZE, 0, 0));
+                if (!neighbour) return;
+
+                const uint8_t level = chunk.lod;
+                const ChunkMesh* mesh = chunk.mesh.get();
+                registry.remove(neighbour);
+                chunk.set_lod(0);
+                kept_level &= chunk.lod == level && chunk.mesh.get() == mesh;
+                registry.insert(neighbour);
+                chunk.set_lod(0);
+                kept_level &= chunk.lod == 0 && chunk.mesh.get() != mesh;
+                chunk.set_lod(level);
+                kept_level &= chunk.lod == level;
+                num_level_checks++;
+            });
+        }
+
+        //CHECK: the reduced occupancy covers every solid voxel (what keeps the seams closed), back to full resolution gives the same meshes
+        std::size_t num_uncovered_rows {0}, quads_restored {0}, quads_full {0};
+        auto downsampled = std::make_unique<ChunkRow[]>(SIZE * SIZE * 3);
+        for (auto& compound : compounds) {
+            compound->visit_chunks([&](Chunk& chunk) {
+                if (!chunk.voxels) return;
+                for (int lod {1}; lod <= ChunkManager::MAX_LOD; lod++) {
+                    ChunkMesh::downsample(chunk.voxels.get(), 1 << lod, downsampled.get());
+                    for (int i {0}; i < SIZE * SIZE * 3; i++) {
+                        if ((downsampled[i] & chunk.voxels[i]) != chunk.voxels[i]) num_uncovered_rows++;
+                    }
+                }
+            });
+            compound->build_chunk_meshes();
+            quads_restored += count_quads(*compound);
+        }
+        for (auto& ring : rings) quads_full += ring.quads_full;
+
+        plog("lod ring 0 (full resolution, {} compounds): {} triangles, meshing {:.2f} ms", rings[0].num_compounds, 2 * rings[0].quads_full, rings[0].seconds_full * 1000.);
+        for (int lod {1}; lod <= ChunkManager::MAX_LOD; lod++) {
+            const Ring& ring = rings[lod];
+            if (ring.num_compounds == 0) continue;
+            plog(
+                "lod ring {} (cells of {}^3, {} compounds): {} -> {} triangles ({:.1f}%), meshing {:.2f} -> {:.2f} ms",
+                lod, 1 << lod, ring.num_compounds, 2 * ring.quads_full, 2 * ring.quads_reduced,
+                ring.quads_full > 0 ? 100. * ring.quads_reduced / ring.quads_full : 100.,
+                ring.seconds_full * 1000., ring.seconds_reduced * 1000.
+            );
+        }
+        if (num_uncovered_rows == 0 && quads_restored == quads_full && kept_level && num_level_checks > 0) {
+            plog("lod: reduced occupancy covers the full one, full resolution meshes restored ({} triangles), a chunk missing a neighbour keeps its level", 2 * quads_restored);
+        } else {
+            plog_error(
+                "lod: {} occupancy rows not covered by their reduction, {} of {} quads after restoring full resolution, level kept without a neighbour: {} ({} checks)",
+                num_uncovered_rows, quads_restored, quads_full, kept_level, num_level_checks
+            );
+        }
+
+        ChunkManager::lod_distances = previous_distances;
+        ChunkManager::chunk_render_distance = previous_render_distance;
+    }
+
+    void run_far_terrain(int num_frames) {
+        Noise noise;
+        const float inner_distance = static_cast<float>(ChunkManager::chunk_render_distance * SIZE);
+        const std::size_t previous_cache = FarTerrain::cache_budget_tiles;
+
+        //COST: a few tiles of every level vs one compound (generation only, no meshing)
+        constexpr int NUM_TILES_PER_LEVEL = 16;
+        std::size_t num_mismatching_heights {0};
+        static_assert(FarTerrain::MAX_LEVEL == 6, "the cost line below prints 7 levels");
+        std::array<double, FarTerrain::MAX_LEVEL + 1> tile_us {};
+        for (int level {0}; level <= FarTerrain::MAX_LEVEL; level++) {
+            auto start = std::chrono::steady_clock::now();
+            for (int i {0}; i < NUM_TILES_PER_LEVEL; i++) {
+                const FarTerrain::Tile tile = FarTerrain::generate_tile(noise, level, glm::ivec2(i, 1000 + level));
+                if (i > 0) continue;
+
+                //NOTE: the sample is the column's top face, the generator's height + 1
+                for (int z {0}; z <= FarTerrain::RESOLUTION; z++) {
+                    for (int x {0}; x <= FarTerrain::RESOLUTION; x++) {
+                        int height {0};
+                        noise.fetch_heightmap_grid(tile.origin.x + x * tile.spacing, tile.origin.y + z * tile.spacing, 1, &height);
+                        if (tile.heights[x + z * (FarTerrain::RESOLUTION + 1)] != height + 1) num_mismatching_heights++;
+                    }
+                }
+            }
+            const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            tile_us[level] = seconds * 1e6 / NUM_TILES_PER_LEVEL;
+        }
+        auto start = std::chrono::steady_clock::now();
+        { ChunkCompound compound(noise, glm::vec3(SIZE * 8192, 0, SIZE * 8192)); }
+        ChunkRegistry::get_instance().collect();
+        const double compound_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        plog(
+            "far terrain: {} samples per tile, generation per tile (levels 0-6) {:.0f}/{:.0f}/{:.0f}/{:.0f}/{:.0f}/{:.0f}/{:.0f} us, one compound {:.0f} us",
+            FarTerrain::NUM_SAMPLES, tile_us[0], tile_us[1], tile_us[2], tile_us[3], tile_us[4], tile_us[5], tile_us[6], compound_seconds * 1e6
+        );
+
+        //FILL: the whole selection at the start, the workers drained after every update
+        FarTerrain terrain;
+        glm::vec3 position(0.f, 80.f, 0.f);
+        start = std::chrono::steady_clock::now();
+        terrain.update(position, inner_distance);
+        while (terrain.get_stats().num_visible < terrain.get_stats().num_selected) {
+            terrain.wait();
+            terrain.update(position, inner_distance);
+        }
+        const std::size_t num_selected = terrain.get_stats().num_selected;
+        const double fill_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        FarTerrain::cache_budget_tiles = 2 * num_selected;
+
+        //WALK: along +x without waiting, update() only submits and collects, a cache of about two selections
+        StageTimings updates;
+        std::size_t num_incomplete_frames {0}, max_pending {0};
+        for (int frame {0}; frame < num_frames; frame++) {
+            position.x += 16.f;
+            terrain.update(position, inner_distance);
+            updates.add(terrain.get_stats().update_seconds);
+            max_pending = std::max(max_pending, terrain.get_stats().num_pending);
+            if (terrain.get_stats().num_visible < terrain.get_stats().num_selected) num_incomplete_frames++;
+        }
+        int frames_to_complete {0};
+        while (terrain.get_stats().num_visible < terrain.get_stats().num_selected && frames_to_complete < 10000) {
+            terrain.wait();
+            terrain.update(position, inner_distance);
+            frames_to_complete++;
+        }
+        const auto stats = terrain.get_stats();
+
+        //CHECK: every point of the far ring lies in exactly one visible tile
+        std::size_t num_uncovered {0}, num_overlapping {0}, num_points {0};
+        for (float distance = inner_distance + 1.f; distance < FarTerrain::far_distance * .99f; distance *= 1.15f) {
+            for (int step {0}; step < 64; step++) {
+                const float angle = step * (6.2831853f / 64.f);
+                const glm::vec2 point(position.x + std::cos(angle) * distance, position.z + std::sin(angle) * distance);
+                int num_containing {0};
+                for (const FarTerrain::Tile* tile : terrain.get_visible_tiles()) {
+                    if (point.x >= tile->origin.x && point.x < tile->origin.x + tile->size() && point.y >= tile->origin.y && point.y < tile->origin.y + tile->size()) num_containing++;
+                }
+                if (num_containing == 0) num_uncovered++;
+                if (num_containing > 1) num_overlapping++;
+                num_points++;
+            }
+        }
+
+        plog(
+            "far terrain: {} tiles out to {} blocks ({:.1f} MB of heights, first fill {:.1f} ms), walk of {} frames: update p50={:.3f} ms p99={:.3f} ms max={:.3f} ms (sampling on the workers)",
+            num_selected, FarTerrain::far_distance, num_selected * FarTerrain::NUM_SAMPLES * sizeof(float) / 1000000.f, fill_ms,
+            num_frames, updates.percentile_ms(.5), updates.percentile_ms(.99), updates.percentile_ms(1.)
+        );
+        plog(
+            "  {} frames with tiles missing (at most {} pending), {} more to complete, {} generated ({:.0f} us/tile avg), {} evicted, {} cached",
+            num_incomplete_frames, max_pending, frames_to_complete, stats.num_generated, stats.num_generated > 0 ? stats.generation_seconds * 1e6 / stats.num_generated : 0.,
+            stats.num_evicted, stats.num_cached
+        );
+        const bool pending_capped = max_pending <= static_cast<std::size_t>(FarTerrain::max_pending_tiles);
+        if (num_uncovered == 0 && num_overlapping == 0 && num_mismatching_heights == 0 && pending_capped) {
+            plog("far terrain covers the ring exactly once ({} points), tile heights match the heightmap, pending tiles stay capped", num_points);
+        } else {
+            plog_error(
+                "far terrain: {} of {} points uncovered, {} covered twice, {} heights differ from the heightmap, {} tiles pending (cap {})",
+                num_uncovered, num_points, num_overlapping, num_mismatching_heights, max_pending, FarTerrain::max_pending_tiles
+            );
+        }
+
+        FarTerrain::cache_budget_tiles = previous_cache;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#pragma once
+#include <string>
+
+namespace Voxel::Game::Benchmark {
+    //NOTE: headless (no window / gl-context), results are written to the log
+    //NOTE: the last run's compounds are generated again in reverse order on one thread, the blocks must be identical
+    void run_generation_scaling(int compound_radius);
+    //NOTE: single threaded, compares the column-aware pass against the full per-voxel scan (voxels/sec + identical output)
+    void run_generation_paths(int compound_radius);
+    //NOTE: single threaded, the avx2 noise kernels against the scalar FastNoiseLite path (height maps and cave grids of whole compounds,
+    //      bit-exact check, samples/sec of both)
+    void run_noise_kernels(int compound_radius);
+    //NOTE: single threaded, per compound latency of loading from a region file vs generating from noise,
+    //      bytes on disk after repeated rewrites (freed record space reused)
+    void run_region_loading(int compound_radius);
+    //NOTE: single threaded, latency of a block edit (incremental slice remesh) vs a full rebuild of the edited chunk
+    void run_block_edits(int compound_radius, int num_edits);
+    //NOTE: single threaded, fixed seed world_size x world_size compounds (plus a ring for the neighbours),
+    //      ns/voxel, quads/chunk, bytes/chunk and p50/p99 per stage, also written to json_path (if not empty)
+    void run_pipeline(int world_size, unsigned int seed, const std::string& json_path);
+    //NOTE: cpu only, churn of chunk sized allocations through the tlsf allocator behind the gpu arenas (ns/op, fragmentation, overlap check)
+    void run_arena_allocator(int num_operations);
+    //NOTE: cpu only, per frame cost of frustum culling + building the multi-draw commands on the cpu (camera circling the world),
+    //      the baseline the gpu culling removes
+    void run_draw_commands(int compound_radius, int num_frames);
+    //NOTE: single threaded, face connectivity per chunk (checked against a per-voxel flood fill) and the culled share
+    //      of the cave search from a camera in the sky, on the surface and underground
+    void run_cave_culling(int compound_radius);
+    //NOTE: single threaded, row-parallel face culling vs the per-bit scatter (bit-exact check, chunks/sec) and whole chunks meshed/sec
+    void run_face_culling(int compound_radius);
+    //NOTE: single threaded, the same world_width x WORLD_HEIGHT x world_width box meshed as 16^3, 32^3 and 64^3 chunks
+    //      (meshing throughput, draws/jolt bodies, quads, gpu bytes), independent of the chunk size of the build
+    void run_chunk_sizes(int world_width);
+    //NOTE: single threaded, heap allocations per meshed chunk (full build and single slice remesh)
+    void run_mesh_allocations(int compound_radius);
+    //NOTE: single threaded, packed quads round-trip (random fields and every meshed quad), the decoded quads cover exactly
+    //      the culled faces with outward facing triangles, gpu bytes against the indexed vertex format
+    void run_quad_packing(int compound_radius);
+    //NOTE: single threaded, the voxel collision queries (dda rays against a per-voxel scan, surface voxels against a neighbour check),
+    //      voxel shape build cost and rays/sec
+    void run_voxel_collision(int compound_radius);
+    //NOTE: single threaded, jolt against voxel shapes of a flat floor over 3 chunks: a box coming to rest, a sphere rolling and a
+    //      frictionless box sliding across voxel edges and the chunk seams (vertical velocity/height spikes are ghost contacts),
+    //      ray and sphere casts onto the floor
+    void run_voxel_shape_physics(int num_steps);
+    //NOTE: single threaded, static bodies of the whole world vs the ring around a body walking across it (bodies, us per update,
+    //      ring check every frame) and one-at-a-time vs batched broadphase insertion/removal
+    void run_physics_streaming(int compound_radius, int num_frames);
+    //NOTE: cpu only, meshes staged by the mesh jobs drained under a per-frame byte budget through a ring with fence latency
+    //      (bytes/frame, queue depth, frames to drain), edits and unloads while draining, the uploaded set is checked at the end
+    void run_upload_queue(int compound_radius, int budget_kb);
+    //NOTE: a ChunkManager streaming along a path and back (small cache, evictions) while this thread syncs its render set
+    //      snapshots every frame: update() latency, snapshots seen, render set membership and registry checked at the end
+    void run_render_set(int render_distance, int num_moves);
+    //NOTE: a ChunkManager teleported twice in a row (the second one before the first request set is done), every compound at once
+    //      vs waves: time until the ground under the player is meshed in a snapshot, until the render set is complete, cancelled requests
+    void run_teleport(int render_distance);
+    //NOTE: single threaded, every compound meshed at full resolution and at the level of its lod ring (rings at 1/4, 1/2, 3/4 of the radius):
+    //      triangles and meshing time per ring, OR-reduced occupancy checked to cover the full one, full meshes restored at the end
+    void run_lod(int compound_radius);
+    //NOTE: far terrain tile generation cost per level on this thread (vs one voxel compound), the tiles selected around the player,
+    //      a walk generating on the terrain's workers (update time, frames until complete, evictions), coverage, heights and
+    //      max_pending_tiles checked
+    void run_far_terrain(int num_frames);
+}
\ No newline at end of file
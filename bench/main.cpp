@@ -0,0 +1,55 @@
+#include <string_view>
+#include <string>
+#include "core/log.h"
+#include "benchmark.h"
+
+using namespace Voxel;
+
+//USAGE: voxel_bench [--world-size N] [--seed S] [--json FILE] [--radius R] [--pipeline-only]
+int main(int argc, char** argv) {
+    int world_size {8};
+    unsigned int seed {1};
+    std::string json_path;
+    int compound_radius {8};
+    bool pipeline_only {false};
+
+    for (int i {1}; i < argc; i++) {
+        const std::string_view argument(argv[i]);
+        const bool has_value = i + 1 < argc;
+
+        if (argument == "--world-size" && has_value) world_size = std::stoi(argv[++i]);
+        else if (argument == "--seed" && has_value) seed = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (argument == "--json" && has_value) json_path = argv[++i];
+        else if (argument == "--radius" && has_value) compound_radius = std::stoi(argv[++i]);
+        else if (argument == "--pipeline-only") pipeline_only = true;
+        else {
+            plog("usage: voxel_bench [--world-size N] [--seed S] [--json FILE] [--radius R] [--pipeline-only]");
+            return argument == "--help" ? 0 : 1;
+        }
+    }
+
+    Game::Benchmark::run_pipeline(world_size, seed, json_path);
+    if (pipeline_only) return 0;
+
+    Game::Benchmark::run_generation_paths(compound_radius);
+    Game::Benchmark::run_noise_kernels(compound_radius);
+    Game::Benchmark::run_region_loading(compound_radius);
+    Game::Benchmark::run_block_edits(compound_radius, 1000);
+    Game::Benchmark::run_face_culling(compound_radius);
+    Game::Benchmark::run_chunk_sizes(256);
+    Game::Benchmark::run_mesh_allocations(compound_radius);
+    Game::Benchmark::run_quad_packing(compound_radius);
+    Game::Benchmark::run_voxel_collision(compound_radius);
+    Game::Benchmark::run_voxel_shape_physics(240);
+    Game::Benchmark::run_physics_streaming(compound_radius, 600);
+    Game::Benchmark::run_upload_queue(compound_radius, 4000);
+    Game::Benchmark::run_render_set(4, 24);
+    Game::Benchmark::run_teleport(8);
+    Game::Benchmark::run_lod(compound_radius * 2);
+    Game::Benchmark::run_far_terrain(600);
+    Game::Benchmark::run_arena_allocator(1000000);
+    Game::Benchmark::run_draw_commands(compound_radius, 360);
+    Game::Benchmark::run_cave_culling(compound_radius);
+    Game::Benchmark::run_generation_scaling(compound_radius);
+    return 0;
+}
\ No newline at end of file
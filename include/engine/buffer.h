@@ -21,9 +21,7 @@ namespace Voxel {
             void bind() const override;
             void unbind() const override;
             void data(float* data, size_t data_size, GLenum usage);
-            void mapped_data(void* data, size_t data_size);
             void sub_data(void* data, size_t data_size);
-            void* buffer_memory_ptr;
     };
 
     class EBO : public Buffer {
@@ -33,9 +31,7 @@ namespace Voxel {
             void bind() const override;
             void unbind() const override;
             void data(void* data, size_t data_size, GLenum usage);
-            void mapped_data(void* data, size_t data_size);
             void sub_data(void* data, size_t data_size);
-            void* buffer_memory_ptr;
     };
 
     class VAO : public Buffer {
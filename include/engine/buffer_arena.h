@@ -0,0 +1,38 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <glad/glad.h>
+#include "engine/tlsf_allocator.h"
+
+namespace Voxel {
+    //NOTE: one gpu-only gl buffer, sub-allocated in units of unit_size bytes by a TlsfAllocator, written by gpu copies (UploadRing)
+    //NOTE: grows (at least doubles) when an allocation doesn't fit, the contents are copied on the gpu
+    class BufferArena {
+    public:
+        BufferArena(uint32_t unit_size, uint32_t capacity);
+        ~BufferArena();
+
+        BufferArena(const BufferArena&) = delete;
+        BufferArena& operator=(const BufferArena&) = delete;
+
+        TlsfAllocator::Allocation allocate(uint32_t count);
+        void free(TlsfAllocator::Allocation& allocation);
+        //NOTE: queues a copy from source_offset (bytes) of source into the allocation, ordered with the draws around it
+        void copy(GLuint source, std::size_t source_offset, const TlsfAllocator::Allocation& allocation, std::size_t size_bytes);
+
+        GLuint get_id() const { return id; }
+        uint32_t get_unit_size() const { return unit_size; }
+        //NOTE: bumped on every grow (new buffer id), bindings of the old buffer have to be refreshed
+        uint32_t get_generation() const { return generation; }
+        TlsfAllocator::Stats get_stats() const { return allocator.get_stats(); }
+
+    private:
+        void create(uint32_t capacity, GLuint& buffer);
+        void grow(uint32_t min_capacity);
+
+        uint32_t unit_size;
+        GLuint id {0};
+        uint32_t generation {0};
+        TlsfAllocator allocator;
+    };
+}
\ No newline at end of file
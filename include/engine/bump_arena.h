@@ -0,0 +1,41 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+namespace Voxel {
+    //BUMP-ARENA: linear allocations out of one block, released all at once by reset()
+    //NOTE: the block only grows (in reset), a thread that reuses its arena stops allocating once it saw its largest job
+    class BumpArena {
+    public:
+        //NOTE: invalidates every span handed out so far, afterwards at least bytes can be allocated
+        void reset(std::size_t bytes) {
+            offset = 0;
+            if (bytes <= capacity) return;
+
+            capacity = std::max(bytes, capacity * 2);
+            memory = std::make_unique_for_overwrite<std::byte[]>(capacity);
+        }
+
+        //NOTE: uninitialized, the caller has to stay within the bytes given to reset()
+        template <typename U> std::span<U> allocate(std::size_t count) {
+            offset = (offset + alignof(U) - 1) & ~(alignof(U) - 1);
+            U* data = reinterpret_cast<U*>(memory.get() + offset);
+            offset += count * sizeof(U);
+            return std::span<U>(data, count);
+        }
+
+        //NOTE: worst case padding of one allocation, add it per allocate() call when sizing reset()
+        template <typename U> static constexpr std::size_t padded_bytes(std::size_t count) {
+            return count * sizeof(U) + alignof(U) - 1;
+        }
+
+        std::size_t get_capacity() const { return capacity; }
+
+    private:
+        std::unique_ptr<std::byte[]> memory;
+        std::size_t capacity {0};
+        std::size_t offset {0};
+    };
+}
\ No newline at end of file
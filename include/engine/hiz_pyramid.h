@@ -0,0 +1,36 @@
+#pragma once
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "engine/shader.h"
+
+namespace Voxel {
+    //NOTE: max-depth mip chain (r32f) of a single sample depth texture, level n + 1 = ceil(level n / 2)
+    //NOTE: texel (x, y) of level n covers the level 0 texels [x, y] * 2^n .. [x + 1, y + 1] * 2^n - 1
+    class HiZPyramid {
+    public:
+        HiZPyramid() = default;
+        ~HiZPyramid();
+
+        HiZPyramid(const HiZPyramid&) = delete;
+        HiZPyramid& operator=(const HiZPyramid&) = delete;
+
+        //NOTE: depth_texture has to be resolved already, view_projection is the one the depth was rendered with
+        void update(Shader& downsample_shader, GLuint depth_texture, int width, int height, const glm::mat4& view_projection);
+        void invalidate() { valid = false; }
+
+        bool is_valid() const { return valid; }
+        GLuint get_id() const { return id; }
+        glm::ivec2 get_size() const { return size; }
+        int get_num_levels() const { return num_levels; }
+        const glm::mat4& get_view_projection() const { return view_projection; }
+
+    private:
+        void create(int width, int height);
+
+        GLuint id {0};
+        glm::ivec2 size {0};
+        int num_levels {0};
+        glm::mat4 view_projection {1.f};
+        bool valid {false};
+    };
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Voxel {
+    class JobSystem {
+    public:
+        struct Job {
+            std::function<void()> task;
+            //NOTE: lower value = higher priority (e.g. squared distance to the player)
+            int priority {0};
+        };
+
+        explicit JobSystem(unsigned int num_workers = std::thread::hardware_concurrency());
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        void submit(std::function<void()> task, int priority = 0);
+        void submit_batch(std::vector<Job>& jobs);
+        void wait();
+
+        unsigned int get_num_workers() const { return static_cast<unsigned int>(workers.size()); }
+
+    private:
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        void worker_func(unsigned int index);
+        bool pop_job(unsigned int index, Job& job);
+        bool steal_job(unsigned int thief_index, Job& job);
+        void run_job(Job& job);
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+
+        std::atomic<unsigned int> next_queue {0};
+        std::atomic<int> jobs_pending {0};
+        uint64_t submit_epoch {0};
+        bool should_exit {false};
+
+        std::mutex sleep_mutex;
+        std::condition_variable sleep_cv;
+        std::condition_variable done_cv;
+    };
+}
@@ -1,354 +1,402 @@
 #pragma once
 #include <bit>
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <span>
 #include <vector>
 #include <stdint.h>
 #include <string_view>
-#include <Jolt/Jolt.h>
-#include <Jolt/Physics/Collision/Shape/MeshShape.h>
 #include "engine/geometry.h"
+#include "engine/bump_arena.h"
 #include "core/log.h"
 
 namespace Voxel {
+    //NOTE: indexed triangles (models, screen quad, skybox), Instance3D uploads them into its own vbo/ebo
     template <typename T> class Mesh {
     public:
-        uint32_t packed_vertex_data(
-            uint8_t pos_x, uint8_t pos_y, uint8_t pos_z,
-            uint8_t flip, uint8_t norm_x, uint8_t norm_y, uint8_t norm_z,
-            uint8_t uv_x, uint8_t uv_y
-        ) {
-            uint32_t packed = 0;
-            packed |= (pos_x & 0x1F) << 27;
-            packed |= (pos_y & 0x1F) << 22;
-            packed |= (pos_z & 0x1F) << 17;
-
-            packed |= (uv_x & 0x1F) << 12;
-            packed |= (uv_y & 0x1F) << 7;
-
-            packed |= (flip & 0x1) << 6;
-            packed |= (norm_x & 0x1) << 5;
-            packed |= (norm_y & 0x1) << 4;
-            packed |= (norm_z & 0x1) << 3;
-
-            return packed;
-        }
+        Mesh(const std::vector<T>& vertices, const std::vector<unsigned int>& indices) : vertices(vertices), indices(indices) {}
 
-        JPH::Ref<JPH::Shape> create_mesh_collision_shape(std::vector<JPH::Float3>& vertices, std::vector<JPH::uint32>& indices) {
-            if (vertices.empty()) return nullptr;
+        std::vector<T> vertices;
+        std::vector<unsigned int> indices;
+    };
 
-            JPH::MeshShapeSettings meshSettings;
-            meshSettings.SetEmbedded();
+    //NOTE: output of the voxel mesher, greedy merged quads and nothing else (the chunk meshes)
+    //NOTE: Row is the occupancy row of the chunk meshes (one bit per voxel), its width is the chunk edge length
+    template <typename Row = uint16_t> class QuadMesh {
+    public:
+        static constexpr std::size_t ROW_SIZE = sizeof(Row) * 8;
+
+        //FACE-DIRECTIONS: 0 = +y, 1 = -y, 2 = +x, 3 = -x, 4 = +z, 5 = -z
+        //NOTE: quads of a direction only ever merge within one slice (y for 0/1, x for 2/3, z for 4/5)
+        static constexpr int NUM_FACE_DIRECTIONS = 6;
+
+        //QUAD-LAYOUT (lsb first): x, y, z (8 bits each), direction (3 bits), unused (5 bits), size_a, size_b (8 bits each), unused (16 bits)
+        //NOTE: the vertex shader expands a quad into its 4 corners, no vertex or index buffer (greedy-mesh/vert.glsl)
+        using PackedQuad = uint64_t;
+
+        struct Quad {
+            //NOTE: corner with the smallest coordinates, in the face plane (+1 along the normal for the positive directions)
+            uint8_t x, y, z;
+            uint8_t direction;
+            //NOTE: extent along the first / second axis of QUAD_AXES, 1 to ROW_SIZE
+            uint8_t size_a, size_b;
+
+            bool operator==(const Quad&) const = default;
+        };
+
+        //NOTE: axes (0 = x, 1 = y, 2 = z) a quad of a direction spans, corner bit 0 steps along the first, bit 1 along the second
+        static constexpr int QUAD_AXES[NUM_FACE_DIRECTIONS][2] { { 0, 2 }, { 0, 2 }, { 1, 2 }, { 1, 2 }, { 1, 0 }, { 1, 0 } };
+        //NOTE: corners of the two triangles, the first/second row for the directions with a normal/reversed winding
+        static constexpr uint8_t QUAD_WINDING[2][6] { { 0, 1, 2, 1, 3, 2 }, { 2, 1, 0, 2, 3, 1 } };
+        static constexpr bool is_winding_reversed(int direction) { return direction == 0 || direction == 3 || direction == 4; }
+
+        static constexpr PackedQuad pack_quad(const Quad& quad) {
+            const uint32_t low = quad.x | (quad.y << 8) | (quad.z << 16) | ((quad.direction & 0x7u) << 24);
+            const uint32_t high = quad.size_a | (quad.size_b << 8);
+            return (static_cast<PackedQuad>(high) << 32) | low;
+        }
 
-            for (const auto& vertex : vertices) {
-                meshSettings.mTriangleVertices.push_back(vertex);
-            }
+        static constexpr Quad unpack_quad(PackedQuad packed) {
+            return Quad {
+                static_cast<uint8_t>(packed),
+                static_cast<uint8_t>(packed >> 8),
+                static_cast<uint8_t>(packed >> 16),
+                static_cast<uint8_t>((packed >> 24) & 0x7u),
+                static_cast<uint8_t>(packed >> 32),
+                static_cast<uint8_t>(packed >> 40)
+            };
+        }
 
-            for (size_t i = 0; i < indices.size(); i += 3) {
-                JPH::IndexedTriangle triangle;
-                triangle.mIdx[0] = indices[i];
-                triangle.mIdx[1] = indices[i + 1];
-                triangle.mIdx[2] = indices[i + 2];
-                triangle.mMaterialIndex = 0;
-                meshSettings.mIndexedTriangles.push_back(triangle);
-            }
+        //NOTE: corner 0 to 3 of the quad in chunk space, the cpu side of what the vertex shader computes from gl_VertexID
+        static std::array<uint32_t, 3> quad_corner(const Quad& quad, int corner) {
+            std::array<uint32_t, 3> position { quad.x, quad.y, quad.z };
+            position[QUAD_AXES[quad.direction][0]] += (corner & 1) * quad.size_a;
+            position[QUAD_AXES[quad.direction][1]] += (corner >> 1) * quad.size_b;
+            return position;
+        }
 
-            JPH::Shape::ShapeResult result = meshSettings.Create();
-            if (result.HasError()) {
-                plog_error("failed to create mesh shape: {}", result.GetError().c_str());
-                return nullptr;
-            }
+        static_assert(ROW_SIZE <= 64, "dirty slices hold one bit per slice in a uint64_t");
 
-            return result.Get();
+        //NOTE: one scratch arena per meshing thread, grows to the largest chunk it meshed and is reused afterwards
+        static BumpArena& scratch_arena() {
+            static thread_local BumpArena arena;
+            return arena;
         }
 
-        Mesh(uint16_t* voxels, uint16_t** neighbour_chunk_voxels, const std::size_t size, JPH::Ref<JPH::Shape>& shape)
+        QuadMesh(const Row* voxels, Row* const* neighbour_chunk_voxels)
         {
-            #pragma region face_culling
-            std::vector<uint16_t> voxels_zy_top_face(size * size, 0);
-            std::vector<uint16_t> voxels_zy_bottom_face(size * size, 0);
-            std::vector<uint16_t> voxels_xz_right_face(size * size, 0);
-            std::vector<uint16_t> voxels_xz_left_face(size * size, 0);
-            std::vector<uint16_t> voxels_xz_front_face(size * size, 0);
-            std::vector<uint16_t> voxels_xz_back_face(size * size, 0);
-
-            for (std::size_t i {0}; i < size; i++) {
-                for (std::size_t j {0}; j < size; j++) {
-                    //x-axis
-                    uint16_t row = voxels[j + (i * size)];
-                    uint32_t row_neighbors_included = static_cast<uint32_t>(row) << 1;
-
-                    uint16_t row_x_minus_one_neighbor = neighbour_chunk_voxels[0] ? neighbour_chunk_voxels[0][j + (i * size)] : 0;
-                    row_neighbors_included |= row_x_minus_one_neighbor >> 15;
-
-                    uint16_t row_x_plus_one_neighbor = neighbour_chunk_voxels[1] ? neighbour_chunk_voxels[1][j + (i * size)] : 0;
-                    row_neighbors_included |= (row_x_plus_one_neighbor & 1) << 17;
+            const uint64_t all_slices[NUM_FACE_DIRECTIONS] { ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull };
+            remesh(voxels, neighbour_chunk_voxels, all_slices);
+        }
 
-                    uint16_t row_right_face = static_cast<uint16_t>((row_neighbors_included & ~(row_neighbors_included >> 1)) >> 1);
-                    uint16_t row_left_face = static_cast<uint16_t>((row_neighbors_included & ~(row_neighbors_included << 1)) >> 1);
+        //NOTE: dirty_slices holds one bit per slice for every face direction, the quads of all other slices are kept
+        void remesh(const Row* voxels, Row* const* neighbour_chunk_voxels, const uint64_t* dirty_slices)
+        {
+            //NOTE: the first build has no quads to keep, every slice is meshed
+            const bool first_build = slice_offsets.empty();
+            const uint64_t all_slices[NUM_FACE_DIRECTIONS] { ~0ull, ~0ull, ~0ull, ~0ull, ~0ull, ~0ull };
+            if (first_build) dirty_slices = all_slices;
+
+            FaceRows faces;
+            cull_faces(voxels, neighbour_chunk_voxels, dirty_slices, faces);
+
+            //QUAD-BOUND: every quad covers at least one face bit of a dirty slice, clean slices keep their quads
+            std::size_t max_quads {0};
+            for (int k {0}; k < NUM_FACE_DIRECTIONS; k++) {
+                for (const Row row : faces[k]) max_quads += std::popcount(row);
+                if (first_build) continue;
+                for (std::size_t slice {0}; slice < ROW_SIZE; slice++) {
+                    const std::size_t bucket = k * ROW_SIZE + slice;
+                    if (!((dirty_slices[k] >> slice) & 1)) max_quads += slice_offsets[bucket + 1] - slice_offsets[bucket];
+                }
+            }
 
+            //NOTE: the quads are written into the thread's arena and copied out once at their exact size
+            constexpr std::size_t NUM_SLICE_OFFSETS = NUM_FACE_DIRECTIONS * ROW_SIZE + 1;
+            BumpArena& arena = scratch_arena();
+            arena.reset(BumpArena::padded_bytes<PackedQuad>(max_quads) + BumpArena::padded_bytes<uint32_t>(NUM_SLICE_OFFSETS));
+            const std::span<PackedQuad> remeshed_quads = arena.allocate<PackedQuad>(max_quads);
+            const std::span<uint32_t> remeshed_slice_offsets = arena.allocate<uint32_t>(NUM_SLICE_OFFSETS);
+            PackedQuad* out = remeshed_quads.data();
 
-                    //z-axis
-                    uint16_t row2 = voxels[j + (i * size) + (size * size)];
-                    uint32_t row2_neighbors_included = static_cast<uint32_t>(row2) << 1;
+            #pragma region greedy_meshing
+            for (int k {0}; k < NUM_FACE_DIRECTIONS; k++) {
+                for (std::size_t slice {0}; slice < ROW_SIZE; slice++) {
+                    const std::size_t bucket = k * ROW_SIZE + slice;
+                    remeshed_slice_offsets[bucket] = static_cast<uint32_t>(out - remeshed_quads.data());
+
+                    if ((dirty_slices[k] >> slice) & 1) {
+                        greedy_mesh_slice(faces[k], k, slice, out);
+                    } else {
+                        out = std::copy(quads.begin() + slice_offsets[bucket], quads.begin() + slice_offsets[bucket + 1], out);
+                    }
+                }
+            }
+            remeshed_slice_offsets[NUM_FACE_DIRECTIONS * ROW_SIZE] = static_cast<uint32_t>(out - remeshed_quads.data());
+            #pragma endregion
 
-                    uint16_t row_z_minus_one_neighbor = neighbour_chunk_voxels[2] ? neighbour_chunk_voxels[2][j + (i * size) + (size * size)] : 0;
-                    row2_neighbors_included |= row_z_minus_one_neighbor >> 15;
+            quads.assign(remeshed_quads.data(), out);
+            slice_offsets.assign(remeshed_slice_offsets.begin(), remeshed_slice_offsets.end());
+        }
 
-                    uint16_t row_z_plus_one_neighbor = neighbour_chunk_voxels[3] ? neighbour_chunk_voxels[3][j + (i * size) + (size * size)] : 0;
-                    row2_neighbors_included |= (row_z_plus_one_neighbor & 1) << 17;
+        //NOTE: ordered by (direction, slice) bucket
+        std::vector<PackedQuad> quads;
+        //NOTE: quad offsets per (direction, slice) bucket, direction-major, NUM_FACE_DIRECTIONS * ROW_SIZE + 1 entries
+        std::vector<uint32_t> slice_offsets;
 
-                    uint16_t row_front_face = static_cast<uint16_t>((row2_neighbors_included & ~(row2_neighbors_included >> 1)) >> 1);
-                    uint16_t row_back_face = static_cast<uint16_t>((row2_neighbors_included & ~(row2_neighbors_included << 1)) >> 1);
+        //NOTE: face rows per direction, same layout greedy_mesh_slice consumes
+        using FaceRows = Row[NUM_FACE_DIRECTIONS][ROW_SIZE * ROW_SIZE];
 
-                    //y-axis
-                    uint16_t row_vertical = voxels[i + (j * size) + (size * size * 2)];
-                    uint32_t row_vertical_neighbors_included = static_cast<uint32_t>(row_vertical) << 1;
+        //NOTE: the occupancy already holds every row orientation, the face rows are laid out like the x-major rows (+y/-y)
+        //      and the y-major rows (+x/-x, +z/-z), so every face row is one row and-not its neighbouring row,
+        //      whole slices at a time (vectorizes, no per-bit scatter, no transpose, no heap)
+        static void cull_faces(const Row* voxels, Row* const* neighbour_chunk_voxels, const uint64_t* dirty_slices, FaceRows& faces)
+        {
+            #pragma region face_culling
+            constexpr std::size_t PLANE = ROW_SIZE * ROW_SIZE;
+            //NOTE: x-major rows are indexed z + y * ROW_SIZE, y-major rows x + z * ROW_SIZE (bits are x and y)
+            const Row* rows_x = voxels;
+            const Row* rows_y = voxels + (2 * PLANE);
+            auto neighbour_rows = [neighbour_chunk_voxels](int neighbour, std::size_t offset) -> const Row* {
+                return neighbour_chunk_voxels[neighbour] ? neighbour_chunk_voxels[neighbour] + offset : EMPTY_ROWS;
+            };
 
-                    uint16_t row_y_minus_one_neighbor = neighbour_chunk_voxels[4] ? neighbour_chunk_voxels[4][i + (j * size) + (size * size * 2)] : 0;
-                    row_vertical_neighbors_included |= row_y_minus_one_neighbor >> 15;
+            //NOTE: rows of clean slices are cleared, greedy meshing never reads them
+            Row slice_masks[NUM_FACE_DIRECTIONS][ROW_SIZE];
+            for (int k {0}; k < NUM_FACE_DIRECTIONS; k++) {
+                for (std::size_t slice {0}; slice < ROW_SIZE; slice++) {
+                    slice_masks[k][slice] = ((dirty_slices[k] >> slice) & 1) ? static_cast<Row>(~Row {0}) : Row {0};
+                }
+            }
 
-                    uint16_t row_y_plus_one_neighbor = neighbour_chunk_voxels[5] ? neighbour_chunk_voxels[5][i + (j * size) + (size * size * 2)] : 0;
-                    row_vertical_neighbors_included |= (row_y_plus_one_neighbor & 1) << 17;
+            //y-axis: a slice against the slice above/below (the first/last slice of the top/bottom neighbour)
+            for (std::size_t y {0}; y < ROW_SIZE; y++) {
+                const Row* slice = rows_x + (y * ROW_SIZE);
+                const Row* above = (y + 1 < ROW_SIZE) ? slice + ROW_SIZE : neighbour_rows(5, 0);
+                const Row* below = (y > 0) ? slice - ROW_SIZE : neighbour_rows(4, (ROW_SIZE - 1) * ROW_SIZE);
+                Row* top = faces[0] + (y * ROW_SIZE);
+                Row* bottom = faces[1] + (y * ROW_SIZE);
+
+                for (std::size_t z {0}; z < ROW_SIZE; z++) {
+                    top[z] = slice[z] & ~above[z] & slice_masks[0][y];
+                    bottom[z] = slice[z] & ~below[z] & slice_masks[1][y];
+                }
+            }
 
-                    uint16_t row_top_face = static_cast<uint16_t>((row_vertical_neighbors_included & ~(row_vertical_neighbors_included >> 1)) >> 1);
-                    uint16_t row_bottom_face = static_cast<uint16_t>((row_vertical_neighbors_included & ~(row_vertical_neighbors_included << 1)) >> 1);
+            for (std::size_t z {0}; z < ROW_SIZE; z++) {
+                //x-axis: rows of a z line against their x neighbours, padded with the left/right neighbour's row
+                const Row* line = rows_y + (z * ROW_SIZE);
+                Row padded_line[ROW_SIZE + 2];
+                padded_line[0] = neighbour_rows(0, (2 * PLANE) + (ROW_SIZE - 1) + (z * ROW_SIZE))[0];
+                std::copy(line, line + ROW_SIZE, padded_line + 1);
+                padded_line[ROW_SIZE + 1] = neighbour_rows(1, (2 * PLANE) + (z * ROW_SIZE))[0];
+
+                //z-axis: a z line against the line in front/behind (the first/last line of the back/front neighbour)
+                const Row* line_plus = (z + 1 < ROW_SIZE) ? line + ROW_SIZE : neighbour_rows(3, 2 * PLANE);
+                const Row* line_minus = (z > 0) ? line - ROW_SIZE : neighbour_rows(2, (2 * PLANE) + ((ROW_SIZE - 1) * ROW_SIZE));
+
+                Row* right = faces[2] + (z * ROW_SIZE);
+                Row* left = faces[3] + (z * ROW_SIZE);
+                Row* front = faces[4] + (z * ROW_SIZE);
+                Row* back = faces[5] + (z * ROW_SIZE);
+
+                for (std::size_t x {0}; x < ROW_SIZE; x++) {
+                    right[x] = line[x] & ~padded_line[x + 2] & slice_masks[2][x];
+                    left[x] = line[x] & ~padded_line[x] & slice_masks[3][x];
+                    front[x] = line[x] & ~line_plus[x] & slice_masks[4][z];
+                    back[x] = line[x] & ~line_minus[x] & slice_masks[5][z];
+                }
+            }
+            #pragma endregion
+        }
 
-                    for (std::size_t k {0}; k < size; k++) {
-                        voxels_xz_right_face[k + (j * size)] |= ((row_right_face >> k) & 1) << i;
-                        voxels_xz_left_face[k + (j * size)] |= ((row_left_face >> k) & 1) << i;
+        //LOD: every cell of factor^3 voxels becomes solid if any of its voxels is (OR-reduction), written back at full resolution
+        //NOTE: the three row orientations reduce alike (rows over an a/b plane, one bit per voxel along the third axis),
+        //      greedy meshing the result emits the quads of the coarse grid scaled by factor, the quad layout stays the same
+        static void downsample(const Row* voxels, int factor, Row* out)
+        {
+            constexpr std::size_t PLANE = ROW_SIZE * ROW_SIZE;
+            //NOTE: the lowest bit of every cell along the row
+            Row cell_bits {0};
+            for (std::size_t bit {0}; bit < ROW_SIZE; bit += factor) cell_bits |= Row {1} << bit;
+
+            for (int orientation {0}; orientation < 3; orientation++) {
+                const Row* rows = voxels + orientation * PLANE;
+                Row* rows_out = out + orientation * PLANE;
+
+                for (std::size_t b {0}; b < ROW_SIZE; b += factor) {
+                    for (std::size_t a {0}; a < ROW_SIZE; a += factor) {
+                        Row merged {0};
+                        for (int j {0}; j < factor; j++) {
+                            for (int i {0}; i < factor; i++) merged |= rows[(a + i) + (b + j) * ROW_SIZE];
+                        }
 
-                        voxels_xz_front_face[j + (k * size)] |= ((row_front_face >> k) & 1) << i;
-                        voxels_xz_back_face[j + (k * size)] |= ((row_back_face >> k) & 1) << i;
+                        //NOTE: folds each cell into its lowest bit and spreads it back over the cell
+                        for (int shift {1}; shift < factor; shift <<= 1) merged |= static_cast<Row>(merged >> shift);
+                        Row reduced = merged & cell_bits;
+                        for (int shift {1}; shift < factor; shift <<= 1) reduced |= static_cast<Row>(reduced << shift);
 
-                        voxels_zy_top_face[j + (k * size)] |= ((row_top_face >> k) & 1) << i;
-                        voxels_zy_bottom_face[j + (k * size)] |= ((row_bottom_face >> k) & 1) << i;
+                        for (int j {0}; j < factor; j++) {
+                            for (int i {0}; i < factor; i++) rows_out[(a + i) + (b + j) * ROW_SIZE] = reduced;
+                        }
                     }
                 }
             }
-            #pragma endregion
+        }
 
-            uint16_t** arrays = new uint16_t*[6] {
-                voxels_zy_top_face.data(), voxels_zy_bottom_face.data(),
-                voxels_xz_right_face.data(), voxels_xz_left_face.data(),
-                voxels_xz_front_face.data(), voxels_xz_back_face.data(),
-            };
+        //NOTE: the previous per-bit scatter, only kept as the reference cull_faces is checked/benchmarked against
+        static void cull_faces_scatter(const Row* voxels, Row* const* neighbour_chunk_voxels, const uint64_t* dirty_slices, FaceRows& faces)
+        {
+            for (auto& face : faces) std::fill(std::begin(face), std::end(face), 0);
+
+            for (std::size_t i {0}; i < ROW_SIZE; i++) {
+                for (std::size_t j {0}; j < ROW_SIZE; j++) {
+                    Row row_right_face, row_left_face, row_front_face, row_back_face, row_top_face, row_bottom_face;
+                    cull_row(voxels, neighbour_chunk_voxels, 0, j + (i * ROW_SIZE), row_right_face, row_left_face);
+                    cull_row(voxels, neighbour_chunk_voxels, 2, j + (i * ROW_SIZE) + (ROW_SIZE * ROW_SIZE), row_front_face, row_back_face);
+                    cull_row(voxels, neighbour_chunk_voxels, 4, i + (j * ROW_SIZE) + (ROW_SIZE * ROW_SIZE * 2), row_top_face, row_bottom_face);
+
+                    for (uint64_t bits = row_right_face & dirty_slices[2]; bits != 0; bits &= bits - 1)
+                        faces[2][std::countr_zero(bits) + (j * ROW_SIZE)] |= Row {1} << i;
+                    for (uint64_t bits = row_left_face & dirty_slices[3]; bits != 0; bits &= bits - 1)
+                        faces[3][std::countr_zero(bits) + (j * ROW_SIZE)] |= Row {1} << i;
+
+                    for (uint64_t bits = row_front_face & dirty_slices[4]; bits != 0; bits &= bits - 1)
+                        faces[4][j + (std::countr_zero(bits) * ROW_SIZE)] |= Row {1} << i;
+                    for (uint64_t bits = row_back_face & dirty_slices[5]; bits != 0; bits &= bits - 1)
+                        faces[5][j + (std::countr_zero(bits) * ROW_SIZE)] |= Row {1} << i;
+
+                    for (uint64_t bits = row_top_face & dirty_slices[0]; bits != 0; bits &= bits - 1)
+                        faces[0][j + (std::countr_zero(bits) * ROW_SIZE)] |= Row {1} << i;
+                    for (uint64_t bits = row_bottom_face & dirty_slices[1]; bits != 0; bits &= bits - 1)
+                        faces[1][j + (std::countr_zero(bits) * ROW_SIZE)] |= Row {1} << i;
+                }
+            }
+        }
 
-            vertices.reserve(size * size * 4 * 6);
-            indices.reserve(size * size * 8 * 6);
-            unsigned int triangles {0};
+    private:
+        static constexpr Row EMPTY_ROWS[ROW_SIZE] {};
 
-            std::vector<JPH::Float3> vertices_jolt;
-            std::vector<JPH::uint32> indices_jolt;
+        //NOTE: faces of one row against the last bit of the minus and the first bit of the plus neighbour's row (missing neighbours are air)
+        static void cull_row(const Row* voxels, Row* const* neighbour_chunk_voxels, int minus_neighbour, std::size_t index, Row& plus_face, Row& minus_face)
+        {
+            const Row row = voxels[index];
 
-            #pragma region greedy_meshing
+            const Row row_minus_one_neighbor = neighbour_chunk_voxels[minus_neighbour] ? neighbour_chunk_voxels[minus_neighbour][index] : 0;
+            const Row row_plus_one_neighbor = neighbour_chunk_voxels[minus_neighbour + 1] ? neighbour_chunk_voxels[minus_neighbour + 1][index] : 0;
 
-            for (std::size_t i {0}; i < size; i++)
-            {
-                for (std::size_t j {0}; j < size; j++)
-                {
-                    int index = j + (i * size);
-                    for (int k {0}; k < 2; k++)
-                    {
-                        uint16_t& row = arrays[k][index];
-
-                        if (row == 0) continue;
-
-                        while (row != 0) {
-                            uint16_t x0 = std::countr_zero(static_cast<unsigned>(row));
-                            uint16_t height = std::countr_one(static_cast<unsigned>(row >> x0));
-                            uint16_t mask = ((1u << height) - 1) << x0;
-
-                            uint16_t width {1};
-                            row ^= mask;
-
-                            for (std::size_t l = (j + 1); l < size; l++)
-                            {
-                                if ((mask & arrays[k][l + (i * size)]) != mask)
-                                    break;
-
-                                arrays[k][l + (i * size)] ^= mask;
-                                width++;
-                            }
-
-                            std::size_t old_v_size = vertices.size();
-                            std::size_t old_i_size = indices.size();
-                            vertices.resize(old_v_size + 4);
-                            indices.resize(old_i_size + 6);
-
-                            uint32_t* vertex_ptr = vertices.data() + old_v_size;
-                            unsigned int* index_ptr = indices.data() + old_i_size;
-
-                            uint8_t z0f = j;
-                            uint8_t z1f = (j + width);
-                            uint8_t x0f = x0;
-                            uint8_t x1f = (x0 + height);
-                            uint8_t y0f = i;
-
-                            uint8_t norm_flip = 0;
-                            if (k == 0) {
-                                y0f += 1.f;
-                                norm_flip = 1;
-
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 0;
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 1;
-                            }
-                            else {
-                                *index_ptr++ = triangles + 0; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 2;
-                                *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 2;
-                            }
-
-                            *vertex_ptr++ = packed_vertex_data(x0f, y0f, z0f, norm_flip,  0, 1, 0, 0, 0);
-                            *vertex_ptr++ = packed_vertex_data(x1f, y0f, z0f, norm_flip,  0, 1, 0, height, 0);
-                            *vertex_ptr++ = packed_vertex_data(x0f, y0f, z1f, norm_flip,  0, 1, 0, 0, width);
-                            *vertex_ptr++ = packed_vertex_data(x1f, y0f, z1f, norm_flip,  0, 1, 0, height, width);
-
-                            vertices_jolt.push_back(JPH::Float3(x0f, y0f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x1f, y0f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x0f, y0f, z1f));
-                            vertices_jolt.push_back(JPH::Float3(x1f, y0f, z1f));
-
-                            triangles += 4;
-                        }
-                    }
-                    for (int k {2}; k < 4; k++) {
-                        uint16_t& row = arrays[k][index];
-
-                        if (row == 0) continue;
-
-                        while (row != 0) {
-                            uint16_t y0 = std::countr_zero(static_cast<unsigned>(row));
-                            uint16_t height = std::countr_one(static_cast<unsigned>(row >> y0));
-                            uint16_t mask = ((1u << height) - 1) << y0;
-
-                            uint16_t width {1};
-                            row ^= mask;
-
-                            for (std::size_t l = (i + 1); l < size; l++)
-                            {
-                                if ((mask & arrays[k][j + (l * size)]) != mask)
-                                    break;
-
-                                arrays[k][j + (l * size)] ^= mask;
-                                width++;
-                            }
-
-                            std::size_t old_v_size = vertices.size();
-                            std::size_t old_i_size = indices.size();
-                            vertices.resize(old_v_size + 4);
-                            indices.resize(old_i_size + 6);
-
-                            uint32_t* vertex_ptr = vertices.data() + old_v_size;
-                            unsigned int* index_ptr = indices.data() + old_i_size;
-
-                            uint8_t x0f = j;
-                            uint8_t y0f = y0;
-                            uint8_t y1f = (y0 + height);
-                            uint8_t z0f = i;
-                            uint8_t z1f = (i + width);
-
-                            uint8_t norm_flip = 0;
-
-                            if (k == 2) {
-                                x0f += 1.f;
-                                norm_flip = 1;
-
-                                *index_ptr++ = triangles + 0; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 2;
-                                *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 2;
-                            }
-                            else {
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 0;
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 1;
-                            }
-
-                            *vertex_ptr++ = packed_vertex_data(x0f, y0f, z0f, norm_flip, 1, 0, 0, 0, height);
-                            *vertex_ptr++ = packed_vertex_data(x0f, y1f, z0f, norm_flip, 1, 0, 0, 0, 0);
-                            *vertex_ptr++ = packed_vertex_data(x0f, y0f, z1f, norm_flip, 1, 0, 0, width, height);
-                            *vertex_ptr++ = packed_vertex_data(x0f, y1f, z1f, norm_flip, 1, 0, 0, width, 0);
-
-                            vertices_jolt.push_back(JPH::Float3(x0f, y0f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x0f, y1f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x0f, y0f, z1f));
-                            vertices_jolt.push_back(JPH::Float3(x0f, y1f, z1f));
-
-                            triangles += 4;
+            const Row row_plus_one = static_cast<Row>((row >> 1) | ((row_plus_one_neighbor & 1) << (ROW_SIZE - 1)));
+            const Row row_minus_one = static_cast<Row>((row << 1) | (row_minus_one_neighbor >> (ROW_SIZE - 1)));
+
+            plus_face = static_cast<Row>(row & ~row_plus_one);
+            minus_face = static_cast<Row>(row & ~row_minus_one);
+        }
+
+        //NOTE: length ones starting at bit begin
+        static Row run_mask(int begin, int length) {
+            const Row ones = length >= static_cast<int>(ROW_SIZE) ? static_cast<Row>(~Row {0}) : static_cast<Row>((Row {1} << length) - 1);
+            return static_cast<Row>(ones << begin);
+        }
+
+        static void emit_quad(PackedQuad*& out, const Quad& quad) {
+            *out++ = pack_quad(quad);
+        }
+
+        //NOTE: consumes the face rows of the slice, out advances past the emitted quads
+        static void greedy_mesh_slice(Row* face, int k, std::size_t slice, PackedQuad*& out)
+        {
+            if (k < 2) {
+                const std::size_t i = slice;
+                for (std::size_t j {0}; j < ROW_SIZE; j++) {
+                    Row& row = face[j + (i * ROW_SIZE)];
+
+                    while (row != 0) {
+                        const int x0 = std::countr_zero(row);
+                        const int height = std::countr_one(static_cast<Row>(row >> x0));
+                        const Row mask = run_mask(x0, height);
+
+                        uint16_t width {1};
+                        row ^= mask;
+
+                        for (std::size_t l = (j + 1); l < ROW_SIZE; l++)
+                        {
+                            if ((mask & face[l + (i * ROW_SIZE)]) != mask)
+                                break;
+
+                            face[l + (i * ROW_SIZE)] ^= mask;
+                            width++;
                         }
+
+                        //NOTE: the top face lies on the far side of the voxel
+                        const uint8_t y0f = static_cast<uint8_t>(k == 0 ? i + 1 : i);
+                        emit_quad(out, Quad {
+                            static_cast<uint8_t>(x0), y0f, static_cast<uint8_t>(j),
+                            static_cast<uint8_t>(k), static_cast<uint8_t>(height), static_cast<uint8_t>(width)
+                        });
                     }
-                    for (int k {4}; k < 6; k++) {
-                        uint16_t& row = arrays[k][index];
-
-                        if (row == 0) continue;
-
-                        while (row != 0) {
-                            uint16_t y0 = std::countr_zero(static_cast<unsigned>(row));
-                            uint16_t height = std::countr_one(static_cast<unsigned>(row >> y0));
-                            uint16_t mask = ((1u << height) - 1) << y0;
-
-                            uint16_t width {1};
-                            row ^= mask;
-
-                            for (std::size_t l = (j + 1); l < size; l++)
-                            {
-                                if ((mask & arrays[k][l + (i * size)]) != mask)
-                                    break;
-
-                                arrays[k][l + (i * size)] ^= mask;
-                                width++;
-                            }
-
-                            std::size_t old_v_size = vertices.size();
-                            std::size_t old_i_size = indices.size();
-                            vertices.resize(old_v_size + 4);
-                            indices.resize(old_i_size + 6);
-
-                            uint32_t* vertex_ptr = vertices.data() + old_v_size;
-                            unsigned int* index_ptr = indices.data() + old_i_size;
-
-                            uint8_t z0f = i;
-                            uint8_t x0f = j;
-                            uint8_t x1f = (j + width);
-                            uint8_t y0f = y0;
-                            uint8_t y1f = (y0 + height);
-
-                            uint8_t norm_flip = 0;
-
-                            if (k == 4) {
-                                z0f += 1.f;
-                                norm_flip = 1;
-
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 0;
-                                *index_ptr++ = triangles + 2; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 1;
-                            }
-                            else {
-                                *index_ptr++ = triangles + 0; *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 2;
-                                *index_ptr++ = triangles + 1; *index_ptr++ = triangles + 3; *index_ptr++ = triangles + 2;
-                            }
-                            *vertex_ptr++ = packed_vertex_data(x0f, y0f, z0f, norm_flip, 0, 0, 1, 0, height);
-                            *vertex_ptr++ = packed_vertex_data(x0f, y1f, z0f, norm_flip, 0, 0, 1, 0, 0);
-                            *vertex_ptr++ = packed_vertex_data(x1f, y0f, z0f, norm_flip, 0, 0, 1, width, height);
-                            *vertex_ptr++ = packed_vertex_data(x1f, y1f, z0f, norm_flip, 0, 0, 1, width, 0);
-
-                            vertices_jolt.push_back(JPH::Float3(x0f, y0f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x0f, y1f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x1f, y0f, z0f));
-                            vertices_jolt.push_back(JPH::Float3(x1f, y1f, z0f));
-
-                            triangles += 4;
+                }
+            }
+            else if (k < 4) {
+                const std::size_t j = slice;
+                for (std::size_t i {0}; i < ROW_SIZE; i++) {
+                    Row& row = face[j + (i * ROW_SIZE)];
+
+                    while (row != 0) {
+                        const int y0 = std::countr_zero(row);
+                        const int height = std::countr_one(static_cast<Row>(row >> y0));
+                        const Row mask = run_mask(y0, height);
+
+                        uint16_t width {1};
+                        row ^= mask;
+
+                        for (std::size_t l = (i + 1); l < ROW_SIZE; l++)
+                        {
+                            if ((mask & face[j + (l * ROW_SIZE)]) != mask)
+                                break;
+
+                            face[j + (l * ROW_SIZE)] ^= mask;
+                            width++;
                         }
+
+                        const uint8_t x0f = static_cast<uint8_t>(k == 2 ? j + 1 : j);
+                        emit_quad(out, Quad {
+                            x0f, static_cast<uint8_t>(y0), static_cast<uint8_t>(i),
+                            static_cast<uint8_t>(k), static_cast<uint8_t>(height), static_cast<uint8_t>(width)
+                        });
                     }
                 }
             }
+            else {
+                const std::size_t i = slice;
+                for (std::size_t j {0}; j < ROW_SIZE; j++) {
+                    Row& row = face[j + (i * ROW_SIZE)];
+
+                    while (row != 0) {
+                        const int y0 = std::countr_zero(row);
+                        const int height = std::countr_one(static_cast<Row>(row >> y0));
+                        const Row mask = run_mask(y0, height);
+
+                        uint16_t width {1};
+                        row ^= mask;
+
+                        for (std::size_t l = (j + 1); l < ROW_SIZE; l++)
+                        {
+                            if ((mask & face[l + (i * ROW_SIZE)]) != mask)
+                                break;
+
+                            face[l + (i * ROW_SIZE)] ^= mask;
+                            width++;
+                        }
 
-            for (auto _idx : indices) {
-                indices_jolt.push_back(_idx);
+                        const uint8_t z0f = static_cast<uint8_t>(k == 4 ? i + 1 : i);
+                        emit_quad(out, Quad {
+                            static_cast<uint8_t>(j), static_cast<uint8_t>(y0), z0f,
+                            static_cast<uint8_t>(k), static_cast<uint8_t>(height), static_cast<uint8_t>(width)
+                        });
+                    }
+                }
             }
-
-            #pragma endregion
-
-            shape = (indices.size() > 0) ? create_mesh_collision_shape(vertices_jolt, indices_jolt) : nullptr;
         }
-
-        Mesh(const std::vector<T>& vertices, const std::vector<unsigned int>& indices) : vertices(vertices), indices(indices) {}
-
-        std::vector<T> vertices;
-        std::vector<unsigned int> indices;
     };
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include <cstdarg>
 #include <queue>
 #include <functional>
+#include <span>
+#include <unordered_map>
 #include <Jolt/Jolt.h>
 #include <Jolt/RegisterTypes.h>
 #include <Jolt/Core/Factory.h>
@@ -16,7 +18,7 @@
 #include <glm/glm.hpp>
 
 #include "core/log.h"
-#include "engine/input.h"
+#include "engine/time.h"
 
 JPH_SUPPRESS_WARNINGS
 
@@ -105,7 +107,8 @@ namespace Voxel::Physics {
         }
     };
 
-    constexpr uint cMaxBodies = { 1024 };
+    //NOTE: one static body per non-empty chunk in range (voxel shapes are cheap), plus the dynamic ones
+    constexpr uint cMaxBodies = { 65536 };
     constexpr uint cNumBodyMutexes = { 0 };
     constexpr uint cMaxBodyPairs = { 1024 };
     constexpr uint cMaxContactConstraints { 1024 };
@@ -124,6 +127,18 @@ namespace Voxel::Physics {
 
         Body* add_body(BodyCreationSettings& settings, unsigned int& slot);
         void remove_body(unsigned int slot);
+        //NOTE: one broadphase insertion for the whole batch (AddBodiesPrepare/AddBodiesFinalize), returns how many were added,
+        //      settings[0, n) got a body and a slot, the body limit cuts the batch short
+        std::size_t add_bodies(std::span<const BodyCreationSettings> settings, std::span<unsigned int> slots);
+        void remove_bodies(std::span<const unsigned int> slots);
+
+        //NOTE: dynamic bodies with a streaming radius pull in the static terrain bodies around them, 0 = none
+        void set_streaming_radius(BodyID id, float radius);
+        //NOTE: center (xyz) and streaming radius (w) of every body that has one
+        void collect_streaming_spheres(std::vector<glm::vec4>& spheres);
+        static float default_streaming_radius;
+        //NOTE: swaps the shape of a static body in place (block edits) and wakes up bodies around it
+        bool set_body_shape(unsigned int slot, const Ref<Shape>& shape);
         bool update();
 
         std::vector<std::function<void()>> physics_subscribers;
@@ -0,0 +1,43 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+
+namespace Voxel {
+    //RING: byte offsets into [0, capacity), handed out in order and released in the same order, batch by batch
+    //NOTE: no gpu involved, the owner closes a batch once its writes are submitted and releases it once the gpu read them
+    //      (UploadRing: one fence per batch)
+    class RingAllocator {
+    public:
+        static constexpr uint32_t INVALID = UINT32_MAX;
+
+        explicit RingAllocator(uint32_t capacity) : capacity(capacity) {}
+
+        //NOTE: INVALID if the unreleased batches are in the way, a range never wraps (the rest of the ring is skipped instead)
+        uint32_t allocate(uint32_t size, uint32_t alignment);
+        //NOTE: everything allocated since the previous call belongs to the returned batch (ids start at 1)
+        uint64_t close_batch();
+        //NOTE: batch and every batch before it were read
+        void release(uint64_t batch);
+        //NOTE: empties the ring with a new capacity, batch ids keep counting (nothing may still be read from the old range)
+        void reset(uint32_t new_capacity);
+
+        uint32_t get_capacity() const { return capacity; }
+        //NOTE: including the skipped ends of the ring and alignment padding
+        uint32_t get_used() const { return used; }
+        std::size_t get_num_batches() const { return batches.size(); }
+
+    private:
+        struct Batch {
+            uint64_t id;
+            uint32_t bytes;
+        };
+
+        uint32_t capacity;
+        uint32_t head {0};
+        uint32_t used {0};
+        //NOTE: bytes of the batch that is still open
+        uint32_t open_bytes {0};
+        uint64_t next_batch {1};
+        std::deque<Batch> batches;
+    };
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include <string>
 #include <string_view>
 #include <memory>
 #include <filesystem>
@@ -16,10 +17,12 @@ namespace Voxel {
         private:
             unsigned int id;
             std::unordered_map<unsigned int, std::string_view> shader_files;
+            //NOTE: inserted right after the #version line of every stage
+            std::string defines;
         public:
             Shader() = default;
 
-            Shader(const std::unordered_map<unsigned int, std::string_view> shader_files);
+            Shader(const std::unordered_map<unsigned int, std::string_view> shader_files, std::string defines = {});
             ~Shader();
 
             Shader& use();
@@ -28,6 +31,8 @@ namespace Voxel {
 
             Shader& set_uniform_mat4(std::string_view name, glm::mat4 matrix);
             Shader& set_uniform_vec3(std::string_view name, glm::vec3 vector);
+            Shader& set_uniform_vec4(std::string_view name, glm::vec4 vector);
+            Shader& set_uniform_ivec2(std::string_view name, glm::ivec2 vector);
             Shader& set_uniform_int(std::string_view name, int value);
 
         private:
@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Voxel {
+    //TLSF: two-level segregated fit over an abstract range [0, capacity) of units (vertices, indices, ...)
+    //  first level : power of two size classes
+    //  second level: SL_COUNT linear subdivisions of each class
+    //NOTE: O(1) allocate/free, no gpu involved, the owner maps offsets onto its buffer
+    class TlsfAllocator {
+    public:
+        static constexpr uint32_t INVALID = UINT32_MAX;
+
+        struct Allocation {
+            uint32_t offset {INVALID};
+            uint32_t size {0};
+            //NOTE: handle for free(), only valid until then
+            uint32_t node {INVALID};
+
+            bool is_valid() const { return node != INVALID; }
+        };
+
+        struct Stats {
+            uint64_t capacity {0};
+            uint64_t used {0};
+            uint64_t free {0};
+            uint64_t largest_free_block {0};
+            uint32_t num_allocations {0};
+            uint32_t num_free_blocks {0};
+
+            //NOTE: 0 = all free space in one block, close to 1 = free space scattered in small blocks
+            float fragmentation() const { return free > 0 ? 1.f - static_cast<float>(largest_free_block) / static_cast<float>(free) : 0.f; }
+        };
+
+        explicit TlsfAllocator(uint32_t capacity);
+
+        //NOTE: invalid allocation if no free block is large enough (grow() and retry)
+        Allocation allocate(uint32_t size);
+        void free(Allocation& allocation);
+        //NOTE: appends [capacity, new_capacity) as free space, existing offsets stay valid
+        void grow(uint32_t new_capacity);
+
+        uint32_t get_capacity() const { return capacity; }
+        //NOTE: from running counters, only the free list of the largest non-empty bucket is walked
+        Stats get_stats() const;
+
+    private:
+        static constexpr uint32_t SL_LOG2 = 4;
+        static constexpr uint32_t SL_COUNT = 1u << SL_LOG2;
+        static constexpr uint32_t FL_COUNT = 32;
+        static constexpr uint32_t NONE = UINT32_MAX;
+
+        struct Block {
+            uint32_t offset {0};
+            uint32_t size {0};
+            uint32_t previous_physical {NONE};
+            uint32_t next_physical {NONE};
+            uint32_t previous_free {NONE};
+            uint32_t next_free {NONE};
+            bool is_free {false};
+        };
+
+        static void mapping(uint32_t size, uint32_t& fl, uint32_t& sl);
+        uint32_t find_free_block(uint32_t size) const;
+        void insert_free_block(uint32_t node);
+        void remove_free_block(uint32_t node);
+        uint32_t create_block(uint32_t offset, uint32_t size);
+        void release_block(uint32_t node);
+        void merge_into_previous(uint32_t node);
+
+        uint32_t capacity {0};
+        uint32_t used {0};
+        uint32_t num_allocations {0};
+        uint32_t num_free_blocks {0};
+        //NOTE: physically last block, grow() extends or follows it
+        uint32_t last_block {NONE};
+
+        uint32_t fl_bitmap {0};
+        std::array<uint32_t, FL_COUNT> sl_bitmaps {};
+        std::array<std::array<uint32_t, SL_COUNT>, FL_COUNT> free_heads;
+
+        std::vector<Block> blocks;
+        std::vector<uint32_t> unused_blocks;
+    };
+}
\ No newline at end of file
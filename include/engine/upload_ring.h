@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+#include <deque>
+#include <glad/glad.h>
+#include "engine/ring_allocator.h"
+
+namespace Voxel {
+    //NOTE: persistently mapped staging buffer, the cpu writes into it and the gpu copies out of it (glCopyBufferSubData),
+    //      one fence per batch of copies tells when its bytes can be written again
+    class UploadRing {
+    public:
+        explicit UploadRing(uint32_t capacity);
+        ~UploadRing();
+
+        UploadRing(const UploadRing&) = delete;
+        UploadRing& operator=(const UploadRing&) = delete;
+
+        //NOTE: nullptr if the bytes of unsignalled batches are in the way (retire() next frame and retry),
+        //      a range larger than the whole ring waits for the gpu and replaces the buffer (a stall, logged as a warning,
+        //      size the ring for the largest range instead)
+        uint8_t* allocate(uint32_t size, uint32_t& offset);
+        //NOTE: fences the copies issued since the previous call, returns their batch (call after issuing them)
+        uint64_t fence();
+        //NOTE: non-blocking, releases every signalled batch and returns the newest one (0 = none so far)
+        uint64_t retire();
+
+        GLuint get_id() const { return id; }
+        uint32_t get_capacity() const { return allocator.get_capacity(); }
+        uint32_t get_used() const { return allocator.get_used(); }
+        std::size_t get_num_fences() const { return fences.size(); }
+
+    private:
+        struct Fence {
+            uint64_t batch;
+            GLsync sync;
+        };
+
+        void create(uint32_t capacity);
+        void destroy();
+
+        RingAllocator allocator;
+        GLuint id {0};
+        uint8_t* mapped {nullptr};
+        std::deque<Fence> fences;
+        uint64_t retired {0};
+    };
+}
\ No newline at end of file
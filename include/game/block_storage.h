@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "game/misc.h"
+
+namespace Voxel::Game {
+    //PALETTE-CONTAINER: one chunk (SIZE_CUBIC blocks, linear index x + y * SIZE + z * SIZE * SIZE)
+    //  palette     : the distinct block types of the chunk
+    //  indices     : 0/1/2/4/8 bits per block into the palette, 0 bits = the whole chunk is palette[0]
+    //NOTE: index widths divide 64, so an index never straddles two words
+    class BlockStorage {
+    public:
+        static constexpr std::size_t NUM_BLOCKS = SIZE_CUBIC;
+
+        uint8_t get(int index) const {
+            if (bits_per_index == 0) return palette[0];
+            const std::size_t bit = static_cast<std::size_t>(index) * bits_per_index;
+            return palette[(indices[bit >> 6] >> (bit & 63)) & ((1u << bits_per_index) - 1)];
+        }
+
+        void set(int index, uint8_t block);
+
+        //NOTE: replaces the whole content from NUM_BLOCKS bytes with the smallest palette that fits
+        void assign(const uint8_t* blocks);
+        void unpack(uint8_t* blocks) const;
+        //NOTE: the layout the block shader reads, 4 blocks per uint (lowest byte first)
+        void write_packed(unsigned int* out) const;
+        //NOTE: same layout, every block of a cell of factor^3 blocks replaced by the cell's highest solid block
+        //      (a reduced mesh's face may lie on an air block of its cell, see Chunk::lod)
+        void write_packed_reduced(unsigned int* out, int factor) const;
+
+        bool is_uniform() const { return bits_per_index == 0; }
+        std::size_t get_palette_size() const { return palette.size(); }
+        uint8_t get_bits_per_index() const { return bits_per_index; }
+        //NOTE: estimate of the heap bytes (by capacity), the container itself is part of its owner
+        std::size_t estimate_memory_usage() const;
+
+    private:
+        void set_index(std::size_t index, unsigned int palette_index);
+        void repack(uint8_t new_bits_per_index);
+
+        std::vector<uint8_t> palette {BlockType::Air};
+        std::vector<uint64_t> indices;
+        uint8_t bits_per_index {0};
+    };
+}
@@ -1,56 +1,153 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <functional>
 #include <memory>
-#include <unordered_map>
+#include <mutex>
+#include <shared_mutex>
 #include <glm/glm.hpp>
 #include <glm/ext/matrix_transform.hpp>
 
-#include "engine/resource_manager.h"
-#include "engine/buffer.h"
 #include "engine/mesh.h"
-#include "engine/buffer_allocator.h"
-#include "engine/gizmo.h"
 #include "engine/physics_manager.h"
 #include "game/noise.h"
+#include "game/block_storage.h"
+#include "game/chunk_registry.h"
+#include "game/chunk_visibility.h"
 #include "game/misc.h"
 
 namespace Voxel {
     namespace Game {
+        //NOTE: one packed uint64_t per quad (QuadMesh::quads), one occupancy row per SIZE voxels
+        using ChunkMesh = QuadMesh<ChunkRow>;
+
+        //NOTE: splitmix64, one per compound seeded from its position (ChunkCompound::seed mixed in), the compound's chunks
+        //      draw from it in a fixed order (trees, diamonds), so a compound comes out the same on whichever worker generates it
+        struct GenerationRandom {
+            uint64_t state;
+
+            uint64_t next() {
+                uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+                z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+                z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+                return z ^ (z >> 31);
+            }
+            //NOTE: [0, bound)
+            int next_int(int bound) { return static_cast<int>(next() % static_cast<uint64_t>(bound)); }
+            //NOTE: [0, 1)
+            float next_float() { return static_cast<float>(next() >> 40) * (1.f / 16777216.f); }
+        };
+
         class Chunk {
         public:
-            static std::shared_ptr<Chunk> create(int* height_map, unsigned int* block_types, std::vector<glm::ivec2>& tree_positions, Noise& noise, glm::ivec3 position);
+            //NOTE: compound_blocks is the compound's generation scratch (one byte per block, chunk after chunk)
+            static std::shared_ptr<Chunk> create(int* height_map, uint8_t* compound_blocks, std::vector<glm::ivec2>& tree_positions, Noise& noise, GenerationRandom& random, glm::ivec3 position, glm::ivec2 height_range);
+            //NOTE: compound_blocks already hold the chunk (loaded from a region file), only the occupancy is rebuilt
+            static std::shared_ptr<Chunk> create(const uint8_t* compound_blocks, glm::ivec3 position);
 
             Chunk() = default;
-            Chunk(int* height_map, unsigned int* block_types, std::vector<glm::ivec2>& tree_positions, Noise& noise, glm::ivec3 position);
+            Chunk(int* height_map, uint8_t* compound_blocks, std::vector<glm::ivec2>& tree_positions, Noise& noise, GenerationRandom& random, glm::ivec3 position, glm::ivec2 height_range);
+            Chunk(const uint8_t* compound_blocks, glm::ivec3 position);
             void build_mesh();
-            void render(Shader& shader);
+            //NOTE: remeshes the dirty slices of an already built chunk (all_slices = full rebuild)
+            void remesh(bool all_slices = false);
 
-            void load();
+            //NOTE: place/break a block in world space, only the touched slices of the chunk and its neighbours are remeshed
+            //NOTE: call from the render thread, the remeshed chunks are staged for the renderer again
+            static bool set_block_world(int x, int y, int z, uint8_t block);
+
+            //NOTE: remeshes a built chunk at the new level (0 = full resolution, n = cells of 2^n voxels, see lod),
+            //      lod stays at the old level while the neighbours are missing (the next set_lod retries)
+            void set_lod(uint8_t level);
+
+            //NOTE: the chunk's compound joined the render set, a built mesh is staged right away, later ones as they are (re)built
+            void enter_render_set();
+            //NOTE: leaves the render set, releases the gpu slot (and a staged mesh) and the physics body
             void unload();
+            //NOTE: the render thread's versions, false (nothing done) while a worker is meshing the chunk (mesh_mutex taken)
+            bool try_enter_render_set();
+            bool try_unload();
+
+            //NOTE: estimate, inline bytes + containers by capacity + the collision shape as jolt reports it (no allocator overhead)
+            std::size_t estimate_memory_usage() const;
 
         private:
             void set_block_type(int index, uint8_t block);
             void set_block_type(int x, int y, int z, uint8_t block);
             uint8_t access_block_type(int x, int y, int z);
             void set_block(int x, int y, int z, uint8_t block);
-            void generate_trees(Noise& noise, int* height_map, std::vector<glm::ivec2>& tree_positions);
-            bool find_neighbours(std::vector<uint16_t*>& neighbours);
+            void set_voxel(int x, int y, int z);
+            void clear_voxel(int x, int y, int z);
+            bool apply_block_edit(int x, int y, int z, uint8_t block);
+            void mark_dirty_slices(int axis, int slice);
+            //NOTE: builds the mesh at level, lod only changes with a built mesh (nothing happens while a horizontal neighbour is missing)
+            void create_mesh(uint8_t level);
+            //NOTE: mesh_mutex and voxels_mutex held
+            void stage_upload();
+            void generate_trees(Noise& noise, GenerationRandom& random, int* height_map, std::vector<glm::ivec2>& tree_positions);
+            void generate_terrain(Noise& noise, GenerationRandom& random, int* height_map, glm::ivec2 height_range);
+            void generate_terrain_full_scan(Noise& noise, GenerationRandom& random, int* height_map);
+            bool find_neighbours(std::vector<ChunkRow*>& neighbours, std::vector<std::shared_lock<std::shared_mutex>>& neighbour_locks);
         public:
             glm::ivec3 position;
-            std::unique_ptr<Mesh<uint32_t>> mesh;
-            std::unique_ptr<SSBO> ssbo;
+            std::unique_ptr<ChunkMesh> mesh;
 
-            uint16_t voxels[SIZE * SIZE * 3] = {};
-            unsigned int* block_types_ptr {nullptr};
+            //NOTE: occupancy rows (x-, z- and y-major), only allocated once the chunk holds a solid block
+            std::unique_ptr<ChunkRow[]> voxels;
+            BlockStorage blocks;
 
             bool is_empty {true};
             bool built {false};
+            //NOTE: level of detail of the mesh (of the first one while unbuilt), n > 0 = meshed from the occupancy OR-reduced to cells of 2^n voxels
+            //      (distant compounds, ChunkManager::lod_distances), physics and visibility keep the full occupancy
+            uint8_t lod {0};
+            //NOTE: between enter_render_set() and unload(), only meshes of chunks in the render set are staged (mesh_mutex)
+            bool in_render_set {false};
+            //NOTE: gpu slot bookkeeping, only touched by the renderer with mesh_mutex held (a headless build never allocates one)
             bool allocated {false};
             unsigned int slot {0};
+            //NOTE: the static body, added/removed by PhysicsStreaming (mesh_mutex held)
             unsigned int slot_physics {0};
             bool affected_by_physics {false};
 
+            //NOTE: VoxelShape over a copy of the occupancy, rebuilt with every (re)mesh, nullptr while the mesh has no quads
             JPH::Ref<JPH::Shape> shape;
 
+            //NOTE: one bit per slice for each face direction of the mesh, consumed by remesh()
+            std::array<std::atomic<uint64_t>, ChunkMesh::NUM_FACE_DIRECTIONS> dirty_slices {};
+            //NOTE: which faces air connects (ChunkVisibility), refreshed with every (re)mesh, unmeshed chunks count as air
+            std::atomic<uint64_t> face_connectivity {ChunkVisibility::ALL_FACES_CONNECTED};
+            //NOTE: edited since the owning compound was last saved
+            std::atomic<bool> modified {false};
+
+            //LOCKING: mesh_mutex serializes (re)meshing and physics updates of this chunk,
+            //         voxels_mutex guards voxels/blocks (shared for meshing, exclusive for edits)
+            std::mutex mesh_mutex;
+            mutable std::shared_mutex voxels_mutex;
+
+            //NOTE: maintained by the ChunkRegistry, only dereference inside a ChunkRegistry::Guard
+            std::array<std::atomic<Chunk*>, NumNeighbours> neighbour_chunks {};
+
+            //NOTE: false = legacy per-voxel scan, only kept to benchmark/verify the column-aware pass against it
+            static bool column_aware_generation;
+
+            //NOTE: installed by the renderer, called with mesh_mutex held: stage copies a new mesh (and the block types) of a chunk
+            //      in the render set (worker threads, set_block_world), release drops a chunk leaving it (staged mesh and gpu slot)
+            static std::function<void(const Chunk& chunk)> stage_render_upload;
+            static std::function<void(Chunk& chunk)> release_render_slot;
+            //NOTE: bumped when a chunk gets a collision shape it did not have or unload() took its body (a body PhysicsStreaming
+            //      may have to add), PhysicsStreaming only diffs its ring again once it moved, remesh swaps or drops the shape of an
+            //      existing body itself
+            static std::atomic<uint64_t> shape_generation;
+
+        private:
+            //NOTE: mesh_mutex held
+            void join_render_set();
+            void leave_render_set();
+
+            //NOTE: only set while generating, writes go to the compound scratch (trees reach into the chunk above)
+            uint8_t* generation_blocks {nullptr};
+
         };
     }
 }
\ No newline at end of file
@@ -1,21 +1,59 @@
 #pragma once
+#include <functional>
+#include <mutex>
 #include <glm/glm.hpp>
 #include "chunk.h"
-#include "engine/camera.h"
+#include "engine/frustum.h"
+#include "engine/job_system.h"
+#include "game/region_storage.h"
 
 namespace Voxel::Game {
     class ChunkCompound {
     public:
         ChunkCompound(Noise& noise, glm::vec3 position);
-        void build_chunk_meshes();
-        void render(Plane* frustum, Shader& shader);
+        ~ChunkCompound();
+        //NOTE: nullptr if the region storage has no (valid) record for this position
+        static std::unique_ptr<ChunkCompound> load(RegionStorage& storage, glm::vec3 position);
+        bool save(RegionStorage& storage);
+        //NOTE: lod = level of detail of every chunk mesh (Chunk::set_lod), built chunks at another level are remeshed
+        void build_chunk_meshes(uint8_t lod = 0);
+        void collect_mesh_jobs(std::vector<JobSystem::Job>& jobs, int priority, uint8_t lod = 0);
+        //NOTE: non-empty chunks inside the frustum
+        void visit_visible_chunks(const Plane* frustum, const std::function<void(Chunk&)>& visit);
+        //NOTE: all non-empty chunks
+        void visit_chunks(const std::function<void(Chunk&)>& visit);
+        //NOTE: all chunks (empty ones too, an edit may give them a mesh), see Chunk::enter_render_set
+        //NOTE: the worker enters, the render thread unloads (ChunkManager::update), both are serialized per compound
+        //      so a compound that left and re-entered between two render set snapshots ends up entered
+        void enter_render_set();
         void unload();
+        //NOTE: the render thread's versions, false if the worker holds the compound or a chunk is being meshed,
+        //      the chunks done so far stay done, call again next frame
+        bool try_enter_render_set();
+        bool try_unload();
+        std::size_t estimate_memory_usage() const;
+
+        //NOTE: writes RegionStorage::NUM_BLOCKS_PER_COMPOUND bytes, chunk after chunk
+        void copy_blocks(uint8_t* out) const;
+
+        //NOTE: world seed, mixed with the compound position into its GenerationRandom (trees, diamonds), the noise is fixed
+        static uint64_t seed;
 
         glm::vec3 position;
+        //NOTE: the level the last build/collect asked for
+        uint8_t lod {0};
+        //NOTE: the stored record matches the current blocks, nothing to write back on eviction
+        bool persisted {false};
 
     private:
+        explicit ChunkCompound(glm::vec3 position) : position(position) {}
+
         int height_map[SIZE * SIZE];
-        unsigned int block_types[(SIZE * (SIZE * NUM_CHUNKS_PER_COMPOUND) * SIZE) / 4] {};
+        //NOTE: x = lowest, y = highest surface of all columns
+        glm::ivec2 height_range;
         std::vector<std::shared_ptr<Chunk>> chunks;
+
+        std::mutex render_set_mutex;
+        bool in_render_set {false};
     };
 }
\ No newline at end of file
@@ -0,0 +1,61 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Voxel::Game {
+    //NOTE: layout glMultiDrawArraysIndirect reads from the draw indirect buffer
+    //NOTE: 6 vertices per quad, gl_VertexID (first included) / 6 is the quad in the quad buffer
+    struct DrawArraysIndirectCommand {
+        uint32_t count;
+        uint32_t instance_count;
+        uint32_t first;
+        uint32_t base_instance;
+    };
+    static_assert(sizeof(DrawArraysIndirectCommand) == 16);
+
+    //NOTE: per-draw data the vertex shader fetches with gl_DrawID (one std430 ivec4)
+    struct ChunkDrawData {
+        glm::ivec3 position;
+        //NOTE: first uint of the chunk's packed block types in the block buffer
+        uint32_t block_offset;
+    };
+    static_assert(sizeof(ChunkDrawData) == 16);
+
+    //NOTE: one entry per gpu slot (num_vertices = 0 for free slots), the culling compute shader turns
+    //      the visible ones into a command + ChunkDrawData (std430 layout of ResidentChunk in cull/comp.glsl)
+    struct ResidentChunk {
+        uint32_t num_vertices;
+        uint32_t first_vertex;
+        uint32_t block_offset;
+        uint32_t unused;
+        glm::ivec3 position;
+        uint32_t padding;
+    };
+    static_assert(sizeof(ResidentChunk) == 32);
+
+    //NOTE: cpu version of what the culling compute shader writes, one command + one ChunkDrawData per visible chunk
+    class ChunkDrawList {
+    public:
+        void clear() {
+            commands.clear();
+            draws.clear();
+        }
+
+        void add(uint32_t num_vertices, uint32_t first_vertex, glm::ivec3 position, uint32_t block_offset) {
+            commands.push_back(DrawArraysIndirectCommand {
+                num_vertices,
+                1,
+                first_vertex,
+                static_cast<uint32_t>(commands.size())
+            });
+            draws.push_back(ChunkDrawData { position, block_offset });
+        }
+
+        std::size_t size() const { return commands.size(); }
+        bool empty() const { return commands.empty(); }
+
+        std::vector<DrawArraysIndirectCommand> commands;
+        std::vector<ChunkDrawData> draws;
+    };
+}
\ No newline at end of file
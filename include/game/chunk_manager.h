@@ -1,6 +1,11 @@
 #pragma once
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
 #include <thread>
 #include <condition_variable>
+#include <functional>
 #include "game/chunk_compound.h"
 #include <unordered_map>
 #include <unordered_set>
@@ -8,21 +13,63 @@
 #include <set>
 #include "core/log.h"
 #include "engine/time.h"
-#include "engine/camera.h"
+#include "engine/frustum.h"
+#include "engine/job_system.h"
 
 namespace Voxel::Game {
     class ChunkManager {
     public:
+        //RENDER-SET: immutable snapshot of the compounds to render, the worker publishes a new one per iteration
+        //            (atomic pointer swap), readers keep theirs alive as long as they need it and never lock
+        struct RenderSet {
+            std::vector<std::shared_ptr<ChunkCompound>> compounds;
+            uint64_t version {0};
+        };
+
         ChunkManager(glm::ivec3 position);
         ~ChunkManager();
-        void update(glm::ivec3 position);
-        void render_chunk_compounds(Plane* frustum, Shader& shader);
+        //NOTE: render thread, once per frame, unloads the compounds that left the render set since the last call (a compound
+        //      with a chunk being meshed is retried on the following frames, never waited for),
+        //      compounds in view_direction are requested before the ones behind the player
+        void update(glm::ivec3 position, glm::vec3 view_direction = glm::vec3(0));
+        //NOTE: visits the non-empty chunks of the current snapshot
+        void visit_chunks(const std::function<void(Chunk&)>& visit);
+        std::shared_ptr<const RenderSet> get_render_set() const;
 
         static void worker_func();
+        //NOTE: level of detail of the compound at (x, z) compounds from the player
+        static uint8_t select_lod(int x, int z);
+
         static int chunk_render_distance;
+        //NOTE: compounds farther than lod_distances[i] * chunk_render_distance are meshed at level i + 1 (Chunk::lod),
+        //      fractions of the render distance so the rings follow it, 0 = ring unused (>= 1 = never reached)
+        static constexpr int MAX_LOD = 3;
+        static std::array<float, MAX_LOD> lod_distances;
         static int num_chunks;
+        //NOTE: 0 = one generation/meshing worker per hardware thread
+        static unsigned int num_worker_threads;
+        //NOTE: region files of visited compounds are stored in <world_directory>/
+        static std::string world_directory;
+
+        //NOTE: compounds outside the render radius are evicted least-recently-used first, 0 = no limit
+        //      (cache_budget_mb applies to the estimate, ChunkCompound::estimate_memory_usage, not to measured allocations)
+        static std::size_t cache_budget_mb;
+        static std::size_t cache_budget_compounds;
+        static std::atomic<std::size_t> cache_estimated_bytes;
+        static std::atomic<std::size_t> num_evicted;
+        //NOTE: compound unloads/enters the render thread put off by a frame because a chunk was being meshed (total)
+        static std::atomic<std::size_t> num_deferred_syncs;
+
+        //NOTE: compounds generated per worker iteration before it looks at the player position again, 0 = two per job worker,
+        //      SIZE_MAX = every missing compound at once (a teleport waits for the whole old request set)
+        static std::size_t compounds_per_wave;
+        //NOTE: requests dropped because the player moved away before they were generated (total)
+        static std::atomic<std::size_t> num_cancelled;
+        //NOTE: requested compounds not generated yet
+        static std::atomic<std::size_t> num_requests_pending;
     private:
         void on_new_chunk_entered(glm::ivec3 chunk_space_position);
+        void sync_render_set();
     private:
     };
 }
\ No newline at end of file
@@ -0,0 +1,106 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Voxel::Game {
+    class Chunk;
+
+    //NOTE: order matches the neighbour order the greedy mesher expects
+    enum ChunkNeighbour : int {
+        NeighbourLeft = 0,      // -x
+        NeighbourRight = 1,     // +x
+        NeighbourFront = 2,     // -z
+        NeighbourBack = 3,      // +z
+        NeighbourBottom = 4,    // -y
+        NeighbourTop = 5,       // +y
+        NumNeighbours = 6
+    };
+
+    //REGISTRY: 64 shards, each an open-addressed table behind a shared_mutex (lookups share it, insert/remove hold it exclusively)
+    //NOTE: neighbour links are plain atomic loads for readers (no lock, no hashing), they are only changed under a shard lock:
+    //      insert links a neighbour while holding that neighbour's shard lock, remove unlinks while holding its own exclusively
+    class ChunkRegistry {
+    public:
+        static ChunkRegistry& get_instance() {
+            static ChunkRegistry instance;
+            return instance;
+        }
+
+        //EPOCH-GUARD: raw chunk pointers (lookups, neighbour links) stay valid while a guard is alive on this thread
+        class Guard {
+        public:
+            Guard();
+            ~Guard();
+            Guard(const Guard&) = delete;
+            Guard& operator=(const Guard&) = delete;
+        };
+
+        //NOTE: publishes the chunk and links it with its (up to) 6 resident neighbours
+        void insert(Chunk* chunk);
+        //NOTE: unpublishes the chunk and unlinks it from its neighbours, memory is released via retire()
+        void remove(Chunk* chunk);
+        Chunk* find(glm::ivec3 position);
+
+        //NOTE: keeps the chunk alive until every guard that could still see it has been released
+        void retire(std::shared_ptr<Chunk> chunk);
+        void collect();
+
+        std::size_t size() const { return num_chunks; }
+        std::size_t num_retired();
+
+        //NOTE: unique key of a chunk origin (21 bits per axis), also used by the maps that follow chunks outside the registry
+        static uint64_t chunk_key(glm::ivec3 position);
+
+        static constexpr int NEIGHBOUR_OFFSETS[NumNeighbours][3] {
+            {-1, 0, 0}, {1, 0, 0}, {0, 0, -1}, {0, 0, 1}, {0, -1, 0}, {0, 1, 0}
+        };
+
+        static int opposite(int neighbour) { return neighbour ^ 1; }
+
+    private:
+        ChunkRegistry() = default;
+
+        static constexpr uint64_t EMPTY_KEY = ~0ull;
+        static constexpr uint64_t TOMBSTONE_KEY = ~0ull - 1;
+        static constexpr std::size_t NUM_SHARDS = 64;
+        static constexpr std::size_t INITIAL_SHARD_CAPACITY = 256;
+
+        struct Slot {
+            uint64_t key {EMPTY_KEY};
+            Chunk* chunk {nullptr};
+        };
+
+        struct Shard {
+            mutable std::shared_mutex mutex;
+            std::vector<Slot> slots;
+            std::size_t size {0};
+            std::size_t tombstones {0};
+        };
+
+        struct Retired {
+            uint64_t epoch;
+            std::shared_ptr<Chunk> chunk;
+        };
+
+        static uint64_t mix(uint64_t key);
+        //NOTE: the caller holds the shard's lock
+        static Chunk* lookup(const Shard& shard, uint64_t key, uint64_t hash);
+
+        Shard& shard_for(uint64_t hash) { return shards[hash >> 58]; }
+        static void rehash(Shard& shard, std::size_t capacity);
+        uint64_t min_active_epoch();
+
+        std::array<Shard, NUM_SHARDS> shards;
+        std::atomic<std::size_t> num_chunks {0};
+
+        std::atomic<uint64_t> global_epoch {1};
+        std::mutex retired_mutex;
+        std::vector<Retired> retired;
+    };
+}
@@ -0,0 +1,172 @@
+#pragma once
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "engine/buffer_arena.h"
+#include "engine/frustum.h"
+#include "engine/gizmo.h"
+#include "engine/hiz_pyramid.h"
+#include "engine/shader.h"
+#include "engine/upload_ring.h"
+#include "game/chunk.h"
+#include "game/chunk_draw_list.h"
+#include "game/chunk_manager.h"
+#include "game/chunk_upload_queue.h"
+
+namespace Voxel::Game {
+    //NOTE: the gl side of the chunks (arena ranges, uploads, draws), chunks themselves stay gl-free
+    //ARENAS: all chunk quads / block types live in two growable buffers, the vertex shader pulls the quads
+    //        (no vertex attributes, no index buffer, an empty vao for all draws)
+    //UPLOADS: workers stage (re)built meshes in a ChunkUploadQueue, update() drains it under upload_budget_kb per frame
+    //         through a fenced UploadRing into the arenas, a chunk's new version is drawn once the fence of its copies signalled
+    //GPU-CULLING: every resident chunk has an entry in a gpu table, a compute shader culls it against the frustum
+    //             (and the previous frame's hi-z pyramid) and compacts the survivors into the multi-draw buffers
+    //NOTE: single phase, nothing is tested again against the current frame's depth, a chunk that was hidden last frame
+    //      and is uncovered this frame (occluder or camera moved) is drawn one frame late
+    //      (chunks outside the previous view or behind its camera are always kept)
+    //CAVE-CULLING: the scene pass only keeps chunks a ChunkVisibility search from the camera's chunk reaches,
+    //              searched again when the camera enters another chunk or the render set changes
+    class ChunkRenderer {
+    public:
+        enum class Pass {
+            Shadow,
+            Scene,
+            NumPasses
+        };
+
+        ChunkRenderer();
+        ~ChunkRenderer();
+
+        ChunkRenderer(const ChunkRenderer&) = delete;
+        ChunkRenderer& operator=(const ChunkRenderer&) = delete;
+
+        //NOTE: once per frame before the passes, releases slots, drains the upload queue and finishes signalled uploads
+        void update();
+        void render(const Plane* frustum, Shader& shader, Pass pass);
+        //NOTE: resolved scene depth of the finished frame, the scene pass of the next frame is occlusion culled against it
+        void update_occlusion(GLuint depth_texture, int width, int height, const glm::mat4& view_projection);
+        void set_camera_position(const glm::vec3& position) { camera_position = position; }
+
+        TlsfAllocator::Stats get_quad_stats() const { return quad_arena->get_stats(); }
+        TlsfAllocator::Stats get_block_stats() const { return block_arena->get_stats(); }
+        std::size_t get_num_slots() const { return allocations.size() - free_slots.size(); }
+        //NOTE: survivors of an earlier frame's cull (read back without a stall, one or more frames late)
+        uint32_t get_num_draws(Pass pass) const { return cull_targets[static_cast<int>(pass)].num_draws; }
+        //NOTE: drawable resident chunks the last cave search did not reach
+        std::size_t get_num_cave_culled() const { return cave_valid ? num_drawable - num_cave_visible : 0; }
+        std::size_t get_num_drawable() const { return num_drawable; }
+
+        struct UploadStats {
+            //NOTE: staged bytes copied into the ring this frame / the most of any frame so far
+            std::size_t frame_bytes {0};
+            std::size_t max_frame_bytes {0};
+            //NOTE: queue depth, staged meshes that wait for a frame with budget left
+            std::size_t num_queued {0};
+            std::size_t queued_bytes {0};
+            //NOTE: copies issued, waiting for their fence
+            std::size_t num_in_flight {0};
+            std::size_t num_uploaded {0};
+            uint32_t ring_used {0};
+            uint32_t ring_capacity {0};
+        };
+        UploadStats get_upload_stats();
+
+        static bool cave_culling;
+        static bool occlusion_culling;
+        //NOTE: reads the scene pass survivors back and compares them with the cpu frustum test (slow, for debugging)
+        static bool verify_culling;
+        static std::size_t num_verified_passes;
+        static std::size_t num_failed_verifications;
+        //NOTE: staged mesh bytes copied per frame, the first mesh of a frame always goes
+        static int upload_budget_kb;
+
+    private:
+        struct ChunkAllocation {
+            TlsfAllocator::Allocation quads;
+            TlsfAllocator::Allocation blocks;
+            uint32_t num_quads {0};
+            //NOTE: bumped when the slot is released, uploads issued before are stale
+            uint32_t ticket {0};
+        };
+
+        //NOTE: copies issued into fresh arena ranges, batch = the ring fence they wait for (0 until fenced)
+        struct PendingUpload {
+            uint64_t batch;
+            unsigned int slot;
+            uint32_t ticket;
+            ChunkAllocation allocation;
+            glm::ivec3 position;
+        };
+
+        //NOTE: ranges no longer drawn, back to the arenas once the fence of batch signalled (0 until fenced)
+        struct RetiredRanges {
+            uint64_t batch;
+            TlsfAllocator::Allocation quads;
+            TlsfAllocator::Allocation blocks;
+        };
+
+        //NOTE: per pass outputs of the cull, the shadow and the scene draws must not share them
+        struct CullTarget {
+            GLuint commands {0};
+            GLuint draws {0};
+            GLuint count {0};
+            uint32_t capacity {0};
+            uint32_t num_draws {0};
+            //NOTE: the count is copied into a mapped buffer behind a fence, read once the fence signalled (never waited for)
+            GLuint readback {0};
+            const uint32_t* readback_mapped {nullptr};
+            GLsync readback_fence {nullptr};
+        };
+
+        //NOTE: false if the ring is full (the mesh goes back to the front of the queue)
+        bool upload(ChunkRegistry& registry, StagedMesh& mesh);
+        void release_slots();
+        void retire_ranges(ChunkAllocation& allocation);
+        void free_retired_ranges(uint64_t retired);
+        void complete_uploads(uint64_t retired);
+        void drain_uploads();
+        void upload_resident_chunks();
+        void update_cave_visibility();
+        void cull(const Plane* frustum, Pass pass);
+        void verify(const Plane* frustum, const CullTarget& target, bool occlusion_applied);
+
+        std::unique_ptr<BufferArena> quad_arena;
+        std::unique_ptr<BufferArena> block_arena;
+        GLuint vertex_array {0};
+
+        ChunkUploadQueue upload_queue;
+        std::unique_ptr<UploadRing> upload_ring;
+        std::deque<PendingUpload> pending_uploads;
+        std::deque<RetiredRanges> retired_ranges;
+        UploadStats upload_stats;
+
+        //NOTE: indexed by Chunk::slot
+        std::vector<ChunkAllocation> allocations;
+        std::vector<unsigned int> free_slots;
+
+        //NOTE: cpu mirror of the gpu table, indexed by Chunk::slot
+        std::vector<ResidentChunk> resident_chunks;
+        GLuint resident_buffer {0};
+        bool resident_dirty {false};
+        //NOTE: bumped whenever an entry of the table changes (uploads completed, slots released)
+        uint64_t resident_generation {0};
+
+        CullTarget cull_targets[static_cast<int>(Pass::NumPasses)];
+
+        //NOTE: one bit per slot, reached by the last cave search
+        std::vector<uint32_t> cave_visible_slots;
+        GLuint cave_buffer {0};
+        glm::vec3 camera_position {0.f};
+        glm::ivec3 cave_start {0};
+        uint64_t cave_generation {UINT64_MAX};
+        bool cave_valid {false};
+        std::size_t num_cave_visible {0};
+        std::size_t num_drawable {0};
+        HiZPyramid hiz;
+
+        //NOTE: slots are handed back from the worker thread, the ranges are freed on the render thread
+        std::mutex released_slots_mutex;
+        std::vector<unsigned int> released_slots;
+    };
+}
\ No newline at end of file
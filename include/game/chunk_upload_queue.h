@@ -0,0 +1,61 @@
+#pragma once
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "game/chunk.h"
+
+namespace Voxel::Game {
+    //NOTE: a chunk's mesh as the gpu reads it, copied out on the thread that (re)meshed the chunk
+    struct StagedMesh {
+        glm::ivec3 position {0};
+        std::vector<ChunkMesh::PackedQuad> quads;
+        //NOTE: NUM_VALUES_IN_ONE_UINT block types per uint (BlockStorage::write_packed)
+        std::vector<unsigned int> blocks;
+
+        std::size_t size_bytes() const { return quads.size() * sizeof(ChunkMesh::PackedQuad) + blocks.size() * sizeof(unsigned int); }
+    };
+
+    //UPLOAD-QUEUE: workers stage finished meshes, the render thread drains them under a per-frame byte budget
+    //NOTE: one entry per chunk, staging a chunk that is still queued replaces its mesh (it keeps its place in the queue)
+    class ChunkUploadQueue {
+    public:
+        struct Stats {
+            //NOTE: queue depth
+            std::size_t num_staged {0};
+            std::size_t staged_bytes {0};
+            //NOTE: totals, replaced = staged again before it was drained
+            std::size_t num_drained {0};
+            std::size_t num_replaced {0};
+            std::size_t num_cancelled {0};
+        };
+
+        //NOTE: any thread, the caller keeps the chunk's mesh and blocks from changing meanwhile (mesh_mutex + voxels_mutex)
+        void stage(const Chunk& chunk);
+        //NOTE: drops the staged mesh of a chunk that left the render set
+        void cancel(glm::ivec3 position);
+
+        //NOTE: hands staged meshes (oldest first) to upload until the next one would exceed budget_bytes, the first one always goes
+        //      (a mesh over the budget still makes progress), upload returns false if it can't take the mesh now (it stays in front),
+        //      returns the bytes handed over, upload runs without the queue locked
+        std::size_t drain(std::size_t budget_bytes, const std::function<bool(StagedMesh& mesh)>& upload);
+        void clear();
+
+        Stats get_stats();
+
+    private:
+        struct Entry {
+            StagedMesh mesh;
+            bool cancelled {false};
+        };
+
+        std::mutex mutex;
+        //NOTE: deque, references to the entries survive pushes/pops at both ends
+        std::deque<Entry> entries;
+        std::unordered_map<uint64_t, Entry*> queued;
+        Stats stats;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdint>
+#include <functional>
+#include "game/chunk_registry.h"
+#include "game/misc.h"
+
+namespace Voxel::Game {
+    class Chunk;
+
+    //NOTE: bit (a * NumNeighbours + b) is set if air connects face a and face b of the chunk (ChunkNeighbour order)
+    namespace ChunkVisibility {
+        constexpr uint64_t ALL_FACES_CONNECTED = (1ull << (NumNeighbours * NumNeighbours)) - 1;
+
+        inline bool are_faces_connected(uint64_t connectivity, int a, int b) {
+            return (connectivity >> (a * NumNeighbours + b)) & 1;
+        }
+
+        //NOTE: voxels are the chunk's occupancy rows, nullptr = all air
+        uint64_t compute_face_connectivity(const ChunkRow* voxels);
+
+        //NOTE: breadth first search from the start chunk through the faces the chunks connect (Tommaso Checchi's cave culling),
+        //      a step never goes against a direction the path already took, max_distance limits it horizontally (blocks)
+        //NOTE: call inside a ChunkRegistry::Guard, visits every reached chunk once (the start chunk included)
+        void find_visible_chunks(Chunk* start, int max_distance, const std::function<void(Chunk&)>& visit);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,117 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include <glm/glm.hpp>
+#include "engine/job_system.h"
+#include "game/noise.h"
+
+namespace Voxel::Game {
+    //FAR-TERRAIN: heightmap-only tiles from the voxel render distance out to far_distance, no blocks, no chunks,
+    //             only Noise::fetch_heightmap samples (what a column's top block would be at that spot)
+    //QUADTREE: the selected tiles are the leaves of a quadtree around the player, a tile splits into 4 while the player
+    //          is closer than split_factor tile sizes, every level doubles the sample spacing (fine near the voxels, coarse at the horizon)
+    //JOBS: update() never samples a tile itself, missing tiles go to the terrain's own job system nearest first
+    //      (at most max_pending_tiles at a time, so a moving player re-prioritises), finished ones are picked up by the next update(),
+    //      generated tiles are cached, the least recently selected are evicted past cache_budget_tiles
+    class FarTerrain {
+    public:
+        //NOTE: RESOLUTION + 1 samples per tile edge, neighbouring tiles of a level share their border samples
+        static constexpr int RESOLUTION = 32;
+        //NOTE: sample spacing of level 0 in blocks, tile size = RESOLUTION * (BASE_SPACING << level)
+        static constexpr int BASE_SPACING = 4;
+        static constexpr int MAX_LEVEL = 6;
+        static constexpr int NUM_SAMPLES = (RESOLUTION + 1) * (RESOLUTION + 1);
+
+        struct Tile {
+            int64_t key {0};
+            //NOTE: world xz of sample (0, 0), sample (x, z) lies at origin + (x, z) * spacing
+            glm::ivec2 origin {0};
+            int level {0};
+            int spacing {0};
+            //NOTE: top face of each column (highest block + 1), x + z * (RESOLUTION + 1)
+            std::vector<float> heights;
+            float min_height {0.f};
+            float max_height {0.f};
+            //NOTE: update() call that last selected the tile (lru stamp)
+            uint64_t last_used {0};
+
+            int size() const { return RESOLUTION * spacing; }
+        };
+
+        struct Stats {
+            //NOTE: leaves around the player / the ones already generated
+            std::size_t num_selected {0};
+            std::size_t num_visible {0};
+            std::size_t num_cached {0};
+            //NOTE: tiles queued or being generated by the workers
+            std::size_t num_pending {0};
+            std::size_t cache_bytes {0};
+            //NOTE: totals
+            std::size_t num_generated {0};
+            std::size_t num_evicted {0};
+            //NOTE: time the workers spent sampling
+            double generation_seconds {0.};
+            //NOTE: the last update() call
+            double update_seconds {0.};
+        };
+
+        FarTerrain();
+
+        //NOTE: render thread, once per frame, inner_distance = the voxel render distance in blocks (tiles entirely inside are skipped)
+        void update(glm::vec3 position, float inner_distance);
+        //NOTE: blocks until the submitted tiles are generated, the next update() picks them up (benches)
+        void wait();
+        //NOTE: the generated tiles of the current selection, valid until the next update()
+        const std::vector<const Tile*>& get_visible_tiles() const { return visible; }
+        //NOTE: bumped whenever the visible tiles change
+        uint64_t get_version() const { return version; }
+        Stats get_stats() const;
+        void clear();
+
+        //NOTE: samples one tile, tile = its coordinates on the grid of its level
+        static Tile generate_tile(Noise& noise, int level, glm::ivec2 tile);
+        static int tile_size(int level) { return RESOLUTION * (BASE_SPACING << level); }
+
+        //NOTE: in blocks, tiles farther away than this are not selected
+        static int far_distance;
+        static float split_factor;
+        static int max_pending_tiles;
+        static std::size_t cache_budget_tiles;
+        //NOTE: read by the constructor, the chunk workers keep the other cores
+        static unsigned int num_worker_threads;
+
+    private:
+        struct Selected {
+            int level;
+            glm::ivec2 tile;
+            int64_t key;
+            float distance;
+        };
+
+        void select(int level, glm::ivec2 tile, glm::vec2 position, float inner_distance);
+        void collect_generated();
+        void evict();
+
+        Noise noise;
+        std::unordered_map<int64_t, Tile> tiles;
+        //NOTE: keys submitted to the workers and not yet collected (render thread only)
+        std::unordered_set<int64_t> pending;
+        std::vector<Selected> selected;
+        std::vector<const Tile*> visible;
+        std::vector<int64_t> visible_keys;
+        uint64_t iteration {0};
+        uint64_t version {0};
+        Stats stats;
+
+        //NOTE: filled by the workers, drained by update()
+        std::mutex generated_mutex;
+        std::vector<Tile> generated;
+        double generated_seconds {0.};
+        //NOTE: last member, destroyed (and its workers joined) before anything a running job writes to
+        std::unique_ptr<JobSystem> job_system;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include "engine/shader.h"
+#include "game/chunk_draw_list.h"
+#include "game/far_terrain.h"
+
+namespace Voxel::Game {
+    //NOTE: the gl side of the FarTerrain, the heights of every visible tile live in one storage buffer (one slot per tile),
+    //      the vertex shader expands a grid of RESOLUTION^2 cells plus a skirt ring per tile (no vertex or index buffer),
+    //      the skirts hang below the tile borders and close the cracks between tiles of different levels
+    //DRAW: every visible tile is one command of a single glMultiDrawArraysIndirect, its origin / spacing / slot are the
+    //      per-draw data the vertex shader fetches with gl_DrawID, both buffers are rebuilt only when the visible tiles change
+    class FarTerrainRenderer {
+    public:
+        FarTerrainRenderer();
+        ~FarTerrainRenderer();
+
+        FarTerrainRenderer(const FarTerrainRenderer&) = delete;
+        FarTerrainRenderer& operator=(const FarTerrainRenderer&) = delete;
+
+        //NOTE: once per frame after FarTerrain::update, uploads the tiles that became visible, frees the slots of the ones that left
+        void update(const FarTerrain& terrain);
+        //NOTE: draws behind everything else (own projection, the caller clears depth afterwards),
+        //      fragments closer than inner_distance to the camera are left to the voxel chunks
+        void render(Shader& shader, const glm::mat4& view_projection, glm::vec3 camera_position, float inner_distance, glm::vec3 light_direction);
+
+        std::size_t get_num_resident() const { return resident.size(); }
+
+    private:
+        void grow(uint32_t new_capacity);
+
+        GLuint vertex_array {0};
+        GLuint height_buffer {0};
+        GLuint command_buffer {0};
+        GLuint draw_buffer {0};
+        GLsizei num_draws {0};
+        uint32_t capacity {0};
+        uint64_t synced_version {UINT64_MAX};
+
+        //NOTE: tile key -> slot in the height buffer
+        std::unordered_map<int64_t, uint32_t> resident;
+        std::vector<uint32_t> free_slots;
+        std::vector<DrawArraysIndirectCommand> commands;
+        //NOTE: xy = world xz of the first sample, z = sample spacing, w = first height of the slot (std430 vec4)
+        std::vector<glm::vec4> draws;
+    };
+}
\ No newline at end of file
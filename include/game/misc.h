@@ -6,6 +6,7 @@ namespace Voxel::Game {
     #define TEXTURE_FRAMEBUFFER_COLOR_ATTACHMENT "texture_framebuffer_color_attachment"
     #define TEXTURE_FRAMEBUFFER_COLOR_ATTACHMENT2 "texture_framebuffer_color_attachment2"
     #define TEXTURE_FRAMEBUFFER_DEPTH_STENCIL_ATTACHMENT "texture_framebuffer_depth_stencil_attachment"
+    #define TEXTURE_FRAMEBUFFER_DEPTH_STENCIL_ATTACHMENT2 "texture_framebuffer_depth_stencil_attachment2"
     #define TEXTURE_FRAMEBUFFER_SHADOW_MAP_ATTACHMENT "texture_framebuffer_shadow_map_attachment"
     #define TEXTURE_FRAMEBUFFER_COLOR_MAP_ATTACHMENT "texture_framebuffer_color_map_attachment"
     #define TEXTURE_SKYBOX_CUBEMAP "texture_skybox_cubemap"
@@ -20,15 +21,34 @@ namespace Voxel::Game {
     #define SHADER_SKYBOX_CUBEMAP "shader_skybox_cubemap"
     #define SHADER_GREEDY_MESH_FOR_SHADOW_PASS "shader_greedy_mesh_shadow_pass"
     #define SHADER_GREEDY_MESH "shader_greedy_mesh"
+    #define SHADER_CHUNK_CULL "shader_chunk_cull"
+    #define SHADER_HIZ_DOWNSAMPLE "shader_hiz_downsample"
+    #define SHADER_FAR_TERRAIN "shader_far_terrain"
 
     //OPTIONS
     #define OPTION_MULTISAMPLING_ENABLED true
 
-    constexpr int SIZE = sizeof(uint16_t) * 8;
+    //CHUNK-SIZE: edge length of a chunk (16, 32 or 64), picked at build time (-DVOXEL_CHUNK_SIZE=N),
+    //            one occupancy row holds one bit per voxel, so the row type follows the size
+    #ifndef VOXEL_CHUNK_SIZE
+    #define VOXEL_CHUNK_SIZE 16
+    #endif
+
+    template <int N> struct ChunkRowType;
+    template <> struct ChunkRowType<16> { using type = uint16_t; };
+    template <> struct ChunkRowType<32> { using type = uint32_t; };
+    template <> struct ChunkRowType<64> { using type = uint64_t; };
+
+    constexpr int SIZE = VOXEL_CHUNK_SIZE;
+    using ChunkRow = ChunkRowType<SIZE>::type;
+    static_assert(sizeof(ChunkRow) * 8 == SIZE, "a chunk row holds one bit per voxel");
+
     constexpr int SIZE_CUBIC = SIZE * SIZE * SIZE;
     constexpr int SIZE_VALUE_IN_BITS = 8;
     constexpr int NUM_VALUES_IN_ONE_UINT = 4;
-    constexpr int NUM_CHUNKS_PER_COMPOUND = 16;
+    //NOTE: the world is WORLD_HEIGHT blocks high for every chunk size
+    constexpr int WORLD_HEIGHT = 256;
+    constexpr int NUM_CHUNKS_PER_COMPOUND = WORLD_HEIGHT / SIZE;
 
     //NOTE: LSB is indicator for MULTI-IMAGE-BLOCK-TYPES
     enum BlockType : uint8_t {
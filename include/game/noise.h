@@ -8,8 +8,28 @@ namespace Voxel {
         Noise();
         float fetch_heightmap(float x, float z);
         float fetch_cave(float x, float y, float z);
+        //NOTE: fetch_heightmap floored, the block height the batched calls produce for a column
+        int column_height(float x, float z);
+
+        //BATCHED: out[x + z * size]
+        void fetch_heightmap_grid(float origin_x, float origin_z, int size, int* out);
+        //BATCHED: out[x + z * size] = the fetch_heightmap_grid value of the column at origin + (x, z) * spacing
+        void fetch_heightmap_samples(float origin_x, float origin_z, int size, int spacing, float* out);
+        //BATCHED: out[x + y * size + z * size * size], only y < column_heights[x + z * size] is written
+        void fetch_cave_columns(float origin_x, float origin_y, float origin_z, int size, const int* column_heights, float* out);
+
+        //SIMD: the batched calls run 8 columns at once with avx2 kernels (FastNoiseLite's float operations in the same order),
+        //      on by default if vectorization_supported(), off = one FastNoiseLite call per sample (the scalar path)
+        bool is_vectorized() const { return vectorized; }
+        //NOTE: ignored without an avx2 build, the bench switches between both paths to compare them
+        void set_vectorized(bool enabled);
+        //NOTE: built with avx2 and the kernels matched FastNoiseLite bit for bit on a probe set (checked once per process)
+        static bool vectorization_supported();
     private:
+        void fetch_heightmap_row(float origin_x, float z, int size, int spacing, int* out);
+
         FastNoiseLite terrain_noise;
         FastNoiseLite biome_noise;
+        bool vectorized {false};
     };
 }
\ No newline at end of file
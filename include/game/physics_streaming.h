@@ -0,0 +1,34 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+namespace Voxel::Game {
+    //NOTE: static chunk bodies only exist within the streaming radius of a dynamic body (PhysicsManager::set_streaming_radius),
+    //      the render set is far larger, bodies come and go in batches (one broadphase insertion/removal per update)
+    namespace PhysicsStreaming {
+        struct Stats {
+            std::size_t num_bodies {0};
+            std::size_t num_added {0};
+            std::size_t num_removed {0};
+            //NOTE: updates that had to diff the ring (a body crossed a chunk border or a chunk got a shape)
+            std::size_t num_rebuilds {0};
+            //NOTE: chunks skipped because a worker was meshing them (mesh_mutex taken), retried by the next update
+            std::size_t num_deferred {0};
+        };
+
+        //NOTE: the ring is decided per chunk a sphere's center is in (it only moves when the center enters another chunk),
+        //      a chunk is in range if its box is within the radius of that chunk's box (every center inside it is covered)
+        bool is_in_range(glm::ivec3 chunk_position, glm::vec4 sphere);
+
+        //NOTE: call once per frame from the thread that steps the physics, cheap while no body crossed a chunk border,
+        //      no chunk got a shape (Chunk::shape_generation) and nothing was deferred since the last call
+        void update();
+        //NOTE: spheres are center (xyz) and radius (w) in world space, update() passes the dynamic bodies
+        void update(const std::vector<glm::vec4>& spheres);
+        //NOTE: removes every streamed body
+        void clear();
+
+        Stats get_stats();
+    }
+}
\ No newline at end of file
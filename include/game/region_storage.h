@@ -0,0 +1,53 @@
+#pragma once
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "game/misc.h"
+
+namespace Voxel::Game {
+    //REGION-FILE-LAYOUT:
+    //  header   : magic, version
+    //  offsets  : REGION_SIZE * REGION_SIZE x { uint32 offset, uint32 size } (size 0 = not stored)
+    //  records  : first fit into the gaps between the live records (or after the last one), a rewritten compound's old record
+    //             stays intact until its table entry points at the new one, the file is cut after the last live record
+    //COMPOUND-RECORD:
+    //  int16 height_map[SIZE * SIZE], uint16 palette size, uint8 palette[], uint32 run count,
+    //  runs { uint16 length - 1, uint8 palette index } over the block bytes in linear order
+    class RegionStorage {
+    public:
+        static constexpr int REGION_SIZE = 32;
+        static_assert(std::has_single_bit(static_cast<unsigned int>(REGION_SIZE)), "compound -> region is a shift");
+        static constexpr int REGION_SHIFT = std::countr_zero(static_cast<unsigned int>(REGION_SIZE));
+        static constexpr std::size_t NUM_BLOCKS_PER_COMPOUND = SIZE * (SIZE * NUM_CHUNKS_PER_COMPOUND) * SIZE;
+
+        explicit RegionStorage(std::filesystem::path directory);
+        ~RegionStorage();
+
+        RegionStorage(const RegionStorage&) = delete;
+        RegionStorage& operator=(const RegionStorage&) = delete;
+
+        //NOTE: blocks are NUM_BLOCKS_PER_COMPOUND bytes, chunk after chunk (bottom to top)
+        //NOTE: thread safe, false if the compound was never stored (or the record is corrupt)
+        bool load_compound(glm::ivec3 position, int* height_map, uint8_t* blocks);
+        bool save_compound(glm::ivec3 position, const int* height_map, const uint8_t* blocks);
+
+        static void encode_compound(const int* height_map, const uint8_t* blocks, std::vector<uint8_t>& out);
+        static bool decode_compound(const uint8_t* data, std::size_t size, int* height_map, uint8_t* blocks);
+
+    private:
+        struct Region;
+
+        std::shared_ptr<Region> open_region(glm::ivec2 region_position);
+        std::filesystem::path region_path(glm::ivec2 region_position) const;
+
+        std::filesystem::path directory;
+        std::mutex regions_mutex;
+        std::unordered_map<int64_t, std::shared_ptr<Region>> regions;
+    };
+}
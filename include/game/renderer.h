@@ -15,8 +15,12 @@
 #include "engine/light.h"
 
 #include "game/chunk_manager.h"
+#include "game/chunk_renderer.h"
+#include "game/far_terrain.h"
+#include "game/far_terrain_renderer.h"
 #include "game/misc.h"
 #include "game/noise.h"
+#include "game/physics_streaming.h"
 
 namespace Voxel::Game {
     class Renderer {
@@ -30,7 +34,10 @@ namespace Voxel::Game {
         void setup_axis_gizmo(VAO& vao);
     private:
         unsigned int width, height;
+        std::unique_ptr<ChunkRenderer> chunk_renderer;
         std::unique_ptr<ChunkManager> chunk_manager;
+        std::unique_ptr<FarTerrain> far_terrain;
+        std::unique_ptr<FarTerrainRenderer> far_terrain_renderer;
         std::unique_ptr<UBO> matrices_ubo;
         Camera* camera;
         Physics::PhysicsManager* physics_manager;
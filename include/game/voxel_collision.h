@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <glm/glm.hpp>
+#include "game/misc.h"
+
+namespace Voxel::Game {
+    //NOTE: collision queries straight on the occupancy rows of a chunk (no jolt dependency, VoxelShape wraps them),
+    //      rows are the x-major block of Chunk::voxels (indexed z + y * SIZE, one bit per x), positions are in chunk space
+    namespace VoxelCollision {
+        //NOTE: voxel index of a (sub shape id / block index), same order as the chunk's blocks
+        inline int voxel_index(int x, int y, int z) {
+            return x + (y * SIZE) + (z * SIZE * SIZE);
+        }
+
+        //NOTE: false outside of the chunk
+        inline bool is_solid(const ChunkRow* rows, int x, int y, int z) {
+            if (x < 0 || y < 0 || z < 0 || x >= SIZE || y >= SIZE || z >= SIZE) return false;
+            return (rows[z + (y * SIZE)] >> x) & 1;
+        }
+
+        //NOTE: the voxels of the neighbouring chunks touching the chunk's faces, SIZE rows per ChunkNeighbour direction
+        //      (-x/+x indexed y with one bit per z, -z/+z indexed y with one bit per x, -y/+y indexed z with one bit per x)
+        using BorderRows = std::array<ChunkRow, 6 * SIZE>;
+
+        //NOTE: neighbours are the Chunk::voxels of the 6 neighbours in ChunkNeighbour order, missing ones are air
+        void copy_borders(const ChunkRow* const* neighbours, BorderRows& borders);
+
+        //NOTE: like is_solid, one voxel across a face of the chunk is looked up in the borders
+        inline bool is_solid(const ChunkRow* rows, const BorderRows& borders, int x, int y, int z) {
+            const bool inside_x = x >= 0 && x < SIZE;
+            const bool inside_y = y >= 0 && y < SIZE;
+            const bool inside_z = z >= 0 && z < SIZE;
+            if (inside_x && inside_y && inside_z) return (rows[z + (y * SIZE)] >> x) & 1;
+            if ((x == -1 || x == SIZE) && inside_y && inside_z) return (borders[(x < 0 ? 0 : SIZE) + y] >> z) & 1;
+            if ((z == -1 || z == SIZE) && inside_x && inside_y) return (borders[(z < 0 ? 2 : 3) * SIZE + y] >> x) & 1;
+            if ((y == -1 || y == SIZE) && inside_x && inside_z) return (borders[(y < 0 ? 4 : 5) * SIZE + z] >> x) & 1;
+            return false;
+        }
+
+        //NOTE: normal pointing out of a solid voxel without the components that point into faces covered by a solid neighbour, normalized,
+        //      if nothing of it is left the normal of the exposed face offset (the contact relative to the voxel's center) lies closest to,
+        //      zero if the voxel has no exposed face
+        glm::vec3 exposed_normal(const ChunkRow* rows, const BorderRows& borders, int x, int y, int z, glm::vec3 normal, glm::vec3 offset);
+
+        //NOTE: bounds of the solid voxels, max is exclusive, false if there are none
+        bool compute_bounds(const ChunkRow* rows, glm::ivec3& min, glm::ivec3& max);
+
+        //NOTE: first solid voxel along origin + fraction * direction, fraction in [0, max_fraction] (3d dda, one step per voxel)
+        //NOTE: a ray starting inside a solid voxel hits at 0 if starts_inside_hit, otherwise it first has to leave the solid
+        bool cast_ray(const ChunkRow* rows, glm::vec3 origin, glm::vec3 direction, float max_fraction, bool starts_inside_hit, float& fraction, int& voxel);
+
+        //NOTE: solid voxels in [min, max] (inclusive, clamped to the chunk) with at least one face not covered by a voxel of the chunk,
+        //      faces on the chunk border count as uncovered (the neighbour is not known), visit returns false to stop
+        void visit_surface_voxels(const ChunkRow* rows, glm::ivec3 min, glm::ivec3 max, const std::function<bool(int x, int y, int z)>& visit);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+#include <array>
+#include <bit>
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+#include "game/misc.h"
+#include "game/voxel_collision.h"
+
+namespace Voxel::Game {
+    //NOTE: static collision shape of a chunk, answers jolt's queries from a copy of the chunk's x-major occupancy rows (VoxelCollision),
+    //      nothing is built besides that copy and the bounds (a MeshShape needed the triangles and a bvh per (re)mesh)
+    //NOTE: convex shapes collide against unit boxes at the surface voxels their bounds overlap, sub shape ids are voxel indices
+    //ACTIVE-FACES: a convex shape sliding over flat ground also touches the edges between the boxes, with
+    //              EActiveEdgeMode::CollideOnlyWithActive (jolt's default) a contact normal leaning into a face covered by a solid
+    //              neighbour (the voxel's own chunk or the border copied from the neighbouring chunk) is turned back to the exposed faces,
+    //              the MeshShape's active edges did the same for the triangles
+    class VoxelShape final : public JPH::Shape {
+    public:
+        static constexpr JPH::uint SUB_SHAPE_ID_BITS = std::bit_width(static_cast<unsigned int>(SIZE_CUBIC - 1));
+
+        //NOTE: rows are the first SIZE * SIZE rows of Chunk::voxels, copied (the physics thread never sees a block edit half done),
+        //      neighbours the Chunk::voxels of the 6 neighbours in ChunkNeighbour order (null = air), only their facing slices are copied
+        VoxelShape(const ChunkRow* rows, const ChunkRow* const* neighbours);
+
+        //NOTE: collide/cast functions of every convex shape against voxel shapes, PhysicsManager calls it once right after JPH::RegisterTypes
+        static void register_collisions();
+
+        const ChunkRow* get_rows() const { return rows.data(); }
+        const VoxelCollision::BorderRows& get_borders() const { return borders; }
+
+        bool MustBeStatic() const override { return true; }
+        JPH::AABox GetLocalBounds() const override { return local_bounds; }
+        JPH::uint GetSubShapeIDBitsRecursive() const override { return SUB_SHAPE_ID_BITS; }
+        float GetInnerRadius() const override { return 0.0f; }
+        JPH::MassProperties GetMassProperties() const override;
+        const JPH::PhysicsMaterial* GetMaterial(const JPH::SubShapeID& sub_shape_id) const override;
+        JPH::Vec3 GetSurfaceNormal(const JPH::SubShapeID& sub_shape_id, JPH::Vec3Arg local_surface_position) const override;
+        void GetSubmergedVolume(
+            JPH::Mat44Arg center_of_mass_transform, JPH::Vec3Arg scale, const JPH::Plane& surface,
+            float& total_volume, float& submerged_volume, JPH::Vec3& center_of_buoyancy
+            JPH_IF_DEBUG_RENDERER(, JPH::RVec3Arg base_offset)
+        ) const override;
+
+        #ifdef JPH_DEBUG_RENDERER
+        void Draw(JPH::DebugRenderer* renderer, JPH::RMat44Arg center_of_mass_transform, JPH::Vec3Arg scale, JPH::ColorArg color, bool use_material_colors, bool draw_wireframe) const override;
+        #endif
+
+        bool CastRay(const JPH::RayCast& ray, const JPH::SubShapeIDCreator& sub_shape_id_creator, JPH::RayCastResult& hit) const override;
+        //NOTE: reports the closest hit only
+        void CastRay(
+            const JPH::RayCast& ray, const JPH::RayCastSettings& settings, const JPH::SubShapeIDCreator& sub_shape_id_creator,
+            JPH::CastRayCollector& collector, const JPH::ShapeFilter& shape_filter = { }
+        ) const override;
+        void CollidePoint(JPH::Vec3Arg point, const JPH::SubShapeIDCreator& sub_shape_id_creator, JPH::CollidePointCollector& collector, const JPH::ShapeFilter& shape_filter = { }) const override;
+        void CollideSoftBodyVertices(
+            JPH::Mat44Arg center_of_mass_transform, JPH::Vec3Arg scale,
+            const JPH::CollideSoftBodyVertexIterator& vertices, JPH::uint num_vertices, int colliding_shape_index
+        ) const override;
+
+        void GetTrianglesStart(GetTrianglesContext& context, const JPH::AABox& box, JPH::Vec3Arg position_com, JPH::QuatArg rotation, JPH::Vec3Arg scale) const override;
+        int GetTrianglesNext(GetTrianglesContext& context, int max_triangles_requested, JPH::Float3* triangle_vertices, const JPH::PhysicsMaterial** materials = nullptr) const override;
+
+        Stats GetStats() const override { return Stats(sizeof(*this), 0); }
+        float GetVolume() const override { return 0.0f; }
+
+    private:
+        std::array<ChunkRow, SIZE * SIZE> rows;
+        VoxelCollision::BorderRows borders;
+        JPH::AABox local_bounds;
+    };
+}
\ No newline at end of file
@@ -23,13 +23,6 @@ namespace Voxel {
         glBufferData(GL_ARRAY_BUFFER, data_size, data, usage);
     }
 
-    void VBO::mapped_data(void* data, size_t data_size)
-    {
-        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-        glBufferStorage(GL_ARRAY_BUFFER, data_size, data, flags);
-        buffer_memory_ptr = (void*)glMapBufferRange(GL_ARRAY_BUFFER, 0, data_size, flags);
-    }
-
     void VBO::sub_data(void* data, size_t data_size) {
         glBufferSubData(GL_ARRAY_BUFFER, 0, data_size, data);
     }
@@ -57,12 +50,6 @@ namespace Voxel {
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, data_size, data, usage);
     }
 
-    void EBO::mapped_data(void* data, size_t data_size) {
-        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
-        glBufferStorage(GL_ELEMENT_ARRAY_BUFFER, data_size, data, flags);
-        buffer_memory_ptr = (void*)glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, 0, data_size, flags);
-    }
-
     void EBO::sub_data(void* data, size_t data_size) {
         glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, data_size, data);
     }
@@ -0,0 +1,69 @@
+#include "engine/buffer_arena.h"
+
+#include <algorithm>
+#include "core/log.h"
+
+namespace Voxel {
+    BufferArena::BufferArena(uint32_t unit_size, uint32_t capacity) : unit_size(unit_size), allocator(capacity) {
+        create(capacity, id);
+    }
+
+    BufferArena::~BufferArena() {
+        glDeleteBuffers(1, &id);
+    }
+
+    void BufferArena::create(uint32_t capacity, GLuint& buffer) {
+        //NOTE: created through the copy target, binding GL_ELEMENT_ARRAY_BUFFER would modify whatever vao is bound
+        //NOTE: no storage flags, the driver is free to keep it in video memory (copies are the only writes)
+        glGenBuffers(1, &buffer);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferStorage(GL_COPY_WRITE_BUFFER, static_cast<GLsizeiptr>(capacity) * unit_size, nullptr, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+
+    void BufferArena::grow(uint32_t min_capacity) {
+        const uint32_t old_capacity = allocator.get_capacity();
+        const uint32_t new_capacity = static_cast<uint32_t>(std::min<uint64_t>(std::max<uint64_t>(uint64_t(old_capacity) * 2, min_capacity), UINT32_MAX));
+
+        GLuint new_id;
+        create(new_capacity, new_id);
+
+        glBindBuffer(GL_COPY_READ_BUFFER, id);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, new_id);
+        glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, static_cast<GLsizeiptr>(old_capacity) * unit_size);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        glDeleteBuffers(1, &id);
+
+        id = new_id;
+        allocator.grow(new_capacity);
+        generation++;
+        plog("buffer arena grown to {:.1f} MB", (static_cast<double>(new_capacity) * unit_size) / 1000000.);
+    }
+
+    TlsfAllocator::Allocation BufferArena::allocate(uint32_t count) {
+        auto allocation = allocator.allocate(count);
+        if (!allocation.is_valid()) {
+            //NOTE: +1/16 covers the good-fit rounding of the request (one second level bucket)
+            grow(allocator.get_capacity() + std::max(count, 1u) + count / 16 + 1);
+            allocation = allocator.allocate(count);
+        }
+        return allocation;
+    }
+
+    void BufferArena::free(TlsfAllocator::Allocation& allocation) {
+        allocator.free(allocation);
+    }
+
+    void BufferArena::copy(GLuint source, std::size_t source_offset, const TlsfAllocator::Allocation& allocation, std::size_t size_bytes) {
+        if (size_bytes == 0) return;
+        glBindBuffer(GL_COPY_READ_BUFFER, source);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, id);
+        glCopyBufferSubData(
+            GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
+            static_cast<GLintptr>(source_offset), static_cast<GLintptr>(allocation.offset) * unit_size, static_cast<GLsizeiptr>(size_bytes)
+        );
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+    }
+}
\ No newline at end of file
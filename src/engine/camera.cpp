@@ -12,12 +12,15 @@ namespace Voxel {
     static Body* body;
 
     Camera::Camera(float width, float height, glm::vec3 position) : Transform(glm::vec3(0), glm::vec3(0), glm::vec3(1)), position(position) {
-        projection = glm::perspective(glm::radians(60.f), width/height, .1f, 1000.f);
+        projection = glm::perspective(glm::radians(fov), width/height, .1f, 1000.f);
 
         unsigned int slot {0};
         BodyCreationSettings settings(new CapsuleShape(.5f, .4f), Vec3(position.x, position.y, position.z), Quat::sIdentity(), EMotionType::Dynamic, PhysicsLayers::MOVING);
         settings.mMotionQuality = EMotionQuality::LinearCast;
-        body = Physics::PhysicsManager::get_instance().add_body(settings, slot);
+        auto& physics_manager = Physics::PhysicsManager::get_instance();
+        body = physics_manager.add_body(settings, slot);
+        //NOTE: the terrain around the camera gets collision (Game::PhysicsStreaming)
+        if (body) physics_manager.set_streaming_radius(body->GetID(), Physics::PhysicsManager::default_streaming_radius);
     }
 
     void Camera::update(float delta_time) {
@@ -96,6 +99,6 @@ namespace Voxel {
     }
 
     void Camera::refactor(float width, float height) {
-        projection = glm::perspective(glm::radians(60.f), width/height, .01f, 1000.f);
+        projection = glm::perspective(glm::radians(fov), width/height, .01f, 1000.f);
     }
 }
@@ -0,0 +1,66 @@
+#include "engine/hiz_pyramid.h"
+
+namespace Voxel {
+    static constexpr int HIZ_GROUP_SIZE = 8;
+
+    HiZPyramid::~HiZPyramid() {
+        if (id) glDeleteTextures(1, &id);
+    }
+
+    void HiZPyramid::create(int width, int height) {
+        if (id) glDeleteTextures(1, &id);
+
+        size = glm::ivec2(width, height);
+        num_levels = 1;
+        for (glm::ivec2 level_size = size; level_size.x > 1 || level_size.y > 1; num_levels++) {
+            level_size = (level_size + 1) / 2;
+        }
+
+        glGenTextures(1, &id);
+        glBindTexture(GL_TEXTURE_2D, id);
+        glTexStorage2D(GL_TEXTURE_2D, num_levels, GL_R32F, width, height);
+        //NOTE: only read with texelFetch, nearest filtering keeps the texture complete
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glBindTexture(GL_TEXTURE_2D, 0);
+    }
+
+    void HiZPyramid::update(Shader& downsample_shader, GLuint depth_texture, int width, int height, const glm::mat4& view_projection) {
+        if (width <= 0 || height <= 0) return;
+        if (!id || size != glm::ivec2(width, height)) create(width, height);
+
+        downsample_shader
+            .use()
+            .set_uniform_int("depth", 0)
+            .set_uniform_int("pyramid", 1);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, depth_texture);
+        glActiveTexture(GL_TEXTURE1);
+        glBindTexture(GL_TEXTURE_2D, id);
+
+        //LEVEL-0: copy of the depth texture, every further level is the max of (up to) 2x2 texels of the previous one
+        glm::ivec2 source_size = size;
+        glm::ivec2 level_size = size;
+        for (int level {0}; level < num_levels; level++) {
+            downsample_shader
+                .set_uniform_int("source_level", level - 1)
+                .set_uniform_ivec2("source_size", source_size)
+                .set_uniform_ivec2("destination_size", level_size);
+            glBindImageTexture(0, id, level, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32F);
+            glDispatchCompute((level_size.x + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, (level_size.y + HIZ_GROUP_SIZE - 1) / HIZ_GROUP_SIZE, 1);
+            glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+            source_size = level_size;
+            level_size = (level_size + 1) / 2;
+        }
+
+        glBindTexture(GL_TEXTURE_2D, 0);
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        this->view_projection = view_projection;
+        valid = true;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,130 @@
+#include "engine/job_system.h"
+
+#include <algorithm>
+
+namespace Voxel {
+    JobSystem::JobSystem(unsigned int num_workers) {
+        num_workers = std::max(1u, num_workers);
+
+        for (unsigned int i {0}; i < num_workers; i++) {
+            queues.push_back(std::make_unique<WorkerQueue>());
+        }
+
+        for (unsigned int i {0}; i < num_workers; i++) {
+            workers.emplace_back(&JobSystem::worker_func, this, i);
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            should_exit = true;
+        }
+        sleep_cv.notify_all();
+
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    void JobSystem::submit(std::function<void()> task, int priority) {
+        std::vector<Job> jobs;
+        jobs.push_back(Job { std::move(task), priority });
+        submit_batch(jobs);
+    }
+
+    void JobSystem::submit_batch(std::vector<Job>& jobs) {
+        if (jobs.empty()) return;
+
+        //NEAREST-FIRST: every queue receives its share in ascending priority order
+        std::stable_sort(jobs.begin(), jobs.end(), [](const Job& a, const Job& b) {
+            return a.priority < b.priority;
+        });
+
+        jobs_pending += static_cast<int>(jobs.size());
+
+        const unsigned int num_queues = static_cast<unsigned int>(queues.size());
+        unsigned int queue_index = next_queue.fetch_add(1) % num_queues;
+        for (auto& job : jobs) {
+            auto& queue = *queues[queue_index];
+            {
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                queue.jobs.push_back(std::move(job));
+            }
+            queue_index = (queue_index + 1) % num_queues;
+        }
+        jobs.clear();
+
+        {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            submit_epoch++;
+        }
+        sleep_cv.notify_all();
+    }
+
+    void JobSystem::wait() {
+        //CALLING-THREAD-HELPS: it owns no queue, so it can only steal
+        const unsigned int external_index = static_cast<unsigned int>(queues.size());
+        Job job;
+        while (steal_job(external_index, job)) {
+            run_job(job);
+        }
+
+        std::unique_lock<std::mutex> lock(sleep_mutex);
+        done_cv.wait(lock, [this] { return jobs_pending == 0; });
+    }
+
+    void JobSystem::worker_func(unsigned int index) {
+        Job job;
+        while (true) {
+            uint64_t epoch_seen;
+            {
+                std::lock_guard<std::mutex> lock(sleep_mutex);
+                if (should_exit) return;
+                epoch_seen = submit_epoch;
+            }
+
+            if (pop_job(index, job) || steal_job(index, job)) {
+                run_job(job);
+                continue;
+            }
+
+            //NOTE: anything submitted after epoch_seen was read bumps the epoch, so no wakeup is lost
+            std::unique_lock<std::mutex> lock(sleep_mutex);
+            sleep_cv.wait(lock, [this, epoch_seen] { return should_exit || submit_epoch != epoch_seen; });
+        }
+    }
+
+    bool JobSystem::pop_job(unsigned int index, Job& job) {
+        auto& queue = *queues[index];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (queue.jobs.empty()) return false;
+        job = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    bool JobSystem::steal_job(unsigned int thief_index, Job& job) {
+        //NOTE: victims are also drained from the front so stolen work keeps its priority order
+        const unsigned int num_queues = static_cast<unsigned int>(queues.size());
+        for (unsigned int i {1}; i <= num_queues; i++) {
+            auto& queue = *queues[(thief_index + i) % num_queues];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) continue;
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+        return false;
+    }
+
+    void JobSystem::run_job(Job& job) {
+        job.task();
+        job.task = nullptr;
+
+        if (--jobs_pending == 0) {
+            std::lock_guard<std::mutex> lock(sleep_mutex);
+            done_cv.notify_all();
+        }
+    }
+}
@@ -1,7 +1,9 @@
 #include "engine/physics_manager.h"
 
 #include "Jolt/Physics/Body/BodyLockMulti.h"
+#include <mutex>
 #include <stack>
+#include "game/voxel_shape.h"
 
 namespace Voxel::Physics {
     void trace_implementation(const char *inFMT, ...) {
@@ -19,6 +21,14 @@ namespace Voxel::Physics {
     }
 
     static std::unordered_map<unsigned int, Body*> bodies_map;
+    static std::mutex bodies_mutex;
+    static unsigned int next_slot {0};
+
+    //NOTE: keyed by BodyID::GetIndexAndSequenceNumber()
+    static std::unordered_map<uint32, float> streaming_radii;
+    static std::mutex streaming_mutex;
+
+    float PhysicsManager::default_streaming_radius {32.f};
 
     PhysicsManager::PhysicsManager() {
         static bool once {false};
@@ -30,6 +40,7 @@ namespace Voxel::Physics {
             Trace = trace_implementation;
             JPH_IF_ENABLE_ASSERTS(AssertFailed = assert_implementation);
             RegisterTypes();
+            Game::VoxelShape::register_collisions();
         }
 
         m_implementation = std::make_unique<implementation>();
@@ -49,6 +60,7 @@ namespace Voxel::Physics {
         BodyCreationSettings sphere_settings(new SphereShape(0.5f), RVec3(20.0_r, 100.0_r, 0.0_r), Quat::sIdentity(), EMotionType::Dynamic, PhysicsLayers::MOVING);
         m_implementation->sphere_id = m_implementation->body_interface_ptr->CreateAndAddBody(sphere_settings, EActivation::Activate);
         m_implementation->body_interface_ptr->SetLinearVelocity(m_implementation->sphere_id, Vec3(0.0f, -1.0f, 0.0f));
+        set_streaming_radius(m_implementation->sphere_id, default_streaming_radius);
 
         m_implementation->physics_system.OptimizeBroadPhase();
     }
@@ -65,16 +77,21 @@ namespace Voxel::Physics {
     }
 
     Body* PhysicsManager::add_body(BodyCreationSettings& settings, unsigned int& slot) {
-        static unsigned int c_slot = 0;
-        slot = c_slot++;
+        std::lock_guard<std::mutex> lock(bodies_mutex);
         auto& body_interface = m_implementation->physics_system.GetBodyInterface();
         Body* body = body_interface.CreateBody(settings);
+        if (!body) {
+            plog_error("failed to create body (limit of {} bodies reached)", cMaxBodies);
+            return nullptr;
+        }
+        slot = next_slot++;
         body_interface.AddBody(body->GetID(), EActivation::DontActivate);
         bodies_map[slot] = body;
         return body;
     }
 
     void PhysicsManager::remove_body(unsigned int slot) {
+        std::lock_guard<std::mutex> lock(bodies_mutex);
         auto body = bodies_map[slot];
         if (!body) return;
         if (body->GetID().IsInvalid()) return;
@@ -84,6 +101,87 @@ namespace Voxel::Physics {
         bodies_map.erase(slot);
     }
 
+    std::size_t PhysicsManager::add_bodies(std::span<const BodyCreationSettings> settings, std::span<unsigned int> slots) {
+        if (settings.empty()) return 0;
+
+        std::lock_guard<std::mutex> lock(bodies_mutex);
+        auto& body_interface = m_implementation->physics_system.GetBodyInterface();
+        std::vector<BodyID> ids;
+        ids.reserve(settings.size());
+        for (std::size_t i {0}; i < settings.size(); i++) {
+            Body* body = body_interface.CreateBody(settings[i]);
+            if (!body) {
+                plog_error("failed to create body (limit of {} bodies reached)", cMaxBodies);
+                break;
+            }
+            slots[i] = next_slot++;
+            bodies_map[slots[i]] = body;
+            ids.push_back(body->GetID());
+        }
+        if (ids.empty()) return 0;
+
+        //NOTE: prepare builds the broadphase tree of the batch without a lock, finalize only links it in
+        const int num_bodies = static_cast<int>(ids.size());
+        BodyInterface::AddState state = body_interface.AddBodiesPrepare(ids.data(), num_bodies);
+        body_interface.AddBodiesFinalize(ids.data(), num_bodies, state, EActivation::DontActivate);
+        return ids.size();
+    }
+
+    void PhysicsManager::remove_bodies(std::span<const unsigned int> slots) {
+        std::lock_guard<std::mutex> lock(bodies_mutex);
+        std::vector<BodyID> ids;
+        ids.reserve(slots.size());
+        for (const unsigned int slot : slots) {
+            auto it = bodies_map.find(slot);
+            if (it == bodies_map.end()) continue;
+            if (it->second && !it->second->GetID().IsInvalid()) ids.push_back(it->second->GetID());
+            bodies_map.erase(it);
+        }
+        if (ids.empty()) return;
+
+        auto& body_interface = m_implementation->physics_system.GetBodyInterface();
+        body_interface.RemoveBodies(ids.data(), static_cast<int>(ids.size()));
+        body_interface.DestroyBodies(ids.data(), static_cast<int>(ids.size()));
+    }
+
+    void PhysicsManager::set_streaming_radius(BodyID id, float radius) {
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+        if (radius > 0.f) streaming_radii[id.GetIndexAndSequenceNumber()] = radius;
+        else streaming_radii.erase(id.GetIndexAndSequenceNumber());
+    }
+
+    void PhysicsManager::collect_streaming_spheres(std::vector<glm::vec4>& spheres) {
+        spheres.clear();
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+        auto& body_interface = m_implementation->physics_system.GetBodyInterface();
+        for (auto it = streaming_radii.begin(); it != streaming_radii.end(); ) {
+            const BodyID id(it->first);
+            //NOTE: a destroyed body drops its radius
+            if (!body_interface.IsAdded(id)) {
+                it = streaming_radii.erase(it);
+                continue;
+            }
+
+            const RVec3 position = body_interface.GetCenterOfMassPosition(id);
+            spheres.emplace_back(position.GetX(), position.GetY(), position.GetZ(), it->second);
+            ++it;
+        }
+    }
+
+    bool PhysicsManager::set_body_shape(unsigned int slot, const Ref<Shape>& shape) {
+        std::lock_guard<std::mutex> lock(bodies_mutex);
+        auto it = bodies_map.find(slot);
+        if (it == bodies_map.end() || !it->second) return false;
+
+        auto& body_interface = m_implementation->physics_system.GetBodyInterface();
+        const BodyID id = it->second->GetID();
+        AABox bounds = it->second->GetWorldSpaceBounds();
+        body_interface.SetShape(id, shape, false, EActivation::DontActivate);
+        bounds.Encapsulate(it->second->GetWorldSpaceBounds());
+        body_interface.ActivateBodiesInAABox(bounds, {}, {});
+        return true;
+    }
+
     bool PhysicsManager::update() {
         static float accumulator {0.f};
         accumulator += Time::delta_time;
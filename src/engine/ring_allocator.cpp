@@ -0,0 +1,43 @@
+#include "engine/ring_allocator.h"
+
+namespace Voxel {
+    uint32_t RingAllocator::allocate(uint32_t size, uint32_t alignment) {
+        if (size > capacity) return INVALID;
+        //NOTE: nothing in flight, start over (a large range then never has to skip the end)
+        if (used == 0) head = 0;
+
+        //NOTE: the free space is contiguous from head around to the oldest batch, padding and skipped bytes are taken from it too
+        uint64_t start = (static_cast<uint64_t>(head) + alignment - 1) / alignment * alignment;
+        if (start + size > capacity) start = capacity;
+        const uint64_t skipped = start - head;
+        if (start == capacity) start = 0;
+
+        const uint64_t needed = skipped + size;
+        if (used + needed > capacity) return INVALID;
+
+        head = static_cast<uint32_t>((start + size) % capacity);
+        used += static_cast<uint32_t>(needed);
+        open_bytes += static_cast<uint32_t>(needed);
+        return static_cast<uint32_t>(start);
+    }
+
+    uint64_t RingAllocator::close_batch() {
+        batches.push_back(Batch { next_batch, open_bytes });
+        open_bytes = 0;
+        return next_batch++;
+    }
+
+    void RingAllocator::release(uint64_t batch) {
+        while (!batches.empty() && batches.front().id <= batch) {
+            used -= batches.front().bytes;
+            batches.pop_front();
+        }
+    }
+    void RingAllocator::reset(uint32_t new_capacity) {
+        capacity = new_capacity;
+        head = 0;
+        used = 0;
+        open_bytes = 0;
+        batches.clear();
+    }
+}
\ No newline at end of file
@@ -31,6 +31,10 @@ namespace Voxel {
                 ShaderStream << shader_file.rdbuf();
                 shader_file.close();
                 shader_source_str = ShaderStream.str();
+                if (!defines.empty()) {
+                    const std::size_t version_end = shader_source_str.find('\n');
+                    shader_source_str.insert(version_end == std::string::npos ? shader_source_str.size() : version_end + 1, defines);
+                }
 
                 const char *shader_source = shader_source_str.c_str();
 
@@ -62,7 +66,7 @@ namespace Voxel {
         }
     }
 
-    Shader::Shader(const std::unordered_map<unsigned int, std::string_view> files) : shader_files(files) {
+    Shader::Shader(const std::unordered_map<unsigned int, std::string_view> files, std::string defines) : shader_files(files), defines(std::move(defines)) {
         load();
     }
 
@@ -99,6 +103,18 @@ namespace Voxel {
         return *this;
     }
 
+    Shader& Shader::set_uniform_vec4(std::string_view name, glm::vec4 vector) {
+        int location = glGetUniformLocation(id, name.data());
+        glUniform4fv(location, 1, &vector[0]);
+        return *this;
+    }
+
+    Shader& Shader::set_uniform_ivec2(std::string_view name, glm::ivec2 vector) {
+        int location = glGetUniformLocation(id, name.data());
+        glUniform2iv(location, 1, &vector[0]);
+        return *this;
+    }
+
     Shader& Shader::set_uniform_int(std::string_view name, int value) {
         int location = glGetUniformLocation(id, name.data());
         glUniform1i(location, value);
@@ -0,0 +1,200 @@
+#include "engine/tlsf_allocator.h"
+
+#include <algorithm>
+#include <bit>
+
+namespace Voxel {
+    TlsfAllocator::TlsfAllocator(uint32_t capacity) {
+        for (auto& heads : free_heads) heads.fill(NONE);
+        grow(capacity);
+    }
+
+    void TlsfAllocator::mapping(uint32_t size, uint32_t& fl, uint32_t& sl) {
+        //NOTE: sizes below SL_COUNT get exact buckets in the first class
+        if (size < SL_COUNT) {
+            fl = 0;
+            sl = size;
+            return;
+        }
+
+        const uint32_t f = static_cast<uint32_t>(std::bit_width(size)) - 1;
+        sl = (size >> (f - SL_LOG2)) ^ SL_COUNT;
+        fl = f - SL_LOG2 + 1;
+    }
+
+    uint32_t TlsfAllocator::find_free_block(uint32_t size) const {
+        //NOTE: round up to the next bucket, every block found there is large enough (good fit, not best fit)
+        uint64_t rounded = size;
+        if (size >= SL_COUNT) rounded += (1ull << (std::bit_width(size) - 1 - SL_LOG2)) - 1;
+        if (rounded > UINT32_MAX) return NONE;
+
+        uint32_t fl, sl;
+        mapping(static_cast<uint32_t>(rounded), fl, sl);
+
+        uint32_t sl_map = sl_bitmaps[fl] & (~0u << sl);
+        if (!sl_map) {
+            const uint32_t fl_map = fl + 1 < FL_COUNT ? fl_bitmap & (~0u << (fl + 1)) : 0;
+            if (!fl_map) return NONE;
+            fl = static_cast<uint32_t>(std::countr_zero(fl_map));
+            sl_map = sl_bitmaps[fl];
+        }
+        sl = static_cast<uint32_t>(std::countr_zero(sl_map));
+        return free_heads[fl][sl];
+    }
+
+    void TlsfAllocator::insert_free_block(uint32_t node) {
+        uint32_t fl, sl;
+        mapping(blocks[node].size, fl, sl);
+
+        const uint32_t head = free_heads[fl][sl];
+        blocks[node].previous_free = NONE;
+        blocks[node].next_free = head;
+        if (head != NONE) blocks[head].previous_free = node;
+        free_heads[fl][sl] = node;
+
+        fl_bitmap |= 1u << fl;
+        sl_bitmaps[fl] |= 1u << sl;
+        num_free_blocks++;
+    }
+
+    void TlsfAllocator::remove_free_block(uint32_t node) {
+        uint32_t fl, sl;
+        mapping(blocks[node].size, fl, sl);
+
+        const Block& block = blocks[node];
+        if (block.previous_free != NONE) blocks[block.previous_free].next_free = block.next_free;
+        else free_heads[fl][sl] = block.next_free;
+        if (block.next_free != NONE) blocks[block.next_free].previous_free = block.previous_free;
+
+        if (free_heads[fl][sl] == NONE) {
+            sl_bitmaps[fl] &= ~(1u << sl);
+            if (!sl_bitmaps[fl]) fl_bitmap &= ~(1u << fl);
+        }
+        num_free_blocks--;
+    }
+
+    uint32_t TlsfAllocator::create_block(uint32_t offset, uint32_t size) {
+        uint32_t node;
+        if (!unused_blocks.empty()) {
+            node = unused_blocks.back();
+            unused_blocks.pop_back();
+        }
+        else {
+            node = static_cast<uint32_t>(blocks.size());
+            blocks.emplace_back();
+        }
+
+        blocks[node] = Block { .offset = offset, .size = size };
+        return node;
+    }
+
+    void TlsfAllocator::release_block(uint32_t node) {
+        unused_blocks.push_back(node);
+    }
+
+    void TlsfAllocator::merge_into_previous(uint32_t node) {
+        const uint32_t previous = blocks[node].previous_physical;
+        const uint32_t next = blocks[node].next_physical;
+
+        blocks[previous].size += blocks[node].size;
+        blocks[previous].next_physical = next;
+        if (next != NONE) blocks[next].previous_physical = previous;
+        else last_block = previous;
+
+        release_block(node);
+    }
+
+    TlsfAllocator::Allocation TlsfAllocator::allocate(uint32_t size) {
+        size = std::max(size, 1u);
+        const uint32_t node = find_free_block(size);
+        if (node == NONE) return {};
+
+        remove_free_block(node);
+
+        //SPLIT: the tail goes back into the free lists
+        if (blocks[node].size > size) {
+            const uint32_t remainder = create_block(blocks[node].offset + size, blocks[node].size - size);
+            const uint32_t next = blocks[node].next_physical;
+
+            blocks[remainder].previous_physical = node;
+            blocks[remainder].next_physical = next;
+            blocks[remainder].is_free = true;
+            if (next != NONE) blocks[next].previous_physical = remainder;
+            else last_block = remainder;
+
+            blocks[node].next_physical = remainder;
+            blocks[node].size = size;
+            insert_free_block(remainder);
+        }
+
+        blocks[node].is_free = false;
+        used += size;
+        num_allocations++;
+        return Allocation { blocks[node].offset, size, node };
+    }
+
+    void TlsfAllocator::free(Allocation& allocation) {
+        if (!allocation.is_valid()) return;
+
+        uint32_t node = allocation.node;
+        blocks[node].is_free = true;
+        used -= blocks[node].size;
+        num_allocations--;
+
+        //COALESCE: with the physical neighbours, free blocks are never adjacent
+        const uint32_t next = blocks[node].next_physical;
+        if (next != NONE && blocks[next].is_free) {
+            remove_free_block(next);
+            merge_into_previous(next);
+        }
+
+        const uint32_t previous = blocks[node].previous_physical;
+        if (previous != NONE && blocks[previous].is_free) {
+            remove_free_block(previous);
+            merge_into_previous(node);
+            node = previous;
+        }
+
+        insert_free_block(node);
+        allocation = {};
+    }
+
+    void TlsfAllocator::grow(uint32_t new_capacity) {
+        if (new_capacity <= capacity) return;
+        const uint32_t extra = new_capacity - capacity;
+
+        if (last_block != NONE && blocks[last_block].is_free) {
+            remove_free_block(last_block);
+            blocks[last_block].size += extra;
+            insert_free_block(last_block);
+        }
+        else {
+            const uint32_t node = create_block(capacity, extra);
+            blocks[node].previous_physical = last_block;
+            blocks[node].is_free = true;
+            if (last_block != NONE) blocks[last_block].next_physical = node;
+            last_block = node;
+            insert_free_block(node);
+        }
+
+        capacity = new_capacity;
+    }
+
+    TlsfAllocator::Stats TlsfAllocator::get_stats() const {
+        Stats stats;
+        stats.capacity = capacity;
+        stats.used = used;
+        stats.free = capacity - used;
+        stats.num_allocations = num_allocations;
+        stats.num_free_blocks = num_free_blocks;
+        if (!fl_bitmap) return stats;
+
+        //NOTE: the largest free block sits in the highest non-empty bucket (its blocks differ by less than a bucket width)
+        const uint32_t fl = static_cast<uint32_t>(std::bit_width(fl_bitmap)) - 1;
+        const uint32_t sl = static_cast<uint32_t>(std::bit_width(sl_bitmaps[fl])) - 1;
+        for (uint32_t node = free_heads[fl][sl]; node != NONE; node = blocks[node].next_free) {
+            stats.largest_free_block = std::max<uint64_t>(stats.largest_free_block, blocks[node].size);
+        }
+        return stats;
+    }
+}
\ No newline at end of file
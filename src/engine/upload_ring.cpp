@@ -0,0 +1,84 @@
+#include "engine/upload_ring.h"
+
+#include <algorithm>
+#include <chrono>
+#include "core/log.h"
+
+namespace Voxel {
+    static constexpr GLbitfield RING_STORAGE_FLAGS = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    //NOTE: the largest element type copied through the ring (PackedQuad)
+    static constexpr uint32_t RING_ALIGNMENT = 16;
+
+    UploadRing::UploadRing(uint32_t capacity) : allocator(capacity) {
+        create(capacity);
+    }
+
+    UploadRing::~UploadRing() {
+        for (auto& fence : fences) glDeleteSync(fence.sync);
+        destroy();
+    }
+
+    void UploadRing::create(uint32_t capacity) {
+        glGenBuffers(1, &id);
+        glBindBuffer(GL_COPY_READ_BUFFER, id);
+        glBufferStorage(GL_COPY_READ_BUFFER, capacity, nullptr, RING_STORAGE_FLAGS);
+        mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_READ_BUFFER, 0, capacity, RING_STORAGE_FLAGS));
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+    }
+
+    void UploadRing::destroy() {
+        glBindBuffer(GL_COPY_READ_BUFFER, id);
+        glUnmapBuffer(GL_COPY_READ_BUFFER);
+        glBindBuffer(GL_COPY_READ_BUFFER, 0);
+        glDeleteBuffers(1, &id);
+        id = 0;
+        mapped = nullptr;
+    }
+
+    uint8_t* UploadRing::allocate(uint32_t size, uint32_t& offset) {
+        if (size > allocator.get_capacity()) {
+            //GROW: a range larger than the ring (never a chunk mesh, see MAX_STAGED_MESH_BYTES), every fenced copy out of the old
+            //      buffer has to finish first
+            //NOTE: copies of the open batch are already issued, the old buffer lives on until they ran (deleted gl objects in use do)
+            const auto start = std::chrono::steady_clock::now();
+            const std::size_t num_waited = fences.size();
+            for (auto& fence : fences) {
+                glClientWaitSync(fence.sync, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_MAX);
+                glDeleteSync(fence.sync);
+                retired = fence.batch;
+            }
+            fences.clear();
+            destroy();
+
+            const uint32_t capacity = std::max(size, allocator.get_capacity() * 2);
+            allocator.reset(capacity);
+            create(capacity);
+            const double waited_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+            plog_warn("upload ring grown to {:.1f} MB for a {:.1f} MB range, waited {:.2f} ms on {} fences", capacity / 1000000., size / 1000000., waited_ms, num_waited);
+        }
+
+        offset = allocator.allocate(size, RING_ALIGNMENT);
+        if (offset == RingAllocator::INVALID) return nullptr;
+        return mapped + offset;
+    }
+
+    uint64_t UploadRing::fence() {
+        const uint64_t batch = allocator.close_batch();
+        fences.push_back(Fence { batch, glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0) });
+        return batch;
+    }
+
+    uint64_t UploadRing::retire() {
+        while (!fences.empty()) {
+            //NOTE: timeout 0 only polls, the fences signal in order
+            const GLenum result = glClientWaitSync(fences.front().sync, 0, 0);
+            if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED) break;
+
+            glDeleteSync(fences.front().sync);
+            retired = fences.front().batch;
+            fences.pop_front();
+        }
+        allocator.release(retired);
+        return retired;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,152 @@
+#include "game/block_storage.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+
+namespace Voxel::Game {
+    static uint8_t bits_for_palette_size(std::size_t palette_size) {
+        if (palette_size <= 1) return 0;
+        if (palette_size <= 2) return 1;
+        if (palette_size <= 4) return 2;
+        if (palette_size <= 16) return 4;
+        return 8;
+    }
+
+    void BlockStorage::set_index(std::size_t index, unsigned int palette_index) {
+        const std::size_t bit = index * bits_per_index;
+        const uint64_t mask = ((1ull << bits_per_index) - 1) << (bit & 63);
+        uint64_t& word = indices[bit >> 6];
+        word = (word & ~mask) | (static_cast<uint64_t>(palette_index) << (bit & 63));
+    }
+
+    void BlockStorage::repack(uint8_t new_bits_per_index) {
+        std::vector<uint64_t> old_indices = std::move(indices);
+        const uint8_t old_bits_per_index = bits_per_index;
+
+        bits_per_index = new_bits_per_index;
+        indices.assign((NUM_BLOCKS * bits_per_index) / 64, 0);
+        if (old_bits_per_index == 0) return;
+
+        const uint64_t old_mask = (1ull << old_bits_per_index) - 1;
+        for (std::size_t i {0}; i < NUM_BLOCKS; i++) {
+            const std::size_t bit = i * old_bits_per_index;
+            set_index(i, static_cast<unsigned int>((old_indices[bit >> 6] >> (bit & 63)) & old_mask));
+        }
+    }
+
+    void BlockStorage::set(int index, uint8_t block) {
+        auto it = std::find(palette.begin(), palette.end(), block);
+        if (bits_per_index == 0 && it == palette.begin()) return;
+
+        //NOTE: palette entries are never dropped on a single write, assign() rebuilds a minimal palette
+        if (it == palette.end()) {
+            if (palette.size() == (1u << bits_per_index)) repack(bits_per_index == 0 ? 1 : bits_per_index * 2);
+            palette.push_back(block);
+            it = palette.end() - 1;
+        }
+
+        set_index(static_cast<std::size_t>(index), static_cast<unsigned int>(it - palette.begin()));
+    }
+
+    void BlockStorage::assign(const uint8_t* blocks) {
+        //PALETTE: block types in order of first appearance
+        std::array<int16_t, 256> palette_index;
+        palette_index.fill(-1);
+        palette.clear();
+        for (std::size_t i {0}; i < NUM_BLOCKS; i++) {
+            if (palette_index[blocks[i]] >= 0) continue;
+            palette_index[blocks[i]] = static_cast<int16_t>(palette.size());
+            palette.push_back(blocks[i]);
+        }
+        palette.shrink_to_fit();
+
+        bits_per_index = bits_for_palette_size(palette.size());
+        indices.assign((NUM_BLOCKS * bits_per_index) / 64, 0);
+        indices.shrink_to_fit();
+        if (bits_per_index == 0) return;
+
+        const std::size_t indices_per_word = 64 / bits_per_index;
+        for (std::size_t word {0}; word < indices.size(); word++) {
+            uint64_t packed {0};
+            for (std::size_t i {0}; i < indices_per_word; i++) {
+                packed |= static_cast<uint64_t>(palette_index[blocks[word * indices_per_word + i]]) << (i * bits_per_index);
+            }
+            indices[word] = packed;
+        }
+    }
+
+    void BlockStorage::unpack(uint8_t* blocks) const {
+        if (bits_per_index == 0) {
+            std::memset(blocks, palette[0], NUM_BLOCKS);
+            return;
+        }
+
+        const std::size_t indices_per_word = 64 / bits_per_index;
+        const uint64_t mask = (1ull << bits_per_index) - 1;
+        for (std::size_t word {0}; word < indices.size(); word++) {
+            const uint64_t packed = indices[word];
+            for (std::size_t i {0}; i < indices_per_word; i++) {
+                blocks[word * indices_per_word + i] = palette[(packed >> (i * bits_per_index)) & mask];
+            }
+        }
+    }
+
+    void BlockStorage::write_packed(unsigned int* out) const {
+        if (bits_per_index == 0) {
+            const unsigned int block = palette[0];
+            std::fill(out, out + (NUM_BLOCKS / NUM_VALUES_IN_ONE_UINT), block | (block << 8) | (block << 16) | (block << 24));
+            return;
+        }
+
+        for (std::size_t i {0}; i < NUM_BLOCKS / NUM_VALUES_IN_ONE_UINT; i++) {
+            unsigned int area {0};
+            for (int j {0}; j < NUM_VALUES_IN_ONE_UINT; j++) {
+                area |= static_cast<unsigned int>(get(static_cast<int>(i * NUM_VALUES_IN_ONE_UINT + j))) << (j * SIZE_VALUE_IN_BITS);
+            }
+            out[i] = area;
+        }
+    }
+
+    void BlockStorage::write_packed_reduced(unsigned int* out, int factor) const {
+        if (bits_per_index == 0) {
+            write_packed(out);
+            return;
+        }
+
+        static thread_local std::vector<uint8_t> blocks(NUM_BLOCKS);
+        unpack(blocks.data());
+
+        for (int z {0}; z < SIZE; z += factor) {
+            for (int x {0}; x < SIZE; x += factor) {
+                for (int y {0}; y < SIZE; y += factor) {
+                    //NOTE: top down, the surface block shows on the cell's faces
+                    uint8_t block {BlockType::Air};
+                    for (int cy = y + factor - 1; cy >= y && block == BlockType::Air; cy--) {
+                        for (int cz {z}; cz < z + factor && block == BlockType::Air; cz++) {
+                            for (int cx {x}; cx < x + factor && block == BlockType::Air; cx++) block = blocks[cx + cy * SIZE + cz * SIZE * SIZE];
+                        }
+                    }
+
+                    for (int cz {z}; cz < z + factor; cz++) {
+                        for (int cy {y}; cy < y + factor; cy++) {
+                            std::fill_n(&blocks[x + cy * SIZE + cz * SIZE * SIZE], factor, block);
+                        }
+                    }
+                }
+            }
+        }
+
+        for (std::size_t i {0}; i < NUM_BLOCKS / NUM_VALUES_IN_ONE_UINT; i++) {
+            unsigned int area {0};
+            for (int j {0}; j < NUM_VALUES_IN_ONE_UINT; j++) {
+                area |= static_cast<unsigned int>(blocks[i * NUM_VALUES_IN_ONE_UINT + j]) << (j * SIZE_VALUE_IN_BITS);
+            }
+            out[i] = area;
+        }
+    }
+
+    std::size_t BlockStorage::estimate_memory_usage() const {
+        return palette.capacity() * sizeof(uint8_t) + indices.capacity() * sizeof(uint64_t);
+    }
+}
@@ -1,42 +1,140 @@
 #include "game/chunk.h"
 
+#include <algorithm>
+#include "game/voxel_shape.h"
+
 namespace Voxel::Game {
-    struct ChunkPos {
-        int32_t x, y, z;
-
-        bool operator<(const ChunkPos& other) const {
-            if (x != other.x) return x < other.x;
-            if (y != other.y) return y < other.y;
-            return z < other.z;
-        }
-
-        bool operator==(const ChunkPos& other) const {
-            return x == other.x && y == other.y && z == other.z;
-        }
-    };
-    struct ChunkPosHash {
-        std::size_t operator()(const ChunkPos& pos) const {
-            return std::hash<int32_t>()(pos.x) ^
-                   (std::hash<int32_t>()(pos.y) << 1) ^
-                   (std::hash<int32_t>()(pos.z) << 2);
-        }
-    };
-    static std::unordered_map<ChunkPos, std::shared_ptr<Chunk>, ChunkPosHash> chunks;
-    std::shared_ptr<Chunk> Chunk::create(int* height_map, unsigned int* block_types, std::vector<glm::ivec2>& tree_positions, Noise& noise, glm::ivec3 position) {
-        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(height_map, block_types, tree_positions, noise, position);
-        chunks[ChunkPos {position.x, position.y, position.z}] = chunk;
+    std::shared_ptr<Chunk> Chunk::create(int* height_map, uint8_t* compound_blocks, std::vector<glm::ivec2>& tree_positions, Noise& noise, GenerationRandom& random, glm::ivec3 position, glm::ivec2 height_range) {
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(height_map, compound_blocks, tree_positions, noise, random, position, height_range);
+        ChunkRegistry::get_instance().insert(chunk.get());
         return chunk;
     }
 
+    std::shared_ptr<Chunk> Chunk::create(const uint8_t* compound_blocks, glm::ivec3 position) {
+        std::shared_ptr<Chunk> chunk = std::make_shared<Chunk>(compound_blocks, position);
+        ChunkRegistry::get_instance().insert(chunk.get());
+        return chunk;
+    }
+
+    bool Chunk::column_aware_generation {true};
+    std::function<void(const Chunk& chunk)> Chunk::stage_render_upload;
+    std::function<void(Chunk& chunk)> Chunk::release_render_slot;
+    std::atomic<uint64_t> Chunk::shape_generation {0};
+
+    //NOTE: cave_values is only dereferenced for voxels at or below the surface (the only ones that were sampled)
+    static uint8_t terrain_block_type(int world_space_position_y, int noise_value, const float* cave_value, GenerationRandom& random) {
+        if (world_space_position_y == 0) return BlockType::Bedrock;
+        if (world_space_position_y == noise_value) {
+            if (world_space_position_y > 128) return BlockType::Snow;
+            if (world_space_position_y > 96) return BlockType::Stone;
+            if (*cave_value < .7f) return BlockType::Grass;
+        }
+        else if (world_space_position_y < noise_value) {
+            if (*cave_value < .7f) {
+                if (world_space_position_y > noise_value - 2) return BlockType::Dirt;
+                if (world_space_position_y < 20 && random.next_float() < .01f) return BlockType::Diamond;
+                return BlockType::Stone;
+            }
+        }
+        return BlockType::Air;
+    }
 
     Chunk::Chunk(
         int* height_map,
-        unsigned int* block_types,
+        uint8_t* compound_blocks,
         std::vector<glm::ivec2>& tree_positions,
-        Noise& noise, glm::ivec3 position
-    ) : position(position), block_types_ptr(&block_types[(position.y * SIZE * SIZE) / NUM_VALUES_IN_ONE_UINT])
+        Noise& noise, GenerationRandom& random, glm::ivec3 position,
+        glm::ivec2 height_range
+    ) : position(position), generation_blocks(&compound_blocks[position.y * SIZE * SIZE])
     {
-        generate_trees(noise, height_map, tree_positions);
+        generate_trees(noise, random, height_map, tree_positions);
+
+        if (column_aware_generation) generate_terrain(noise, random, height_map, height_range);
+        else generate_terrain_full_scan(noise, random, height_map);
+
+        //PALETTE-COMPRESSION: the final blocks of this chunk are known, nothing below writes into it anymore
+        blocks.assign(generation_blocks);
+        generation_blocks = nullptr;
+    }
+
+    Chunk::Chunk(const uint8_t* compound_blocks, glm::ivec3 position) : position(position) {
+        const uint8_t* chunk_blocks = &compound_blocks[position.y * SIZE * SIZE];
+        blocks.assign(chunk_blocks);
+        if (blocks.is_uniform() && chunk_blocks[0] == BlockType::Air) return;
+
+        for (int linear_index {0}; linear_index < SIZE_CUBIC; linear_index++) {
+            if (chunk_blocks[linear_index] == BlockType::Air) continue;
+            set_voxel(linear_index % SIZE, (linear_index / SIZE) % SIZE, linear_index / (SIZE * SIZE));
+        }
+    }
+
+    void Chunk::generate_terrain(Noise& noise, GenerationRandom& random, int* height_map, glm::ivec2 height_range) {
+        //PRE-PLACED-BLOCKS: tree parts that grew in from the chunk below
+        const bool has_preplaced_blocks = std::any_of(
+            generation_blocks, generation_blocks + SIZE_CUBIC,
+            [](uint8_t block) { return block != BlockType::Air; }
+        );
+
+        //TERRAIN-LAYERS: local layers [0, terrain_layers) can contain terrain, everything above is air
+        int terrain_layers = std::clamp(height_range.y - position.y + 1, 0, SIZE);
+        if (position.y == 0) terrain_layers = std::max(terrain_layers, 1);
+
+        //FULLY-AIR-CHUNK: no voxel iteration and no noise at all
+        if (terrain_layers == 0 && !has_preplaced_blocks) return;
+
+        //CAVE-NOISE-BATCH: only voxels at or below the surface ever consult it
+        int cave_column_heights[SIZE * SIZE];
+        for (int i {0}; i < SIZE * SIZE; i++) {
+            cave_column_heights[i] = std::clamp(height_map[i] - position.y + 1, 0, SIZE);
+        }
+        //NOTE: SIZE_CUBIC floats are 1 MB at SIZE 64, too much for a worker's stack
+        static thread_local std::vector<float> cave_values(SIZE_CUBIC);
+        if (terrain_layers > 0) {
+            noise.fetch_cave_columns(position.x, position.y, position.z, SIZE, cave_column_heights, cave_values.data());
+        }
+
+        //NOTE: y -> z -> x order is kept so the compound's random sequence (diamonds) matches the full scan
+        for (int y = 0; y < SIZE; y++)
+        {
+            const int world_space_position_y = position.y + y;
+
+            if (y >= terrain_layers) {
+                if (!has_preplaced_blocks) break;
+
+                for (int z = 0; z < SIZE; z++) {
+                    for (int x = 0; x < SIZE; x++) {
+                        uint8_t block = access_block_type(x, y, z);
+                        if (block != BlockType::Air) set_block(x, y, z, block);
+                    }
+                }
+                continue;
+            }
+
+            const bool below_every_surface = world_space_position_y < height_range.x;
+            for (int z = 0; z < SIZE; z++)
+            {
+                for (int x = 0; x < SIZE; x++)
+                {
+                    const int noise_value = height_map[x + (z * SIZE)];
+                    uint8_t block = access_block_type(x, y, z);
+                    if (block == BlockType::Air && (below_every_surface || world_space_position_y <= noise_value || world_space_position_y == 0)) {
+                        block = terrain_block_type(world_space_position_y, noise_value, &cave_values[x + (y * SIZE) + (z * SIZE * SIZE)], random);
+                    }
+
+                    //NOTE: air is the initial state of both the scratch and voxels, nothing to write
+                    if (block != BlockType::Air) set_block(x, y, z, block);
+                }
+            }
+        }
+    }
+
+    void Chunk::generate_terrain_full_scan(Noise& noise, GenerationRandom& random, int* height_map) {
+        int cave_column_heights[SIZE * SIZE];
+        for (int i {0}; i < SIZE * SIZE; i++) {
+            cave_column_heights[i] = std::clamp(height_map[i] - position.y + 1, 0, SIZE);
+        }
+        static thread_local std::vector<float> cave_values(SIZE_CUBIC);
+        noise.fetch_cave_columns(position.x, position.y, position.z, SIZE, cave_column_heights, cave_values.data());
 
         for (uint16_t y = 0; y < SIZE; y++)
         {
@@ -49,19 +147,7 @@ namespace Voxel::Game {
 
                     unsigned int block = access_block_type(x, y, z);
                     if (block == BlockType::Air) {
-                        if (world_space_position_y == 0) block = BlockType::Bedrock;
-                        else if (world_space_position_y == noise_value) {
-                            if (world_space_position_y > 128) block = BlockType::Snow;
-                            else if (world_space_position_y > 96) block = BlockType::Stone;
-                            else if (noise.fetch_cave(position.x + x, position.y + y, position.z + z) < .7f) block = BlockType::Grass;
-                        }
-                        else if (world_space_position_y < noise_value) {
-                            if (noise.fetch_cave(position.x + x, position.y + y, position.z + z) < .7f) {
-                                if (world_space_position_y > noise_value - 2) block = BlockType::Dirt;
-                                else if (world_space_position_y < 20 && ((float)rand()/RAND_MAX) < .01 ) block = BlockType::Diamond;
-                                else block = BlockType::Stone;
-                            }
-                        }
+                        block = terrain_block_type(world_space_position_y, noise_value, &cave_values[x + (y * SIZE) + (z * SIZE * SIZE)], random);
                     }
 
                     set_block(x, y, z, block);
@@ -72,21 +158,14 @@ namespace Voxel::Game {
 
     uint8_t Chunk::access_block_type(int x, int y, int z) {
         int linear_index = x + (y * SIZE) + (z * SIZE * SIZE);
-        int block_index = linear_index / NUM_VALUES_IN_ONE_UINT;
-        auto& area = block_types_ptr[block_index];
-        int bit_position = (linear_index % NUM_VALUES_IN_ONE_UINT) * SIZE_VALUE_IN_BITS;
-        uint8_t block = static_cast<uint8_t>(
-            (area >> bit_position) & 0xFF
-        );
-        return block;
+        if (generation_blocks) return generation_blocks[linear_index];
+        return blocks.get(linear_index);
     }
 
     void Chunk::set_block_type(int index, uint8_t block) {
-        int block_index = index / NUM_VALUES_IN_ONE_UINT;
-        auto& area = block_types_ptr[block_index];
-        int bit_position = (index % NUM_VALUES_IN_ONE_UINT) * SIZE_VALUE_IN_BITS;
-        area &= ~(0xFF << bit_position);
-        area |= (static_cast<unsigned int>(block) << bit_position);
+        //NOTE: generation may write past this chunk (index >= SIZE_CUBIC), that lands in the scratch of the chunk above
+        if (generation_blocks) generation_blocks[index] = block;
+        else blocks.set(index, block);
     }
 
     void Chunk::set_block_type(int x, int y, int z, uint8_t block) {
@@ -95,61 +174,215 @@ namespace Voxel::Game {
 
     void Chunk::set_block(int x, int y, int z, uint8_t block) {
         set_block_type(x, y, z, block);
+        if (block != BlockType::Air) set_voxel(x, y, z);
+    }
+
+    void Chunk::set_voxel(int x, int y, int z) {
+        if (!voxels) voxels = std::make_unique<ChunkRow[]>(SIZE * SIZE * 3);
+        is_empty = false;
+
+        voxels[z + (y * SIZE)] |= ChunkRow {1} << x;
+        voxels[x  + (y * SIZE) + (SIZE * SIZE)] |= ChunkRow {1} << z;
+        voxels[x  + (z * SIZE) + ((SIZE * SIZE) * 2)] |= ChunkRow {1} << y;
+    }
 
-        int16_t bit {0};
-        if (block != BlockType::Air) {
-            bit = 1;
-            is_empty = false;
+    void Chunk::clear_voxel(int x, int y, int z) {
+        if (!voxels) return;
+
+        voxels[z + (y * SIZE)] &= ~(ChunkRow {1} << x);
+        voxels[x  + (y * SIZE) + (SIZE * SIZE)] &= ~(ChunkRow {1} << z);
+        voxels[x  + (z * SIZE) + ((SIZE * SIZE) * 2)] &= ~(ChunkRow {1} << y);
+    }
+
+    bool Chunk::find_neighbours(std::vector<ChunkRow*>& neighbours, std::vector<std::shared_lock<std::shared_mutex>>& neighbour_locks) {
+        //NOTE: horizontal neighbours are required, missing vertical ones are treated as air
+        for (int i {0}; i < NumNeighbours; i++) {
+            Chunk* neighbour = neighbour_chunks[i].load();
+            if (!neighbour && i < NeighbourBottom) return false;
+            if (!neighbour) continue;
+
+            neighbour_locks.emplace_back(neighbour->voxels_mutex);
+            neighbours[i] = neighbour->voxels.get();
         }
+        return true;
+    }
 
-        uint16_t& row1 = voxels[z + (y * SIZE)] |= bit << x;
-        uint16_t& row2 = voxels[x  + (y * SIZE) + (SIZE * SIZE)] |= bit << z;
-        uint16_t& row3 = voxels[x  + (z * SIZE) + ((SIZE * SIZE) * 2)] |= bit << y;
+    void Chunk::build_mesh() {
+        std::lock_guard<std::mutex> mesh_lock(mesh_mutex);
+        if (built) return;
+
+        create_mesh(lod);
+    }
+
+    //NOTE: the occupancy a chunk is meshed from, OR-reduced into the meshing thread's scratch for lod > 0
+    static const ChunkRow* mesh_occupancy(const ChunkRow* voxels, uint8_t lod) {
+        if (lod == 0) return voxels;
+
+        static thread_local std::unique_ptr<ChunkRow[]> downsampled = std::make_unique<ChunkRow[]>(SIZE * SIZE * 3);
+        ChunkMesh::downsample(voxels, 1 << lod, downsampled.get());
+        return downsampled.get();
+    }
+
+    void Chunk::set_lod(uint8_t level) {
+        std::lock_guard<std::mutex> mesh_lock(mesh_mutex);
+        if (lod == level) return;
+
+        //NOTE: an unbuilt chunk picks the level up with its first mesh
+        if (!built) {
+            lod = level;
+            return;
+        }
+        //NOTE: a built chunk keeps its level (and mesh) until the new one is built, missing neighbours retry with the next wave
+        create_mesh(level);
+    }
+
+    void Chunk::create_mesh(uint8_t level) {
+        ChunkRegistry::Guard guard;
+        std::shared_lock<std::shared_mutex> voxels_lock(voxels_mutex);
+        std::vector<std::shared_lock<std::shared_mutex>> neighbour_locks;
+        std::vector<ChunkRow*> neighbours {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+        if (!voxels || !find_neighbours(neighbours, neighbour_locks)) return;
+
+        //SEAMS: the neighbours stay at full resolution whatever their lod, an OR-reduced mesh only ever grows the solid volume,
+        //       so the faces culled against the real neighbour are covered on both sides of a lod transition (no cracks)
+        mesh = std::make_unique<ChunkMesh>(mesh_occupancy(voxels.get(), level), neighbours.data());
+        const bool had_shape = static_cast<bool>(shape);
+        shape = mesh->quads.empty() ? nullptr : new VoxelShape(voxels.get(), neighbours.data());
+        face_connectivity = ChunkVisibility::compute_face_connectivity(voxels.get());
+
+        //NOTE: edits that raced with this build are already part of it
+        for (auto& slices : dirty_slices) slices = 0;
+        built = true;
+        lod = level;
+        stage_upload();
+        //NOTE: tells PhysicsStreaming there is a new shape to pick up
+        if (shape && !had_shape) shape_generation++;
     }
 
-    bool Chunk::find_neighbours(std::vector<uint16_t*>& neighbours) {
-        ChunkPos chunk_left_index {position.x - SIZE, position.y, position.z};
-        if (chunks.find(chunk_left_index) != chunks.end()) neighbours[0] = chunks[chunk_left_index]->voxels;
-        else return false;
+    void Chunk::remesh(bool all_slices) {
+        std::lock_guard<std::mutex> mesh_lock(mesh_mutex);
 
-        ChunkPos chunk_right_index { position.x + SIZE, position.y, position.z };
-        if (chunks.find(chunk_right_index) != chunks.end()) neighbours[1] = chunks[chunk_right_index]->voxels;
-        else return false;
+        uint64_t slices[ChunkMesh::NUM_FACE_DIRECTIONS];
+        bool has_dirty_slices {false};
+        for (int k {0}; k < ChunkMesh::NUM_FACE_DIRECTIONS; k++) {
+            slices[k] = all_slices ? ~0ull : dirty_slices[k].exchange(0);
+            has_dirty_slices |= slices[k] != 0;
+        }
+        if (!has_dirty_slices) return;
+
+        //NOTE: a chunk that was empty (or never had all its neighbours) gets its first full mesh
+        if (!built) {
+            create_mesh(lod);
+            return;
+        }
+
+        {
+            ChunkRegistry::Guard guard;
+            std::shared_lock<std::shared_mutex> voxels_lock(voxels_mutex);
+            std::vector<std::shared_lock<std::shared_mutex>> neighbour_locks;
+            std::vector<ChunkRow*> neighbours {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
+            if (!find_neighbours(neighbours, neighbour_locks)) {
+                //NOTE: a horizontal neighbour was just evicted, keep the slices for the next attempt
+                for (int k {0}; k < ChunkMesh::NUM_FACE_DIRECTIONS; k++) dirty_slices[k] |= slices[k];
+                return;
+            }
 
-        ChunkPos chunk_front_index { position.x, position.y, position.z - SIZE };
-        if (chunks.find(chunk_front_index) != chunks.end()) neighbours[2] = chunks[chunk_front_index]->voxels;
-        else return  false;
+            //NOTE: an edit inside a reduced chunk can change a whole cell, the reduced mesh is rebuilt instead
+            if (lod > 0) mesh = std::make_unique<ChunkMesh>(mesh_occupancy(voxels.get(), lod), neighbours.data());
+            else mesh->remesh(voxels.get(), neighbours.data(), slices);
+            const bool had_shape = static_cast<bool>(shape);
+            shape = mesh->quads.empty() ? nullptr : new VoxelShape(voxels.get(), neighbours.data());
+            face_connectivity = ChunkVisibility::compute_face_connectivity(voxels.get());
+            //NOTE: also carries edits that left the geometry as it was (the block types changed)
+            stage_upload();
+            if (shape && !had_shape) shape_generation++;
+        }
+
+        //PHYSICS: swap the shape of the existing body, a chunk that lost all its faces loses the body
+        //NOTE: a chunk that just got its first shape gets a body from PhysicsStreaming (if in range), shape_generation moved
+        if (!affected_by_physics) return;
+        auto& physics_manager = Physics::PhysicsManager::get_instance();
+        if (shape) physics_manager.set_body_shape(slot_physics, shape);
+        else {
+            physics_manager.remove_body(slot_physics);
+            affected_by_physics = false;
+        }
+    }
+
+    static int floor_to_chunk(int world_space_value) {
+        return ((world_space_value >= 0 ? world_space_value : world_space_value - (SIZE - 1)) / SIZE) * SIZE;
+    }
 
-        ChunkPos chunk_back_index { position.x, position.y, position.z + SIZE };
-        if (chunks.find(chunk_back_index) != chunks.end()) neighbours[3] = chunks[chunk_back_index]->voxels;
-        else return false;
+    bool Chunk::set_block_world(int x, int y, int z, uint8_t block) {
+        const glm::ivec3 chunk_position(floor_to_chunk(x), floor_to_chunk(y), floor_to_chunk(z));
 
-        ChunkPos chunk_bottom_index { position.x, position.y - SIZE, position.z };
-        if (chunks.find(chunk_bottom_index) != chunks.end()) neighbours[4] = chunks[chunk_bottom_index]->voxels;
+        ChunkRegistry::Guard guard;
+        Chunk* chunk = ChunkRegistry::get_instance().find(chunk_position);
+        if (!chunk) return false;
 
-        ChunkPos chunk_top_index { position.x, position.y + SIZE, position.z };
-        if (chunks.find(chunk_top_index) != chunks.end()) neighbours[5] = chunks[chunk_top_index]->voxels;
+        const glm::ivec3 local = glm::ivec3(x, y, z) - chunk_position;
+        if (!chunk->apply_block_edit(local.x, local.y, local.z, block)) return false;
 
+        chunk->remesh();
+        for (auto& neighbour_chunk : chunk->neighbour_chunks) {
+            //NOTE: no-op for neighbours whose border slices were not touched
+            if (Chunk* neighbour = neighbour_chunk.load()) neighbour->remesh();
+        }
         return true;
     }
 
-    void Chunk::build_mesh() {
-        if (built) {
-            if (!affected_by_physics) load();
-            return;
+    bool Chunk::apply_block_edit(int x, int y, int z, uint8_t block) {
+        {
+            std::unique_lock<std::shared_mutex> voxels_lock(voxels_mutex);
+            const int index = x + (y * SIZE) + (z * SIZE * SIZE);
+            if (blocks.get(index) == block) return false;
+
+            blocks.set(index, block);
+            if (block == BlockType::Air) clear_voxel(x, y, z);
+            else set_voxel(x, y, z);
         }
+        modified = true;
 
-        std::vector<uint16_t*> neighbours {nullptr, nullptr, nullptr, nullptr, nullptr, nullptr};
-        if (!find_neighbours(neighbours)) return;
+        //DIRTY-SLICES: the faces of the voxel itself and the facing faces of its 6 neighbours
+        mark_dirty_slices(0, x);
+        mark_dirty_slices(1, y);
+        mark_dirty_slices(2, z);
+        return true;
+    }
 
-        mesh = std::make_unique<Mesh<uint32_t>>(voxels, neighbours.data(), SIZE, shape);
-        built = true;
-        load();
+    void Chunk::mark_dirty_slices(int axis, int slice) {
+        //NOTE: face directions per axis (x = 2/3, y = 0/1, z = 4/5), see QuadMesh
+        static constexpr int FACE_DIRECTIONS[3] { 2, 0, 4 };
+        static constexpr int NEIGHBOURS[3][2] {
+            { NeighbourLeft, NeighbourRight }, { NeighbourBottom, NeighbourTop }, { NeighbourFront, NeighbourBack }
+        };
+        const int k = FACE_DIRECTIONS[axis];
+
+        uint64_t slices {0};
+        for (int i = std::max(slice - 1, 0); i <= std::min(slice + 1, SIZE - 1); i++) slices |= 1ull << i;
+        dirty_slices[k] |= slices;
+        dirty_slices[k + 1] |= slices;
+
+        //NOTE: a border voxel changes the facing border slice of the neighbour chunk
+        Chunk* neighbour {nullptr};
+        uint64_t neighbour_slice {0};
+        if (slice == 0) {
+            neighbour = neighbour_chunks[NEIGHBOURS[axis][0]].load();
+            neighbour_slice = 1ull << (SIZE - 1);
+        }
+        else if (slice == SIZE - 1) {
+            neighbour = neighbour_chunks[NEIGHBOURS[axis][1]].load();
+            neighbour_slice = 1ull;
+        }
+        if (!neighbour) return;
+
+        neighbour->dirty_slices[k] |= neighbour_slice;
+        neighbour->dirty_slices[k + 1] |= neighbour_slice;
     }
 
-    void Chunk::generate_trees(Noise& noise, int* height_map, std::vector<glm::ivec2>& tree_positions) {
-        const int stem_height = 2 + rand() % 3;
-        const int leafs_height = 3 + rand() % 2;
+    void Chunk::generate_trees(Noise& noise, GenerationRandom& random, int* height_map, std::vector<glm::ivec2>& tree_positions) {
+        const int stem_height = 2 + random.next_int(3);
+        const int leafs_height = 3 + random.next_int(2);
         for (auto& tree_position : tree_positions) {
             int ground_y = height_map[tree_position.x + (tree_position.y * SIZE)];
             int chunk_y = (ground_y / SIZE) * SIZE;
@@ -176,46 +409,66 @@ namespace Voxel::Game {
         }
     }
 
-    void Chunk::render(Shader& shader) {
-        if (!built || mesh->indices.size() == 0) return;
+    std::size_t Chunk::estimate_memory_usage() const {
+        std::size_t bytes = sizeof(Chunk) + blocks.estimate_memory_usage();
+        if (voxels) bytes += SIZE * SIZE * 3 * sizeof(ChunkRow);
+        if (mesh) {
+            bytes += sizeof(ChunkMesh);
+            bytes += mesh->quads.capacity() * sizeof(ChunkMesh::PackedQuad);
+            bytes += mesh->slice_offsets.capacity() * sizeof(uint32_t);
+        }
+        if (shape) bytes += shape->GetStats().mSizeBytes;
+        return bytes;
+    }
 
-        auto& buffer_allocator = BufferAllocator::getInstance();
+    void Chunk::stage_upload() {
+        if (in_render_set && stage_render_upload) stage_render_upload(*this);
+    }
 
-        if (!allocated) {
-            buffer_allocator.allocate_buffer(slot);
-            memcpy(buffer_allocator.vertex_buffer_objects[slot], mesh->vertices.data(), mesh->vertices.size() * sizeof(uint32_t));
-            memcpy(buffer_allocator.element_buffer_objects[slot], mesh->indices.data(), mesh->indices.size() * sizeof(unsigned int));
-            memcpy(buffer_allocator.shader_storage_buffer_objects[slot], block_types_ptr, ((SIZE * SIZE * SIZE) / 4) * sizeof(unsigned int));
-            allocated = true;
-        }
+    void Chunk::enter_render_set() {
+        std::lock_guard<std::mutex> mesh_lock(mesh_mutex);
+        join_render_set();
+    }
+
+    void Chunk::unload() {
+        std::lock_guard<std::mutex> mesh_lock(mesh_mutex);
+        leave_render_set();
+    }
 
-        shader
-            .use()
-            .set_uniform_mat4("model", glm::translate(glm::mat4(1.0f), glm::vec3(position)));
-        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, buffer_allocator.ssbo_ids[slot]);
-        glBindVertexArray(buffer_allocator.vertex_array_objects[slot]);
-        glDrawElements(GL_TRIANGLES, mesh->indices.size(), GL_UNSIGNED_INT, (void*)0);
-        glBindVertexArray(0);
-        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
-        Gizmo::render_line_box_gizmo(position, glm::vec3(16.f));
+    bool Chunk::try_enter_render_set() {
+        std::unique_lock<std::mutex> mesh_lock(mesh_mutex, std::try_to_lock);
+        if (!mesh_lock.owns_lock()) return false;
+        join_render_set();
+        return true;
     }
 
+    bool Chunk::try_unload() {
+        std::unique_lock<std::mutex> mesh_lock(mesh_mutex, std::try_to_lock);
+        if (!mesh_lock.owns_lock()) return false;
+        leave_render_set();
+        return true;
+    }
 
+    void Chunk::join_render_set() {
+        if (in_render_set) return;
+        in_render_set = true;
+        if (!built) return;
 
-    void Chunk::load() {
-        if (mesh->vertices.size() == 0) return;
-        BodyCreationSettings settings(shape, Vec3(position.x, position.y, position.z), Quat::sIdentity(), EMotionType::Static, PhysicsLayers::NON_MOVING);
-        Physics::PhysicsManager::get_instance().add_body(settings, slot_physics);
-        affected_by_physics = true;
+        std::shared_lock<std::shared_mutex> voxels_lock(voxels_mutex);
+        stage_upload();
     }
 
-    void Chunk::unload() {
-        if (!allocated) return;
-        allocated = false;
-        BufferAllocator::getInstance().free_buffer(slot);
+    void Chunk::leave_render_set() {
+        if (in_render_set) {
+            in_render_set = false;
+            if (release_render_slot) release_render_slot(*this);
+        }
 
-        if (mesh->vertices.size() == 0) return;
-        Physics::PhysicsManager::get_instance().remove_body(slot_physics);
-        affected_by_physics = false;
+        if (affected_by_physics) {
+            Physics::PhysicsManager::get_instance().remove_body(slot_physics);
+            affected_by_physics = false;
+            //NOTE: a chunk that stays registered (it only left the render set) gets its body back if it is still in the ring
+            shape_generation++;
+        }
     }
 }
\ No newline at end of file
@@ -1,53 +1,185 @@
 #include "game/chunk_compound.h"
 
+#include <algorithm>
+#include <cstring>
+
 namespace Voxel::Game {
+    //NOTE: one byte per block of a whole compound, only used while generating/loading/saving on this thread
+    static uint8_t* compound_scratch() {
+        static thread_local std::vector<uint8_t> scratch(RegionStorage::NUM_BLOCKS_PER_COMPOUND);
+        return scratch.data();
+    }
+
+    uint64_t ChunkCompound::seed {0};
+
     ChunkCompound::ChunkCompound(Noise& noise, glm::vec3 position) : position(position) {
         //HEIGHT-MAP-INIT
-        for (int z = 0; z < SIZE; z++) {
-            for (int x = 0; x < SIZE; x++) {
-                 height_map[x + (z * SIZE)] = noise.fetch_heightmap(position.x + x, position.z + z);
-            }
-        }
+        noise.fetch_heightmap_grid(position.x, position.z, SIZE, height_map);
+        auto [height_min, height_max] = std::minmax_element(height_map, height_map + (SIZE * SIZE));
+        height_range = glm::ivec2(*height_min, *height_max);
+
+        //RANDOM: from the position, not from the worker or the order compounds are generated in
+        GenerationRandom random { ChunkRegistry::chunk_key(glm::ivec3(position)) ^ (seed * 0x9E3779B97F4A7C15ull) };
 
         //TREE-POS-INIT
+        const int tree_x = 2 + random.next_int(SIZE - 5);
+        const int tree_z = 2 + random.next_int(SIZE - 5);
         std::vector<glm::ivec2> tree_positions {
-            glm::ivec2(2 + rand() % (SIZE - 5), 2 + rand() % (SIZE - 5))
+            glm::ivec2(tree_x, tree_z)
         };
 
         //SINGLE-CHUNK-GENERATION
+        uint8_t* blocks = compound_scratch();
+        std::memset(blocks, BlockType::Air, RegionStorage::NUM_BLOCKS_PER_COMPOUND);
         for (int i {0}; i < NUM_CHUNKS_PER_COMPOUND; i++) {
             std::shared_ptr<Chunk> chunk = Chunk::create(
                 height_map,
-                block_types,
+                blocks,
                 tree_positions,
                 noise,
-                glm::ivec3(position.x, i * SIZE, position.z)
+                random,
+                glm::ivec3(position.x, i * SIZE, position.z),
+                height_range
             );
-            if (!chunk->is_empty) chunks.push_back(chunk);
+            //NOTE: empty chunks are kept too, they are the (air) neighbours other chunks mesh against
+            chunks.push_back(chunk);
         }
     }
 
-    void ChunkCompound::build_chunk_meshes() {
+    std::unique_ptr<ChunkCompound> ChunkCompound::load(RegionStorage& storage, glm::vec3 position) {
+        std::unique_ptr<ChunkCompound> compound(new ChunkCompound(position));
+        uint8_t* blocks = compound_scratch();
+        if (!storage.load_compound(glm::ivec3(position), compound->height_map, blocks))
+            return nullptr;
+
+        auto [height_min, height_max] = std::minmax_element(compound->height_map, compound->height_map + (SIZE * SIZE));
+        compound->height_range = glm::ivec2(*height_min, *height_max);
+
+        for (int i {0}; i < NUM_CHUNKS_PER_COMPOUND; i++) {
+            compound->chunks.push_back(Chunk::create(blocks, glm::ivec3(position.x, i * SIZE, position.z)));
+        }
+
+        compound->persisted = true;
+        return compound;
+    }
+
+    bool ChunkCompound::save(RegionStorage& storage) {
+        //NOTE: block edits make a stored compound dirty again
+        bool modified {false};
+        for (auto& chunk : chunks) modified |= chunk->modified.exchange(false);
+        if (persisted && !modified) return true;
+        uint8_t* blocks = compound_scratch();
+        copy_blocks(blocks);
+        persisted = storage.save_compound(glm::ivec3(position), height_map, blocks);
+        return persisted;
+    }
+
+    void ChunkCompound::copy_blocks(uint8_t* out) const {
+        for (std::size_t i {0}; i < chunks.size(); i++) {
+            std::shared_lock<std::shared_mutex> lock(chunks[i]->voxels_mutex);
+            chunks[i]->blocks.unpack(out + i * SIZE_CUBIC);
+        }
+    }
+
+    ChunkCompound::~ChunkCompound() {
+        auto& registry = ChunkRegistry::get_instance();
+        for (auto& chunk : chunks) {
+            registry.remove(chunk.get());
+            //NOTE: PhysicsStreaming may have added a body after the last unload(), it re-checks the registry under mesh_mutex,
+            //      so a body is only added before this unload() (which releases it), never after
+            chunk->unload();
+            registry.retire(std::move(chunk));
+        }
+    }
+
+    void ChunkCompound::build_chunk_meshes(uint8_t lod) {
         //BUILD-SINGLE-CHUNKS
+        this->lod = lod;
         for (auto& chunk : chunks) {
+            chunk->set_lod(lod);
+            if (chunk->is_empty) continue;
             chunk->build_mesh();
         }
     }
 
-    void ChunkCompound::render(Plane* frustum, Shader& shader) {
-        //RENDER-IN-FRUSTUM-SINGLE-CHUNKS
+    void ChunkCompound::collect_mesh_jobs(std::vector<JobSystem::Job>& jobs, int priority, uint8_t lod) {
+        //ONE-JOB-PER-SINGLE-CHUNK
+        this->lod = lod;
+        for (auto& chunk : chunks) {
+            //NOTE: an empty chunk has nothing to remesh, an edit gives it its first mesh at the compound's level
+            if (chunk->is_empty) {
+                chunk->set_lod(lod);
+                continue;
+            }
+            jobs.push_back(JobSystem::Job { [chunk, lod] { chunk->set_lod(lod); chunk->build_mesh(); }, priority });
+        }
+    }
+
+    void ChunkCompound::visit_visible_chunks(const Plane* frustum, const std::function<void(Chunk&)>& visit) {
+        //IN-FRUSTUM-SINGLE-CHUNKS
         for (const auto& chunk : chunks) {
+            if (chunk->is_empty) continue;
             if (!is_box_in_frustum(frustum, chunk->position, chunk->position + glm::ivec3(SIZE)))
                 continue;
 
-            chunk->render(shader);
+            visit(*chunk);
+        }
+    }
+
+    void ChunkCompound::visit_chunks(const std::function<void(Chunk&)>& visit) {
+        for (const auto& chunk : chunks) {
+            if (!chunk->is_empty) visit(*chunk);
+        }
+    }
+
+    void ChunkCompound::enter_render_set() {
+        std::lock_guard<std::mutex> lock(render_set_mutex);
+        if (in_render_set) return;
+        in_render_set = true;
+
+        for (const auto& chunk : chunks) {
+            chunk->enter_render_set();
         }
     }
 
     void ChunkCompound::unload() {
         //UNLOADING
+        std::lock_guard<std::mutex> lock(render_set_mutex);
+        in_render_set = false;
         for (const auto& chunk : chunks) {
             chunk->unload();
         }
     }
+
+    bool ChunkCompound::try_enter_render_set() {
+        std::unique_lock<std::mutex> lock(render_set_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) return false;
+        in_render_set = true;
+
+        bool entered {true};
+        for (const auto& chunk : chunks) {
+            entered &= chunk->try_enter_render_set();
+        }
+        return entered;
+    }
+
+    bool ChunkCompound::try_unload() {
+        std::unique_lock<std::mutex> lock(render_set_mutex, std::try_to_lock);
+        if (!lock.owns_lock()) return false;
+        in_render_set = false;
+
+        bool unloaded {true};
+        for (const auto& chunk : chunks) {
+            unloaded &= chunk->try_unload();
+        }
+        return unloaded;
+    }
+
+    std::size_t ChunkCompound::estimate_memory_usage() const {
+        std::size_t bytes = sizeof(ChunkCompound) + chunks.capacity() * sizeof(std::shared_ptr<Chunk>);
+        for (const auto& chunk : chunks) {
+            bytes += chunk->estimate_memory_usage();
+        }
+        return bytes;
+    }
 }
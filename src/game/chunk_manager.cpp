@@ -1,5 +1,7 @@
 #include "game/chunk_manager.h"
 
+#include <algorithm>
+
 namespace Voxel::Game {
     static int64_t chunk_position_to_key(int x, int z) {
         return ((int64_t)x << 32) | (uint32_t)z;
@@ -18,82 +20,244 @@ namespace Voxel::Game {
     }
 
     static std::thread worker_thread;
+    static std::unique_ptr<JobSystem> job_system;
+    static std::unique_ptr<RegionStorage> region_storage;
     static std::atomic<bool> worker_should_exit {false};
     static std::condition_variable worker_cv;
 
-    static std::unordered_map<int64_t, std::unique_ptr<ChunkCompound>> chunks_cached;
+    struct CachedCompound {
+        //NOTE: shared with the render set snapshots, an evicted compound lives on until no snapshot holds it
+        std::shared_ptr<ChunkCompound> compound;
+        //NOTE: worker iteration that last requested the compound (lru stamp)
+        uint64_t last_used {0};
+        std::size_t estimated_bytes {0};
+    };
+
+    static std::unordered_map<int64_t, CachedCompound> chunks_cached;
+    static uint64_t cache_iteration {0};
+    //NOTE: sum of the cached compounds' estimate_memory_usage()
+    static std::size_t cache_bytes {0};
 
+    //NOTE: the worker's view of the render set, only the worker thread touches it
     static std::unordered_map<int64_t, ChunkCompound*> chunks_render;
-    static std::mutex chunks_render_mutex;
+    static std::atomic<std::shared_ptr<const ChunkManager::RenderSet>> render_set;
+    //NOTE: the last snapshot the render thread synced with (render thread only)
+    static std::shared_ptr<const ChunkManager::RenderSet> synced_render_set;
+    //NOTE: compounds whose unload/enter met a chunk being meshed, retried every frame (render thread only)
+    static std::vector<std::shared_ptr<ChunkCompound>> pending_unloads;
+    static std::vector<std::shared_ptr<ChunkCompound>> pending_enters;
 
     static bool position_updated {false};
     static glm::ivec3 player_current_chunk_position {0};
+    //NOTE: horizontal and normalised, zero = no preferred direction
+    static glm::vec2 player_view_direction {0};
     static std::mutex player_position_mutex;
 
     static Noise noise;
 
     int ChunkManager::chunk_render_distance {8};
+    std::array<float, ChunkManager::MAX_LOD> ChunkManager::lod_distances {0.5f, 0.75f, 0.9f};
+
+    static bool cache_over_budget() {
+        const std::size_t budget_bytes = ChunkManager::cache_budget_mb * 1000000;
+        if (budget_bytes > 0 && cache_bytes > budget_bytes) return true;
+        if (ChunkManager::cache_budget_compounds > 0 && chunks_cached.size() > ChunkManager::cache_budget_compounds) return true;
+        return false;
+    }
+
+    static void evict_cached_compounds() {
+        if (!cache_over_budget()) return;
+
+        //LRU-CANDIDATES: everything the renderer may still touch stays resident
+        //NOTE: a compound an older snapshot still holds waits for the render thread to let go of it,
+        //      its chunks would still be registered when the compound is requested again
+        std::vector<std::pair<uint64_t, int64_t>> candidates;
+        for (auto& [key, cached] : chunks_cached) {
+            if (!chunks_render.contains(key) && cached.compound.use_count() == 1) candidates.push_back({ cached.last_used, key });
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (auto& [_, key] : candidates) {
+            if (!cache_over_budget()) break;
+
+            auto it = chunks_cached.find(key);
+            it->second.compound->unload();
+            it->second.compound->save(*region_storage);
+            cache_bytes -= it->second.estimated_bytes;
+            //NOTE: the compound's chunks are retired to the registry and freed on the next collect()
+            chunks_cached.erase(it);
+            ChunkManager::num_evicted++;
+        }
+
+        if (cache_over_budget()) {
+            plog_warn("chunk cache over budget (~{} MB estimated, {} compounds) with only visible compounds left", cache_bytes / 1000000, chunks_cached.size());
+        }
+    }
+
+    //NOTE: squared distance in compounds, weighted by the view direction (in [0.75, 1.25]),
+    //      a compound behind the player waits about as long as one ahead of it at 1.3x the distance
+    static float request_priority(int x, int z, glm::vec2 view_direction) {
+        const float distance_squared = static_cast<float>(x * x + z * z);
+        if (distance_squared == 0.f || view_direction == glm::vec2(0)) return distance_squared;
+
+        const float cos_angle = glm::dot(glm::normalize(glm::vec2(x, z)), view_direction);
+        return distance_squared * (1.f - 0.25f * cos_angle);
+    }
+
+    uint8_t ChunkManager::select_lod(int x, int z) {
+        const float distance_squared = static_cast<float>(x * x + z * z);
+        uint8_t lod {0};
+        for (int i {0}; i < MAX_LOD; i++) {
+            const float ring_distance = lod_distances[i] * static_cast<float>(chunk_render_distance);
+            if (lod_distances[i] > 0.f && distance_squared > ring_distance * ring_distance) lod = static_cast<uint8_t>(i + 1);
+        }
+        return lod;
+    }
 
     void ChunkManager::worker_func() {
         const int render_distance_squared = chunk_render_distance * chunk_render_distance;
-        
+        const std::size_t wave_size = compounds_per_wave > 0 ? compounds_per_wave : 2 * job_system->get_num_workers();
+
+        struct ChunkRequest {
+            int64_t key;
+            float priority;
+            uint8_t lod;
+        };
+
+        std::vector<ChunkRequest> chunks_requested;
+        std::unordered_set<int64_t> keys_requested;
+        bool has_missing {false};
+
         while (!worker_should_exit) {
+            //NOTE: only sleeps once every compound around the latest position is generated
             glm::vec3 _position;
-            std::unique_lock<std::mutex> lock(player_position_mutex);
-            worker_cv.wait(lock, [] { return position_updated || worker_should_exit; });
-            position_updated = false;
-            _position = player_current_chunk_position;
-            lock.unlock();
+            glm::vec2 _view_direction;
+            bool moved {false};
+            {
+                std::unique_lock<std::mutex> lock(player_position_mutex);
+                if (!has_missing) worker_cv.wait(lock, [] { return position_updated || worker_should_exit; });
+                moved = position_updated;
+                position_updated = false;
+                _position = player_current_chunk_position;
+                _view_direction = player_view_direction;
+            }
+            if (worker_should_exit) break;
 
-            std::queue<int64_t> chunks_requested;
+            //REQUESTS: re-prioritised against the latest position and view direction every wave,
+            //          requests that fell out of range are dropped before anything was generated for them
+            std::unordered_set<int64_t> keys_previous;
+            if (moved) keys_previous = std::move(keys_requested);
+            chunks_requested.clear();
+            keys_requested.clear();
             for (int x = -chunk_render_distance; x <= chunk_render_distance; x++) {
                 for (int z = -chunk_render_distance; z <= chunk_render_distance; z++) {
-                    if (x * x + z * z <= render_distance_squared) {
-                        chunks_requested.push(
-                            chunk_position_to_key(_position.x + x * SIZE, _position.z + z * SIZE)
-                        );
-                    }
+                    if (x * x + z * z > render_distance_squared) continue;
+
+                    const int64_t key = chunk_position_to_key(_position.x + x * SIZE, _position.z + z * SIZE);
+                    chunks_requested.push_back(ChunkRequest { key, request_priority(x, z, _view_direction), select_lod(x, z) });
+                    keys_requested.insert(key);
                 }
             }
+            std::sort(chunks_requested.begin(), chunks_requested.end(), [](const ChunkRequest& a, const ChunkRequest& b) { return a.priority < b.priority; });
+
+            for (int64_t key : keys_previous) {
+                if (!keys_requested.contains(key) && !chunks_cached.contains(key)) num_cancelled++;
+            }
+
+            //GENERATE-MISSING-COMPOUNDS (one job per compound, the wave_size best ones, then back to the position check)
+            std::vector<ChunkRequest> chunks_missing;
+            for (auto& request : chunks_requested) {
+                if (!chunks_cached.contains(request.key)) chunks_missing.push_back(request);
+            }
+            has_missing = chunks_missing.size() > wave_size;
+            if (has_missing) chunks_missing.resize(wave_size);
+
+            std::vector<std::unique_ptr<ChunkCompound>> chunks_generated(chunks_missing.size());
+            std::vector<JobSystem::Job> jobs;
+            for (std::size_t i {0}; i < chunks_missing.size(); i++) {
+                jobs.push_back(JobSystem::Job {
+                    [i, &chunks_missing, &chunks_generated] {
+                        const glm::vec3 position = chunk_key_to_position(chunks_missing[i].key);
+                        //NOTE: visited compounds come back from their region file, only new ones hit the noise
+                        chunks_generated[i] = ChunkCompound::load(*region_storage, position);
+                        if (!chunks_generated[i]) chunks_generated[i] = std::make_unique<ChunkCompound>(noise, position);
+                    },
+                    static_cast<int>(chunks_missing[i].priority)
+                });
+            }
+            job_system->submit_batch(jobs);
+            job_system->wait();
+
+            std::unordered_set<int64_t> keys_to_mesh;
+            for (std::size_t i {0}; i < chunks_missing.size(); i++) {
+                chunks_cached[chunks_missing[i].key].compound = std::move(chunks_generated[i]);
+
+                //NOTE: the border chunks of the horizontal neighbours could not mesh before this compound existed
+                const glm::ivec3 position = chunk_key_to_position(chunks_missing[i].key);
+                keys_to_mesh.insert(chunks_missing[i].key);
+                keys_to_mesh.insert(chunk_position_to_key(position.x + SIZE, position.z));
+                keys_to_mesh.insert(chunk_position_to_key(position.x - SIZE, position.z));
+                keys_to_mesh.insert(chunk_position_to_key(position.x, position.z + SIZE));
+                keys_to_mesh.insert(chunk_position_to_key(position.x, position.z - SIZE));
+            }
 
+            //MESH-SINGLE-CHUNKS (one job per chunk, chunks whose horizontal neighbours are still missing wait for a later wave)
+            //NOTE: the render set is every requested compound generated so far
+            cache_iteration++;
             std::unordered_map<int64_t, ChunkCompound*> _chunks_new;
-            {
-                while (!chunks_requested.empty()) {
-                    auto chunk_key = chunks_requested.front();
-                    chunks_requested.pop();
-
-                    if (!chunks_cached.contains(chunk_key)) {
-                        chunks_cached[chunk_key] = std::make_unique<ChunkCompound>(noise, chunk_key_to_position(chunk_key));
-                    }
-                    _chunks_new[chunk_key] = chunks_cached[chunk_key].get();
-                }
+            std::vector<int64_t> keys_meshed;
+            for (auto& request : chunks_requested) {
+                auto it = chunks_cached.find(request.key);
+                if (it == chunks_cached.end()) continue;
+
+                auto& cached = it->second;
+                cached.last_used = cache_iteration;
+                _chunks_new[request.key] = cached.compound.get();
+
+                //NOTE: moving changes the rings, a compound that crossed one is remeshed at its new level
+                const bool entered = !chunks_render.contains(request.key);
+                if (!entered && !keys_to_mesh.contains(request.key) && cached.compound->lod == request.lod) continue;
+
+                //NOTE: before the mesh jobs, their new meshes are staged by the worker that built them
+                if (entered) cached.compound->enter_render_set();
+                cached.compound->collect_mesh_jobs(jobs, static_cast<int>(request.priority), request.lod);
+                keys_meshed.push_back(request.key);
             }
+            job_system->submit_batch(jobs);
+            job_system->wait();
 
-            for (auto& [_, chunk] : _chunks_new) {
-                chunk->build_chunk_meshes();
+            //CACHE-ACCOUNTING: only the (re)meshed compounds changed their size
+            for (int64_t key : keys_meshed) {
+                auto& cached = chunks_cached[key];
+                const std::size_t estimated_bytes = cached.compound->estimate_memory_usage();
+                cache_bytes = cache_bytes - cached.estimated_bytes + estimated_bytes;
+                cached.estimated_bytes = estimated_bytes;
             }
 
+            //PUBLISH: compounds that left are unloaded by the render thread once it sees the new snapshot
+            chunks_render = std::move(_chunks_new);
             {
-                std::lock_guard<std::mutex> lock_render(chunks_render_mutex);
-                for (auto it = chunks_render.begin(); it != chunks_render.end(); ) {
-                    if (!_chunks_new.contains(it->first)) {
-                        it->second->unload();
-                        it = chunks_render.erase(it);
-                    } else {
-                        ++it;
-                    }
-                }
-
-                for (auto& [chunk_key, chunk] : _chunks_new) {
-                    chunks_render[chunk_key] = chunk;
-                }
+                auto snapshot = std::make_shared<RenderSet>();
+                snapshot->compounds.reserve(chunks_render.size());
+                for (auto& [chunk_key, _] : chunks_render) snapshot->compounds.push_back(chunks_cached[chunk_key].compound);
+                snapshot->version = cache_iteration;
+                render_set.store(std::move(snapshot));
             }
 
+            evict_cached_compounds();
+
             num_chunks = chunks_cached.size();
+            num_requests_pending = chunks_requested.size() - chunks_render.size();
+            cache_estimated_bytes = cache_bytes;
+            ChunkRegistry::get_instance().collect();
         }
     }
 
     ChunkManager::ChunkManager(glm::ivec3 position) {
+        region_storage = std::make_unique<RegionStorage>(world_directory);
+        job_system = std::make_unique<JobSystem>(num_worker_threads > 0 ? num_worker_threads : std::thread::hardware_concurrency());
+        //NOTE: a previous manager's worker was told to exit
+        worker_should_exit = false;
         worker_thread = std::thread(worker_func);
         on_new_chunk_entered(position);
     }
@@ -102,27 +266,96 @@ namespace Voxel::Game {
         worker_should_exit = true;
         worker_cv.notify_one();
         worker_thread.join();
+        job_system.reset();
+
+        for (auto& [_, cached] : chunks_cached) {
+            cached.compound->save(*region_storage);
+        }
+
+        //NOTE: release the compounds while the chunk registry is guaranteed to still be alive
+        chunks_render.clear();
+        render_set.store(nullptr);
+        synced_render_set.reset();
+        pending_unloads.clear();
+        pending_enters.clear();
+        chunks_cached.clear();
+        cache_bytes = 0;
+        region_storage.reset();
+        ChunkRegistry::get_instance().collect();
     }
 
-    void ChunkManager::update(glm::ivec3 position_world_space) {
+    void ChunkManager::update(glm::ivec3 position_world_space, glm::vec3 view_direction) {
+        {
+            //NOTE: read by the worker between waves, turning around alone doesn't wake it up
+            const glm::vec2 horizontal(view_direction.x, view_direction.z);
+            std::lock_guard<std::mutex> lock_position(player_position_mutex);
+            player_view_direction = horizontal == glm::vec2(0) ? glm::vec2(0) : glm::normalize(horizontal);
+        }
+
         glm::ivec3 position_chunk_space = world_space_to_chunk_space(position_world_space);
         static glm::ivec3 position_current = position_chunk_space;
         if (position_current != position_chunk_space) {
             position_current = position_chunk_space;
             on_new_chunk_entered(position_chunk_space);
         }
+
+        sync_render_set();
     }
 
-    void ChunkManager::render_chunk_compounds(Plane* frustum, Shader& shader) {
-        std::lock_guard<std::mutex> lock_render(chunks_render_mutex);
-        for (auto& [_, chunk] : chunks_render) {
-            if (!is_box_in_frustum(frustum, chunk->position, chunk->position + glm::vec3(SIZE, SIZE * NUM_CHUNKS_PER_COMPOUND, SIZE)))
-                continue;
+    void ChunkManager::sync_render_set() {
+        std::shared_ptr<const RenderSet> current = render_set.load();
+        if (current != synced_render_set) {
+            //DIFF: unloads happen here instead of on the worker, a snapshot skipped in between never shows up
+            static std::unordered_set<const ChunkCompound*> compounds_current;
+            compounds_current.clear();
+            if (current) {
+                for (auto& compound : current->compounds) compounds_current.insert(compound.get());
+            }
+
+            static std::unordered_set<const ChunkCompound*> compounds_synced;
+            compounds_synced.clear();
+            if (synced_render_set) {
+                for (auto& compound : synced_render_set->compounds) {
+                    compounds_synced.insert(compound.get());
+                    if (compounds_current.contains(compound.get())) continue;
+                    std::erase(pending_enters, compound);
+                    pending_unloads.push_back(compound);
+                }
+            }
+
+            //NOTE: no-op unless the compound left and re-entered while this thread was unloading it
+            if (current) {
+                for (auto& compound : current->compounds) {
+                    if (compounds_synced.contains(compound.get())) continue;
+                    std::erase(pending_unloads, compound);
+                    pending_enters.push_back(compound);
+                }
+            }
+
+            //NOTE: dropping the old snapshot may free evicted compounds (their chunks go to the registry's retire list),
+            //      pending ones live on until they are done (eviction skips compounds held elsewhere)
+            synced_render_set = std::move(current);
+        }
 
-            chunk->render(frustum, shader);
+        //RETRY: a worker holds mesh_mutex through a whole build (build_mesh -> create_mesh), waiting for it stalled the frame,
+        //       the chunks it holds are done on one of the next frames instead
+        std::erase_if(pending_unloads, [](const std::shared_ptr<ChunkCompound>& compound) { return compound->try_unload(); });
+        std::erase_if(pending_enters, [](const std::shared_ptr<ChunkCompound>& compound) { return compound->try_enter_render_set(); });
+        num_deferred_syncs += pending_unloads.size() + pending_enters.size();
+    }
+
+    void ChunkManager::visit_chunks(const std::function<void(Chunk&)>& visit) {
+        const std::shared_ptr<const RenderSet> snapshot = render_set.load();
+        if (!snapshot) return;
+        for (auto& compound : snapshot->compounds) {
+            compound->visit_chunks(visit);
         }
     }
 
+    std::shared_ptr<const ChunkManager::RenderSet> ChunkManager::get_render_set() const {
+        return render_set.load();
+    }
+
     void ChunkManager::on_new_chunk_entered(glm::ivec3 position_chunk_space) {
         {
             std::lock_guard<std::mutex> lock_position(player_position_mutex);
@@ -134,4 +367,14 @@ namespace Voxel::Game {
     }
 
     int ChunkManager::num_chunks {0};
+    unsigned int ChunkManager::num_worker_threads {0};
+    std::string ChunkManager::world_directory {"world"};
+    std::size_t ChunkManager::cache_budget_mb {512};
+    std::size_t ChunkManager::cache_budget_compounds {0};
+    std::atomic<std::size_t> ChunkManager::cache_estimated_bytes {0};
+    std::atomic<std::size_t> ChunkManager::num_evicted {0};
+    std::atomic<std::size_t> ChunkManager::num_deferred_syncs {0};
+    std::size_t ChunkManager::compounds_per_wave {0};
+    std::atomic<std::size_t> ChunkManager::num_cancelled {0};
+    std::atomic<std::size_t> ChunkManager::num_requests_pending {0};
 }
\ No newline at end of file
@@ -0,0 +1,237 @@
+#include "game/chunk_registry.h"
+
+#include <stdexcept>
+#include "game/chunk.h"
+
+namespace Voxel::Game {
+    static constexpr std::size_t MAX_GUARDED_THREADS = 256;
+
+    struct ThreadRecord {
+        std::atomic<uint64_t> epoch {0};
+        std::atomic<bool> in_use {false};
+    };
+    static std::array<ThreadRecord, MAX_GUARDED_THREADS> thread_records;
+
+    //NOTE: claimed on first use of a guard, handed back when the thread exits (job systems come and go)
+    struct ThreadSlot {
+        ThreadRecord* record {nullptr};
+        int depth {0};
+
+        ThreadSlot() {
+            for (auto& candidate : thread_records) {
+                bool expected {false};
+                if (candidate.in_use.compare_exchange_strong(expected, true)) {
+                    record = &candidate;
+                    return;
+                }
+            }
+            throw std::runtime_error("ChunkRegistry: too many threads hold epoch guards");
+        }
+
+        ~ThreadSlot() {
+            record->epoch = 0;
+            record->in_use = false;
+        }
+    };
+    static thread_local ThreadSlot thread_slot;
+
+    ChunkRegistry::Guard::Guard() {
+        if (thread_slot.depth++ > 0) return;
+
+        auto& global_epoch = ChunkRegistry::get_instance().global_epoch;
+        uint64_t epoch;
+        do {
+            epoch = global_epoch.load();
+            thread_slot.record->epoch.store(epoch);
+        } while (global_epoch.load() != epoch);
+    }
+
+    ChunkRegistry::Guard::~Guard() {
+        if (--thread_slot.depth > 0) return;
+        thread_slot.record->epoch.store(0);
+    }
+
+    uint64_t ChunkRegistry::chunk_key(glm::ivec3 position) {
+        //NOTE: chunk origins are multiples of SIZE, 21 bits per axis (bit 63 stays clear of the sentinels)
+        const uint64_t x = static_cast<uint32_t>(position.x / SIZE) & 0x1FFFFF;
+        const uint64_t y = static_cast<uint32_t>(position.y / SIZE) & 0x1FFFFF;
+        const uint64_t z = static_cast<uint32_t>(position.z / SIZE) & 0x1FFFFF;
+        return (x << 42) | (y << 21) | z;
+    }
+
+    uint64_t ChunkRegistry::mix(uint64_t key) {
+        //SPLITMIX64-FINALIZER: grid-aligned keys differ only in a few low bits per axis
+        key ^= key >> 30;
+        key *= 0xbf58476d1ce4e5b9ull;
+        key ^= key >> 27;
+        key *= 0x94d049bb133111ebull;
+        key ^= key >> 31;
+        return key;
+    }
+
+    void ChunkRegistry::rehash(Shard& shard, std::size_t capacity) {
+        std::vector<Slot> old_slots = std::move(shard.slots);
+        shard.slots.assign(capacity, Slot {});
+        shard.tombstones = 0;
+
+        const std::size_t mask = capacity - 1;
+        for (auto& slot : old_slots) {
+            if (slot.key == EMPTY_KEY || slot.key == TOMBSTONE_KEY) continue;
+            std::size_t index = mix(slot.key) & mask;
+            while (shard.slots[index].key != EMPTY_KEY) index = (index + 1) & mask;
+            shard.slots[index] = slot;
+        }
+    }
+
+    void ChunkRegistry::insert(Chunk* chunk) {
+        const uint64_t key = chunk_key(chunk->position);
+        const uint64_t hash = mix(key);
+
+        {
+            auto& shard = shard_for(hash);
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+            if (shard.slots.empty()) shard.slots.assign(INITIAL_SHARD_CAPACITY, Slot {});
+            if ((shard.size + shard.tombstones + 1) * 4 > shard.slots.size() * 3) {
+                rehash(shard, (shard.size + 1) * 2 > shard.slots.size() ? shard.slots.size() * 2 : shard.slots.size());
+            }
+
+            const std::size_t mask = shard.slots.size() - 1;
+            std::size_t index = hash & mask;
+            Slot* tombstone {nullptr};
+            bool replaced {false};
+            while (shard.slots[index].key != EMPTY_KEY) {
+                auto& slot = shard.slots[index];
+                if (slot.key == key) {
+                    //NOTE: re-registering a position replaces the previous chunk
+                    slot.chunk = chunk;
+                    replaced = true;
+                    break;
+                }
+                if (slot.key == TOMBSTONE_KEY && !tombstone) tombstone = &slot;
+                index = (index + 1) & mask;
+            }
+
+            if (!replaced) {
+                if (tombstone) {
+                    *tombstone = Slot { key, chunk };
+                    shard.tombstones--;
+                } else {
+                    shard.slots[index] = Slot { key, chunk };
+                }
+                shard.size++;
+                num_chunks++;
+            }
+        }
+
+        //NEIGHBOUR-LINKS: whichever of two adjacent inserts comes second sees the other and links both ways,
+        //                 under the neighbour's shard lock (remove() unlinks under it exclusively, it can't be half removed)
+        Guard guard;
+        for (int i {0}; i < NumNeighbours; i++) {
+            const glm::ivec3 offset(NEIGHBOUR_OFFSETS[i][0], NEIGHBOUR_OFFSETS[i][1], NEIGHBOUR_OFFSETS[i][2]);
+            const uint64_t neighbour_key = chunk_key(chunk->position + offset * SIZE);
+            const uint64_t neighbour_hash = mix(neighbour_key);
+
+            auto& shard = shard_for(neighbour_hash);
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            Chunk* neighbour = lookup(shard, neighbour_key, neighbour_hash);
+            if (!neighbour) continue;
+
+            chunk->neighbour_chunks[i].store(neighbour);
+            neighbour->neighbour_chunks[opposite(i)].store(chunk);
+        }
+    }
+
+    void ChunkRegistry::remove(Chunk* chunk) {
+        const uint64_t key = chunk_key(chunk->position);
+        const uint64_t hash = mix(key);
+
+        //NOTE: the guard keeps neighbours that are removed at the same time alive while they are unlinked
+        Guard guard;
+        auto& shard = shard_for(hash);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (shard.slots.empty()) return;
+
+        const std::size_t mask = shard.slots.size() - 1;
+        std::size_t index = hash & mask;
+        while (shard.slots[index].key != EMPTY_KEY) {
+            auto& slot = shard.slots[index];
+            if (slot.key == key) {
+                //NOTE: a newer chunk at the same position owns the slot now, leave it alone
+                if (slot.chunk != chunk) break;
+                slot = Slot { TOMBSTONE_KEY, nullptr };
+                shard.size--;
+                shard.tombstones++;
+                num_chunks--;
+                break;
+            }
+            index = (index + 1) & mask;
+        }
+
+        //NOTE: still under the lock, an insert next to the chunk either linked it before or no longer finds it
+        for (int i {0}; i < NumNeighbours; i++) {
+            Chunk* neighbour = chunk->neighbour_chunks[i].exchange(nullptr);
+            if (!neighbour) continue;
+
+            Chunk* expected = chunk;
+            neighbour->neighbour_chunks[opposite(i)].compare_exchange_strong(expected, nullptr);
+        }
+    }
+
+    Chunk* ChunkRegistry::lookup(const Shard& shard, uint64_t key, uint64_t hash) {
+        if (shard.slots.empty()) return nullptr;
+
+        const std::size_t mask = shard.slots.size() - 1;
+        std::size_t index = hash & mask;
+        while (shard.slots[index].key != EMPTY_KEY) {
+            if (shard.slots[index].key == key) return shard.slots[index].chunk;
+            index = (index + 1) & mask;
+        }
+        return nullptr;
+    }
+
+    Chunk* ChunkRegistry::find(glm::ivec3 position) {
+        const uint64_t key = chunk_key(position);
+        const uint64_t hash = mix(key);
+
+        auto& shard = shard_for(hash);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        return lookup(shard, key, hash);
+    }
+
+    void ChunkRegistry::retire(std::shared_ptr<Chunk> chunk) {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        retired.push_back(Retired { global_epoch.load(), std::move(chunk) });
+    }
+
+    uint64_t ChunkRegistry::min_active_epoch() {
+        uint64_t epoch = global_epoch.load();
+        for (auto& record : thread_records) {
+            const uint64_t thread_epoch = record.epoch.load();
+            if (thread_epoch != 0 && thread_epoch < epoch) epoch = thread_epoch;
+        }
+        return epoch;
+    }
+
+    void ChunkRegistry::collect() {
+        global_epoch.fetch_add(1);
+        const uint64_t safe_epoch = min_active_epoch();
+
+        std::vector<Retired> reclaimable;
+        {
+            std::lock_guard<std::mutex> lock(retired_mutex);
+            std::vector<Retired> still_visible;
+            for (auto& entry : retired) {
+                if (entry.epoch < safe_epoch) reclaimable.push_back(std::move(entry));
+                else still_visible.push_back(std::move(entry));
+            }
+            retired = std::move(still_visible);
+        }
+        //NOTE: the chunks are destroyed when reclaimable goes out of scope, outside of the lock
+    }
+
+    std::size_t ChunkRegistry::num_retired() {
+        std::lock_guard<std::mutex> lock(retired_mutex);
+        return retired.size();
+    }
+}
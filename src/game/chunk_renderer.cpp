@@ -0,0 +1,469 @@
+#include "game/chunk_renderer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include "engine/resource_manager.h"
+
+namespace Voxel::Game {
+    //NOTE: initial arena sizes (~2 MB each at any chunk size), they grow on demand
+    static constexpr uint32_t INITIAL_ARENA_BYTES = 2 * 1024 * 1024;
+    //NOTE: a few frames of the default budget in flight
+    static constexpr uint32_t UPLOAD_RING_BYTES = 16 * 1000 * 1000;
+    static constexpr uint32_t VERTICES_PER_QUAD = 6;
+    //NOTE: block types of one chunk as the shader reads them (4 per uint), one arena unit
+    static constexpr uint32_t BLOCK_UNIT_BYTES = (SIZE_CUBIC / NUM_VALUES_IN_ONE_UINT) * sizeof(unsigned int);
+    //NOTE: the largest mesh a chunk can stage, one quad per face of a checkerboard (half the voxels solid, 6 faces each),
+    //      the ring always holds it, so UploadRing::allocate never has to grow (and wait for every fence) for a chunk
+    static constexpr uint32_t MAX_STAGED_MESH_BYTES = 3 * SIZE_CUBIC * sizeof(ChunkMesh::PackedQuad) + BLOCK_UNIT_BYTES;
+    static_assert(MAX_STAGED_MESH_BYTES <= UPLOAD_RING_BYTES, "the upload ring has to hold the largest chunk mesh");
+    static constexpr uint32_t INITIAL_QUADS = INITIAL_ARENA_BYTES / sizeof(ChunkMesh::PackedQuad);
+    //NOTE: 512 chunks at SIZE 16, 8 at SIZE 64 (one unit is 256 KB there)
+    static constexpr uint32_t INITIAL_BLOCKS = std::max(INITIAL_ARENA_BYTES / BLOCK_UNIT_BYTES, 1u);
+    static constexpr uint32_t CULL_GROUP_SIZE = 64;
+    static constexpr GLbitfield READBACK_STORAGE_FLAGS = GL_MAP_READ_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+    static constexpr const char* FRUSTUM_PLANE_UNIFORMS[6] {
+        "frustum_planes[0]", "frustum_planes[1]", "frustum_planes[2]", "frustum_planes[3]", "frustum_planes[4]", "frustum_planes[5]"
+    };
+
+    bool ChunkRenderer::cave_culling {true};
+    bool ChunkRenderer::occlusion_culling {true};
+    bool ChunkRenderer::verify_culling {false};
+    int ChunkRenderer::upload_budget_kb {4000};
+    std::size_t ChunkRenderer::num_verified_passes {0};
+    std::size_t ChunkRenderer::num_failed_verifications {0};
+
+    ChunkRenderer::ChunkRenderer() {
+        quad_arena = std::make_unique<BufferArena>(sizeof(ChunkMesh::PackedQuad), INITIAL_QUADS);
+        block_arena = std::make_unique<BufferArena>(BLOCK_UNIT_BYTES, INITIAL_BLOCKS);
+        upload_ring = std::make_unique<UploadRing>(UPLOAD_RING_BYTES);
+
+        //NOTE: stays empty, the core profile only needs one bound to draw
+        glGenVertexArrays(1, &vertex_array);
+        glGenBuffers(1, &resident_buffer);
+        glGenBuffers(1, &cave_buffer);
+        for (auto& target : cull_targets) {
+            glGenBuffers(1, &target.commands);
+            glGenBuffers(1, &target.draws);
+            glGenBuffers(1, &target.count);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.count);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+
+            glGenBuffers(1, &target.readback);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, target.readback);
+            glBufferStorage(GL_COPY_WRITE_BUFFER, sizeof(uint32_t), nullptr, READBACK_STORAGE_FLAGS);
+            target.readback_mapped = static_cast<const uint32_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, sizeof(uint32_t), READBACK_STORAGE_FLAGS));
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        //NOTE: both from worker threads (mesh_mutex of the chunk held), a chunk leaving the render set hands its slot back
+        Chunk::stage_render_upload = [this](const Chunk& chunk) {
+            upload_queue.stage(chunk);
+        };
+        Chunk::release_render_slot = [this](Chunk& chunk) {
+            upload_queue.cancel(chunk.position);
+            if (!chunk.allocated) return;
+
+            chunk.allocated = false;
+            std::lock_guard<std::mutex> lock(released_slots_mutex);
+            released_slots.push_back(chunk.slot);
+        };
+    }
+
+    ChunkRenderer::~ChunkRenderer() {
+        Chunk::stage_render_upload = nullptr;
+        Chunk::release_render_slot = nullptr;
+        glDeleteVertexArrays(1, &vertex_array);
+        glDeleteBuffers(1, &resident_buffer);
+        glDeleteBuffers(1, &cave_buffer);
+        for (auto& target : cull_targets) {
+            glDeleteBuffers(1, &target.commands);
+            glDeleteBuffers(1, &target.draws);
+            glDeleteBuffers(1, &target.count);
+            if (target.readback_fence) glDeleteSync(target.readback_fence);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, target.readback);
+            glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            glDeleteBuffers(1, &target.readback);
+        }
+    }
+
+    void ChunkRenderer::release_slots() {
+        std::lock_guard<std::mutex> lock(released_slots_mutex);
+        for (unsigned int slot : released_slots) {
+            auto& allocation = allocations[slot];
+            retire_ranges(allocation);
+            allocation.num_quads = 0;
+            //NOTE: uploads of the slot still in flight are dropped once they complete
+            allocation.ticket++;
+            resident_chunks[slot].num_vertices = 0;
+            resident_dirty = true;
+            resident_generation++;
+            free_slots.push_back(slot);
+        }
+        released_slots.clear();
+    }
+
+    void ChunkRenderer::retire_ranges(ChunkAllocation& allocation) {
+        if (allocation.quads.is_valid() || allocation.blocks.is_valid()) {
+            retired_ranges.push_back(RetiredRanges { 0, allocation.quads, allocation.blocks });
+        }
+        allocation.quads = {};
+        allocation.blocks = {};
+    }
+
+    void ChunkRenderer::free_retired_ranges(uint64_t retired) {
+        //NOTE: fenced in order, the unfenced ones (batch 0) are at the back
+        while (!retired_ranges.empty() && retired_ranges.front().batch != 0 && retired_ranges.front().batch <= retired) {
+            quad_arena->free(retired_ranges.front().quads);
+            block_arena->free(retired_ranges.front().blocks);
+            retired_ranges.pop_front();
+        }
+    }
+
+    void ChunkRenderer::update() {
+        release_slots();
+        const uint64_t retired = upload_ring->retire();
+        complete_uploads(retired);
+        free_retired_ranges(retired);
+        drain_uploads();
+        upload_resident_chunks();
+    }
+
+    void ChunkRenderer::render(const Plane* frustum, Shader& shader, Pass pass) {
+        if (resident_chunks.empty()) return;
+        if (pass == Pass::Scene) update_cave_visibility();
+
+        cull(frustum, pass);
+
+        const auto& target = cull_targets[static_cast<int>(pass)];
+        shader.use();
+        //NOTE: the whole block / quad arena, the shaders offset into them per draw (bound every frame, a grown arena is a new buffer)
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, block_arena->get_id());
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, target.draws);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, quad_arena->get_id());
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, target.commands);
+        glBindVertexArray(vertex_array);
+        //NOTE: one command per resident chunk, the culled ones are zeroed and draw nothing
+        glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, static_cast<GLsizei>(resident_chunks.size()), 0);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        if (Gizmo::show_gizmos && pass == Pass::Scene) {
+            for (const auto& resident : resident_chunks) {
+                if (resident.num_vertices > 0) Gizmo::render_line_box_gizmo(glm::vec3(resident.position), glm::vec3(SIZE));
+            }
+        }
+    }
+
+    void ChunkRenderer::complete_uploads(uint64_t retired) {
+        //NOTE: the ring's fences signal in order, so do the batches of the pending uploads
+        while (!pending_uploads.empty() && pending_uploads.front().batch <= retired) {
+            PendingUpload& upload = pending_uploads.front();
+            auto& allocation = allocations[upload.slot];
+
+            if (upload.ticket != allocation.ticket) {
+                //NOTE: the chunk left the render set meanwhile (the slot may already belong to another chunk), never drawn
+                quad_arena->free(upload.allocation.quads);
+                block_arena->free(upload.allocation.blocks);
+                pending_uploads.pop_front();
+                continue;
+            }
+
+            //NOTE: the previous version was drawn until now, its ranges wait for the next fence before they are handed out again
+            retire_ranges(allocation);
+            allocation.quads = upload.allocation.quads;
+            allocation.blocks = upload.allocation.blocks;
+            allocation.num_quads = upload.allocation.num_quads;
+
+            //NOTE: an edit removed the last face, the slot stays allocated but draws nothing
+            resident_chunks[upload.slot] = allocation.num_quads == 0 ? ResidentChunk {} : ResidentChunk {
+                allocation.num_quads * VERTICES_PER_QUAD,
+                allocation.quads.offset * VERTICES_PER_QUAD,
+                allocation.blocks.offset * (BLOCK_UNIT_BYTES / static_cast<uint32_t>(sizeof(unsigned int))),
+                0,
+                upload.position,
+                0
+            };
+            resident_dirty = true;
+            resident_generation++;
+            upload_stats.num_uploaded++;
+            pending_uploads.pop_front();
+        }
+    }
+
+    void ChunkRenderer::drain_uploads() {
+        const std::size_t first_new = pending_uploads.size();
+        auto& registry = ChunkRegistry::get_instance();
+        ChunkRegistry::Guard guard;
+
+        const std::size_t budget_bytes = static_cast<std::size_t>(std::max(upload_budget_kb, 1)) * 1000;
+        upload_stats.frame_bytes = upload_queue.drain(budget_bytes, [&](StagedMesh& mesh) {
+            return upload(registry, mesh);
+        });
+        upload_stats.max_frame_bytes = std::max(upload_stats.max_frame_bytes, upload_stats.frame_bytes);
+
+        //NOTE: one fence for the new copies and the ranges retired this frame (issued after every draw that read them)
+        const bool unfenced_ranges = !retired_ranges.empty() && retired_ranges.back().batch == 0;
+        if (pending_uploads.size() == first_new && !unfenced_ranges) return;
+        const uint64_t batch = upload_ring->fence();
+        for (std::size_t i {first_new}; i < pending_uploads.size(); i++) pending_uploads[i].batch = batch;
+        for (auto it = retired_ranges.rbegin(); it != retired_ranges.rend() && it->batch == 0; ++it) it->batch = batch;
+    }
+
+    void ChunkRenderer::upload_resident_chunks() {
+        if (!resident_dirty) return;
+        resident_dirty = false;
+
+        //NOTE: only on render set changes, orphaned like the draw buffers
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, resident_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, resident_chunks.size() * sizeof(ResidentChunk), resident_chunks.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    static int floor_to_chunk(float world_space_value) {
+        return static_cast<int>(std::floor(world_space_value / SIZE)) * SIZE;
+    }
+
+    void ChunkRenderer::update_cave_visibility() {
+        if (!cave_culling) {
+            cave_valid = false;
+            cave_generation = UINT64_MAX;
+            return;
+        }
+
+        const glm::ivec3 start_position(floor_to_chunk(camera_position.x), floor_to_chunk(camera_position.y), floor_to_chunk(camera_position.z));
+        //NOTE: resident_generation, not the render generation, a chunk only joins the search once it is drawable
+        if (start_position == cave_start && resident_generation == cave_generation) return;
+        cave_start = start_position;
+        cave_generation = resident_generation;
+
+        num_drawable = 0;
+        for (const auto& resident : resident_chunks) {
+            if (resident.num_vertices > 0) num_drawable++;
+        }
+
+        ChunkRegistry::Guard guard;
+        //NOTE: no chunk above/below the world, nothing to search from (everything stays visible)
+        Chunk* start = ChunkRegistry::get_instance().find(start_position);
+        cave_valid = start != nullptr;
+        if (!cave_valid) return;
+
+        cave_visible_slots.assign((resident_chunks.size() + 31) / 32, 0);
+        num_cave_visible = 0;
+        ChunkVisibility::find_visible_chunks(start, (ChunkManager::chunk_render_distance + 1) * SIZE, [this](Chunk& chunk) {
+            if (!chunk.allocated || resident_chunks[chunk.slot].num_vertices == 0) return;
+            cave_visible_slots[chunk.slot / 32] |= 1u << (chunk.slot % 32);
+            num_cave_visible++;
+        });
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, cave_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, cave_visible_slots.size() * sizeof(uint32_t), cave_visible_slots.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    }
+
+    void ChunkRenderer::cull(const Plane* frustum, Pass pass) {
+        auto& target = cull_targets[static_cast<int>(pass)];
+        const uint32_t num_resident = static_cast<uint32_t>(resident_chunks.size());
+
+        //NOTE: an earlier frame's survivors, only polled (a glGetBufferSubData on the count waits for the whole frame to finish)
+        if (target.readback_fence) {
+            const GLenum result = glClientWaitSync(target.readback_fence, 0, 0);
+            if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED) {
+                target.num_draws = *target.readback_mapped;
+                glDeleteSync(target.readback_fence);
+                target.readback_fence = nullptr;
+            }
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.count);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, sizeof(uint32_t), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+        if (target.capacity < num_resident) {
+            target.capacity = std::max(num_resident, target.capacity * 2);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.commands);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, target.capacity * sizeof(DrawArraysIndirectCommand), nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.draws);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, target.capacity * sizeof(ChunkDrawData), nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.commands);
+        glClearBufferSubData(GL_SHADER_STORAGE_BUFFER, GL_R32UI, 0, num_resident * sizeof(DrawArraysIndirectCommand), GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        //NOTE: the pyramid is the camera's depth, the light's view has nothing to test against
+        const bool occlusion = pass == Pass::Scene && occlusion_culling && hiz.is_valid();
+        const bool caves = pass == Pass::Scene && cave_culling && cave_valid;
+
+        auto& shader = ResourceManager::get_resource<Shader>(SHADER_CHUNK_CULL)
+            .use()
+            .set_uniform_int("num_resident", static_cast<int>(num_resident))
+            .set_uniform_int("chunk_size", SIZE)
+            .set_uniform_int("occlusion_enabled", occlusion ? 1 : 0)
+            .set_uniform_int("cave_culling_enabled", caves ? 1 : 0);
+        for (int i {0}; i < 6; i++) {
+            shader.set_uniform_vec4(FRUSTUM_PLANE_UNIFORMS[i], glm::vec4(frustum[i].a, frustum[i].b, frustum[i].c, frustum[i].d));
+        }
+        if (occlusion) {
+            shader
+                .set_uniform_int("hiz", 0)
+                .set_uniform_ivec2("hiz_size", hiz.get_size())
+                .set_uniform_int("hiz_levels", hiz.get_num_levels())
+                .set_uniform_mat4("hiz_view_projection", hiz.get_view_projection());
+            glActiveTexture(GL_TEXTURE0);
+            glBindTexture(GL_TEXTURE_2D, hiz.get_id());
+        }
+
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, resident_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, target.commands);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, target.draws);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, target.count);
+        if (caves) glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 4, cave_buffer);
+        glDispatchCompute((num_resident + CULL_GROUP_SIZE - 1) / CULL_GROUP_SIZE, 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+        //NOTE: one readback in flight per pass, the frames in between keep the last count
+        if (!target.readback_fence) {
+            glBindBuffer(GL_COPY_READ_BUFFER, target.count);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, target.readback);
+            glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER, 0, 0, sizeof(uint32_t));
+            glBindBuffer(GL_COPY_READ_BUFFER, 0);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            target.readback_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+
+        if (occlusion) glBindTexture(GL_TEXTURE_2D, 0);
+        if (verify_culling && pass == Pass::Scene) verify(frustum, target, occlusion || caves);
+    }
+
+    static float distance_to_frustum(const Plane* frustum, glm::vec3 min, glm::vec3 max) {
+        //NOTE: < 0 outside, the worst plane's distance of the box' positive vertex (same test as is_box_in_frustum)
+        float distance = std::numeric_limits<float>::max();
+        for (int i {0}; i < 6; i++) {
+            const Plane& p = frustum[i];
+            const glm::vec3 positive(p.a >= 0 ? max.x : min.x, p.b >= 0 ? max.y : min.y, p.c >= 0 ? max.z : min.z);
+            distance = std::min(distance, p.a * positive.x + p.b * positive.y + p.c * positive.z + p.d);
+        }
+        return distance;
+    }
+
+    void ChunkRenderer::verify(const Plane* frustum, const CullTarget& target, bool occlusion_applied) {
+        //NOTE: boxes this close to a plane may go either way between the cpu and the gpu float math
+        static constexpr float EPSILON = 0.01f;
+
+        uint32_t num_draws {0};
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.count);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(uint32_t), &num_draws);
+        std::vector<ChunkDrawData> gpu_draws(std::min<std::size_t>(num_draws, resident_chunks.size()));
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, target.draws);
+        glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, gpu_draws.size() * sizeof(ChunkDrawData), gpu_draws.data());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        ChunkDrawList cpu_draws;
+        for (const auto& resident : resident_chunks) {
+            if (resident.num_vertices == 0) continue;
+            if (!is_box_in_frustum(frustum, glm::vec3(resident.position), glm::vec3(resident.position + SIZE))) continue;
+            cpu_draws.add(resident.num_vertices, resident.first_vertex, resident.position, resident.block_offset);
+        }
+
+        auto by_block_offset = [](const ChunkDrawData& a, const ChunkDrawData& b) { return a.block_offset < b.block_offset; };
+        std::sort(gpu_draws.begin(), gpu_draws.end(), by_block_offset);
+        std::sort(cpu_draws.draws.begin(), cpu_draws.draws.end(), by_block_offset);
+
+        //CHECK: the gpu survivors are a subset of the cpu frustum test, without occlusion the same set
+        std::size_t num_mismatching {0};
+        for (const auto& draw : gpu_draws) {
+            const auto it = std::lower_bound(cpu_draws.draws.begin(), cpu_draws.draws.end(), draw, by_block_offset);
+            const bool found = it != cpu_draws.draws.end() && it->block_offset == draw.block_offset && it->position == draw.position;
+            if (!found && distance_to_frustum(frustum, glm::vec3(draw.position), glm::vec3(draw.position + SIZE)) < -EPSILON) num_mismatching++;
+        }
+        if (!occlusion_applied) {
+            for (const auto& draw : cpu_draws.draws) {
+                const bool found = std::binary_search(gpu_draws.begin(), gpu_draws.end(), draw, by_block_offset);
+                if (!found && distance_to_frustum(frustum, glm::vec3(draw.position), glm::vec3(draw.position + SIZE)) > EPSILON) num_mismatching++;
+            }
+        }
+
+        num_verified_passes++;
+        if (num_mismatching > 0) {
+            num_failed_verifications++;
+            plog_error("gpu culling: {} of {} chunks differ from the cpu frustum test (gpu {} / cpu {} visible)", num_mismatching, resident_chunks.size(), gpu_draws.size(), cpu_draws.size());
+        }
+    }
+
+    void ChunkRenderer::update_occlusion(GLuint depth_texture, int width, int height, const glm::mat4& view_projection) {
+        if (!occlusion_culling) {
+            hiz.invalidate();
+            return;
+        }
+        hiz.update(ResourceManager::get_resource<Shader>(SHADER_HIZ_DOWNSAMPLE), depth_texture, width, height, view_projection);
+    }
+
+    bool ChunkRenderer::upload(ChunkRegistry& registry, StagedMesh& mesh) {
+        //NOTE: true = done with the mesh (uploaded or dropped), false = the ring is full or a worker is meshing the chunk,
+        //      retried next frame (the render thread never waits for a build)
+        Chunk* chunk = registry.find(mesh.position);
+        if (!chunk) return true;
+
+        const uint32_t num_quads = static_cast<uint32_t>(mesh.quads.size());
+        const uint32_t quad_bytes = num_quads * static_cast<uint32_t>(sizeof(ChunkMesh::PackedQuad));
+        const uint32_t block_bytes = num_quads > 0 ? BLOCK_UNIT_BYTES : 0;
+        uint32_t ring_offset {0};
+        uint8_t* staging {nullptr};
+        unsigned int slot {0};
+        {
+            std::unique_lock<std::mutex> mesh_lock(chunk->mesh_mutex, std::try_to_lock);
+            if (!mesh_lock.owns_lock()) return false;
+            //NOTE: left the render set after the mesh was taken from the queue
+            if (!chunk->in_render_set) return true;
+            if (num_quads == 0 && !chunk->allocated) return true;
+
+            if (quad_bytes + block_bytes > 0) {
+                staging = upload_ring->allocate(quad_bytes + block_bytes, ring_offset);
+                if (!staging) return false;
+            }
+
+            if (!chunk->allocated) {
+                if (free_slots.empty()) {
+                    chunk->slot = static_cast<unsigned int>(allocations.size());
+                    allocations.emplace_back();
+                    resident_chunks.emplace_back();
+                    resident_dirty = true;
+                }
+                else {
+                    chunk->slot = free_slots.back();
+                    free_slots.pop_back();
+                }
+                chunk->allocated = true;
+            }
+            slot = chunk->slot;
+        }
+
+        //NOTE: fresh ranges, the current ones are drawn until the copies are fenced and complete
+        PendingUpload upload { 0, slot, allocations[slot].ticket, {}, mesh.position };
+        upload.allocation.num_quads = num_quads;
+        if (num_quads > 0) {
+            std::memcpy(staging, mesh.quads.data(), quad_bytes);
+            std::memcpy(staging + quad_bytes, mesh.blocks.data(), block_bytes);
+            upload.allocation.quads = quad_arena->allocate(num_quads);
+            upload.allocation.blocks = block_arena->allocate(1);
+            quad_arena->copy(upload_ring->get_id(), ring_offset, upload.allocation.quads, quad_bytes);
+            block_arena->copy(upload_ring->get_id(), ring_offset + quad_bytes, upload.allocation.blocks, block_bytes);
+        }
+        pending_uploads.push_back(upload);
+        return true;
+    }
+
+    ChunkRenderer::UploadStats ChunkRenderer::get_upload_stats() {
+        const auto queue_stats = upload_queue.get_stats();
+        UploadStats stats = upload_stats;
+        stats.num_queued = queue_stats.num_staged;
+        stats.queued_bytes = queue_stats.staged_bytes;
+        stats.num_in_flight = pending_uploads.size();
+        stats.ring_used = upload_ring->get_used();
+        stats.ring_capacity = upload_ring->get_capacity();
+        return stats;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "game/chunk_upload_queue.h"
+
+namespace Voxel::Game {
+    void ChunkUploadQueue::stage(const Chunk& chunk) {
+        //STAGING: copied before taking the lock, other workers and the render thread only wait for the hand-over
+        StagedMesh mesh;
+        mesh.position = chunk.position;
+        if (chunk.mesh) mesh.quads = chunk.mesh->quads;
+        mesh.blocks.resize(SIZE_CUBIC / NUM_VALUES_IN_ONE_UINT);
+        if (chunk.lod > 0) chunk.blocks.write_packed_reduced(mesh.blocks.data(), 1 << chunk.lod);
+        else chunk.blocks.write_packed(mesh.blocks.data());
+
+        std::lock_guard<std::mutex> lock(mutex);
+        const uint64_t key = ChunkRegistry::chunk_key(mesh.position);
+        if (auto it = queued.find(key); it != queued.end()) {
+            stats.staged_bytes -= it->second->mesh.size_bytes();
+            stats.staged_bytes += mesh.size_bytes();
+            it->second->mesh = std::move(mesh);
+            stats.num_replaced++;
+            return;
+        }
+
+        stats.staged_bytes += mesh.size_bytes();
+        entries.push_back(Entry { std::move(mesh) });
+        queued[key] = &entries.back();
+    }
+
+    void ChunkUploadQueue::cancel(glm::ivec3 position) {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = queued.find(ChunkRegistry::chunk_key(position));
+        if (it == queued.end()) return;
+
+        //NOTE: the entry stays in the deque until it reaches the front
+        stats.staged_bytes -= it->second->mesh.size_bytes();
+        it->second->cancelled = true;
+        it->second->mesh = StagedMesh {};
+        queued.erase(it);
+        stats.num_cancelled++;
+    }
+
+    std::size_t ChunkUploadQueue::drain(std::size_t budget_bytes, const std::function<bool(StagedMesh& mesh)>& upload) {
+        std::size_t drained_bytes {0};
+        while (true) {
+            StagedMesh mesh;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                while (!entries.empty() && entries.front().cancelled) entries.pop_front();
+                if (entries.empty()) break;
+
+                const std::size_t size_bytes = entries.front().mesh.size_bytes();
+                if (drained_bytes > 0 && drained_bytes + size_bytes > budget_bytes) break;
+
+                mesh = std::move(entries.front().mesh);
+                queued.erase(ChunkRegistry::chunk_key(mesh.position));
+                entries.pop_front();
+                stats.staged_bytes -= size_bytes;
+            }
+
+            const std::size_t size_bytes = mesh.size_bytes();
+            if (!upload(mesh)) {
+                //NOTE: back to the front, unless the chunk was staged again meanwhile (the newer mesh wins)
+                std::lock_guard<std::mutex> lock(mutex);
+                const uint64_t key = ChunkRegistry::chunk_key(mesh.position);
+                if (!queued.contains(key)) {
+                    stats.staged_bytes += size_bytes;
+                    entries.push_front(Entry { std::move(mesh) });
+                    queued[key] = &entries.front();
+                }
+                break;
+            }
+
+            drained_bytes += size_bytes;
+            std::lock_guard<std::mutex> lock(mutex);
+            stats.num_drained++;
+        }
+        return drained_bytes;
+    }
+
+    void ChunkUploadQueue::clear() {
+        std::lock_guard<std::mutex> lock(mutex);
+        entries.clear();
+        queued.clear();
+        stats.staged_bytes = 0;
+    }
+
+    ChunkUploadQueue::Stats ChunkUploadQueue::get_stats() {
+        std::lock_guard<std::mutex> lock(mutex);
+        Stats result = stats;
+        result.num_staged = queued.size();
+        return result;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,142 @@
+#include "game/chunk_visibility.h"
+
+#include <array>
+#include <cstdlib>
+#include <unordered_set>
+#include <vector>
+#include "game/chunk.h"
+
+namespace Voxel::Game::ChunkVisibility {
+    //NOTE: rows are indexed z + y * SIZE and hold one bit per x, like the chunk's first occupancy block
+    using Rows = std::array<ChunkRow, SIZE * SIZE>;
+
+    static ChunkRow expand_along_row(ChunkRow bits, ChunkRow air) {
+        //NOTE: grows the bits to the whole air runs they are part of
+        ChunkRow expanded = bits & air;
+        while (true) {
+            const ChunkRow next = static_cast<ChunkRow>((expanded | (expanded << 1) | (expanded >> 1)) & air);
+            if (next == expanded) return expanded;
+            expanded = next;
+        }
+    }
+
+    static void flood_fill(Rows& component, const Rows& air) {
+        //NOTE: row parallel fill, sweeps alternate direction until nothing grows anymore
+        bool changed {true};
+        for (int sweep {0}; changed; sweep++) {
+            changed = false;
+            for (int i {0}; i < SIZE * SIZE; i++) {
+                const int row = sweep % 2 == 0 ? i : SIZE * SIZE - 1 - i;
+                if (!air[row]) continue;
+
+                const int z = row % SIZE;
+                const int y = row / SIZE;
+                ChunkRow bits = component[row];
+                if (z > 0) bits |= component[row - 1];
+                if (z < SIZE - 1) bits |= component[row + 1];
+                if (y > 0) bits |= component[row - SIZE];
+                if (y < SIZE - 1) bits |= component[row + SIZE];
+                bits = expand_along_row(bits, air[row]);
+
+                if (bits != component[row]) {
+                    component[row] = bits;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    static uint8_t touched_faces(const Rows& component) {
+        uint8_t faces {0};
+        for (int y {0}; y < SIZE; y++) {
+            for (int z {0}; z < SIZE; z++) {
+                const ChunkRow bits = component[z + y * SIZE];
+                if (!bits) continue;
+
+                if (bits & 1) faces |= 1 << NeighbourLeft;
+                if (bits >> (SIZE - 1)) faces |= 1 << NeighbourRight;
+                if (z == 0) faces |= 1 << NeighbourFront;
+                if (z == SIZE - 1) faces |= 1 << NeighbourBack;
+                if (y == 0) faces |= 1 << NeighbourBottom;
+                if (y == SIZE - 1) faces |= 1 << NeighbourTop;
+            }
+        }
+        return faces;
+    }
+
+    static bool find_boundary_seed(const Rows& remaining, int& seed_row, ChunkRow& seed_bits) {
+        constexpr ChunkRow X_BORDER = ChunkRow {1} | (ChunkRow {1} << (SIZE - 1));
+        for (int y {0}; y < SIZE; y++) {
+            for (int z {0}; z < SIZE; z++) {
+                const int row = z + y * SIZE;
+                const bool row_on_border = y == 0 || y == SIZE - 1 || z == 0 || z == SIZE - 1;
+                const ChunkRow candidates = row_on_border ? remaining[row] : static_cast<ChunkRow>(remaining[row] & X_BORDER);
+                if (!candidates) continue;
+
+                seed_row = row;
+                seed_bits = static_cast<ChunkRow>(candidates & -candidates);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    uint64_t compute_face_connectivity(const ChunkRow* voxels) {
+        if (!voxels) return ALL_FACES_CONNECTED;
+
+        Rows remaining;
+        for (int row {0}; row < SIZE * SIZE; row++) remaining[row] = static_cast<ChunkRow>(~voxels[row]);
+
+        //COMPONENTS: only air regions that reach the border can connect faces, enclosed pockets are never seeded
+        uint64_t connectivity {0};
+        int seed_row {0};
+        ChunkRow seed_bits {0};
+        while (find_boundary_seed(remaining, seed_row, seed_bits)) {
+            Rows component {};
+            component[seed_row] = seed_bits;
+            flood_fill(component, remaining);
+
+            const uint8_t faces = touched_faces(component);
+            for (int a {0}; a < NumNeighbours; a++) {
+                if (!(faces & (1 << a))) continue;
+                for (int b {0}; b < NumNeighbours; b++) {
+                    if (faces & (1 << b)) connectivity |= 1ull << (a * NumNeighbours + b);
+                }
+            }
+
+            for (int row {0}; row < SIZE * SIZE; row++) remaining[row] &= ~component[row];
+        }
+        return connectivity;
+    }
+
+    void find_visible_chunks(Chunk* start, int max_distance, const std::function<void(Chunk&)>& visit) {
+        struct Step {
+            Chunk* chunk;
+            //NOTE: face the search came in through, -1 for the start chunk (it can leave through any face)
+            int entered;
+            //NOTE: directions the path took so far, the search never steps against one of them
+            uint8_t directions;
+        };
+
+        std::vector<Step> queue { Step { start, -1, 0 } };
+        std::unordered_set<Chunk*> reached { start };
+        for (std::size_t head {0}; head < queue.size(); head++) {
+            const Step step = queue[head];
+            visit(*step.chunk);
+
+            const uint64_t connectivity = step.chunk->face_connectivity.load(std::memory_order_relaxed);
+            for (int out {0}; out < NumNeighbours; out++) {
+                if (step.directions & (1 << ChunkRegistry::opposite(out))) continue;
+                if (step.entered >= 0 && !are_faces_connected(connectivity, step.entered, out)) continue;
+
+                Chunk* neighbour = step.chunk->neighbour_chunks[out].load();
+                if (!neighbour || reached.contains(neighbour)) continue;
+                if (std::abs(neighbour->position.x - start->position.x) > max_distance || std::abs(neighbour->position.z - start->position.z) > max_distance)
+                    continue;
+
+                reached.insert(neighbour);
+                queue.push_back(Step { neighbour, ChunkRegistry::opposite(out), static_cast<uint8_t>(step.directions | (1 << out)) });
+            }
+        }
+    }
+}
\ No newline at end of file
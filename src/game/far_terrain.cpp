@@ -0,0 +1,195 @@
+#include "game/far_terrain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace Voxel::Game {
+    int FarTerrain::far_distance {2048};
+    float FarTerrain::split_factor {2.f};
+    int FarTerrain::max_pending_tiles {8};
+    std::size_t FarTerrain::cache_budget_tiles {512};
+    unsigned int FarTerrain::num_worker_threads {1};
+
+    static int64_t tile_key(int level, glm::ivec2 tile) {
+        return (static_cast<int64_t>(level) << 56)
+            | (static_cast<int64_t>(static_cast<uint32_t>(tile.x) & 0xFFFFFFF) << 28)
+            | static_cast<int64_t>(static_cast<uint32_t>(tile.y) & 0xFFFFFFF);
+    }
+
+    static int floor_div(int value, int divisor) {
+        return (value >= 0 ? value : value - (divisor - 1)) / divisor;
+    }
+
+    FarTerrain::FarTerrain() {
+        job_system = std::make_unique<JobSystem>(num_worker_threads);
+    }
+
+    FarTerrain::Tile FarTerrain::generate_tile(Noise& noise, int level, glm::ivec2 tile) {
+        Tile result;
+        result.key = tile_key(level, tile);
+        result.level = level;
+        result.spacing = BASE_SPACING << level;
+        result.origin = tile * tile_size(level);
+        result.heights.resize(NUM_SAMPLES);
+        noise.fetch_heightmap_samples(result.origin.x, result.origin.y, RESOLUTION + 1, result.spacing, result.heights.data());
+
+        //NOTE: the column's top face, one above its highest block
+        for (float& height : result.heights) height += 1.f;
+        auto [height_min, height_max] = std::minmax_element(result.heights.begin(), result.heights.end());
+        result.min_height = *height_min;
+        result.max_height = *height_max;
+        return result;
+    }
+
+    void FarTerrain::select(int level, glm::ivec2 tile, glm::vec2 position, float inner_distance) {
+        const float size = static_cast<float>(tile_size(level));
+        const glm::vec2 tile_min = glm::vec2(tile) * size;
+        const glm::vec2 tile_max = tile_min + size;
+
+        const float distance_min = glm::length(glm::clamp(position, tile_min, tile_max) - position);
+        const glm::vec2 farthest(
+            std::max(std::abs(tile_min.x - position.x), std::abs(tile_max.x - position.x)),
+            std::max(std::abs(tile_min.y - position.y), std::abs(tile_max.y - position.y))
+        );
+        if (distance_min > static_cast<float>(far_distance)) return;
+        //NOTE: entirely covered by voxel chunks
+        if (glm::length(farthest) < inner_distance) return;
+
+        if (level > 0 && distance_min < split_factor * size) {
+            for (int z {0}; z < 2; z++) {
+                for (int x {0}; x < 2; x++) select(level - 1, tile * 2 + glm::ivec2(x, z), position, inner_distance);
+            }
+            return;
+        }
+
+        selected.push_back(Selected { level, tile, tile_key(level, tile), distance_min });
+    }
+
+    void FarTerrain::update(glm::vec3 position, float inner_distance) {
+        const auto start = std::chrono::steady_clock::now();
+        iteration++;
+
+        //SELECT: the roots are the tiles of the coarsest level around the player
+        const glm::vec2 position_xz(position.x, position.z);
+        const int root_size = tile_size(MAX_LEVEL);
+        selected.clear();
+        for (int z = floor_div(static_cast<int>(position.z) - far_distance, root_size); z <= floor_div(static_cast<int>(position.z) + far_distance, root_size); z++) {
+            for (int x = floor_div(static_cast<int>(position.x) - far_distance, root_size); x <= floor_div(static_cast<int>(position.x) + far_distance, root_size); x++) {
+                select(MAX_LEVEL, glm::ivec2(x, z), position_xz, inner_distance);
+            }
+        }
+        std::sort(selected.begin(), selected.end(), [](const Selected& a, const Selected& b) { return a.distance < b.distance; });
+
+        collect_generated();
+
+        //GENERATE: missing tiles nearest first, only as many as keep max_pending_tiles in flight
+        //NOTE: a tile that left the selection while it was generated is still cached (the lru evicts it)
+        std::vector<JobSystem::Job> jobs;
+        for (auto& leaf : selected) {
+            auto it = tiles.find(leaf.key);
+            if (it != tiles.end()) {
+                it->second.last_used = iteration;
+                continue;
+            }
+            if (pending.contains(leaf.key) || pending.size() >= static_cast<std::size_t>(std::max(max_pending_tiles, 1))) continue;
+
+            pending.insert(leaf.key);
+            jobs.push_back(JobSystem::Job {
+                [this, level = leaf.level, tile = leaf.tile] {
+                    const auto generation_start = std::chrono::steady_clock::now();
+                    Tile result = generate_tile(noise, level, tile);
+                    const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - generation_start).count();
+
+                    std::lock_guard<std::mutex> lock(generated_mutex);
+                    generated.push_back(std::move(result));
+                    generated_seconds += seconds;
+                },
+                static_cast<int>(leaf.distance)
+            });
+        }
+        job_system->submit_batch(jobs);
+
+        evict();
+
+        //VISIBLE: the generated leaves, a new version only if the set changed
+        std::vector<int64_t> keys;
+        visible.clear();
+        for (auto& leaf : selected) {
+            auto it = tiles.find(leaf.key);
+            if (it == tiles.end()) continue;
+            visible.push_back(&it->second);
+            keys.push_back(leaf.key);
+        }
+        if (keys != visible_keys) {
+            visible_keys = std::move(keys);
+            version++;
+        }
+
+        stats.num_selected = selected.size();
+        stats.num_visible = visible.size();
+        stats.num_cached = tiles.size();
+        stats.num_pending = pending.size();
+        stats.update_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    void FarTerrain::collect_generated() {
+        std::vector<Tile> finished;
+        {
+            std::lock_guard<std::mutex> lock(generated_mutex);
+            finished.swap(generated);
+            stats.generation_seconds += generated_seconds;
+            generated_seconds = 0.;
+        }
+
+        for (auto& tile : finished) {
+            pending.erase(tile.key);
+            auto [it, inserted] = tiles.try_emplace(tile.key, std::move(tile));
+            if (!inserted) continue;
+
+            it->second.last_used = iteration;
+            stats.cache_bytes += sizeof(Tile) + it->second.heights.capacity() * sizeof(float);
+            stats.num_generated++;
+        }
+    }
+
+    void FarTerrain::wait() {
+        job_system->wait();
+    }
+
+    void FarTerrain::evict() {
+        if (tiles.size() <= cache_budget_tiles) return;
+
+        //LRU: the tiles of the current selection stay
+        std::vector<std::pair<uint64_t, int64_t>> candidates;
+        for (auto& [key, tile] : tiles) {
+            if (tile.last_used != iteration) candidates.push_back({ tile.last_used, key });
+        }
+        std::sort(candidates.begin(), candidates.end());
+
+        for (auto& [_, key] : candidates) {
+            if (tiles.size() <= cache_budget_tiles) break;
+
+            auto it = tiles.find(key);
+            stats.cache_bytes -= sizeof(Tile) + it->second.heights.capacity() * sizeof(float);
+            tiles.erase(it);
+            stats.num_evicted++;
+        }
+    }
+
+    FarTerrain::Stats FarTerrain::get_stats() const {
+        return stats;
+    }
+
+    void FarTerrain::clear() {
+        tiles.clear();
+        selected.clear();
+        visible.clear();
+        visible_keys.clear();
+        stats.cache_bytes = 0;
+        stats.num_cached = 0;
+        stats.num_selected = 0;
+        stats.num_visible = 0;
+        version++;
+    }
+}
\ No newline at end of file
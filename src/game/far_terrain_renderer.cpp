@@ -0,0 +1,109 @@
+#include "game/far_terrain_renderer.h"
+
+#include <unordered_set>
+
+namespace Voxel::Game {
+    static constexpr uint32_t INITIAL_SLOTS = 128;
+    static constexpr uint32_t SLOT_BYTES = FarTerrain::NUM_SAMPLES * sizeof(float);
+    //NOTE: the grid cells plus one skirt cell on every side, two triangles per cell
+    static constexpr uint32_t VERTICES_PER_TILE = (FarTerrain::RESOLUTION + 2) * (FarTerrain::RESOLUTION + 2) * 6;
+    static constexpr GLuint HEIGHT_BINDING = 5;
+    static constexpr GLuint DRAW_BINDING = 6;
+
+    FarTerrainRenderer::FarTerrainRenderer() {
+        //NOTE: stays empty, the core profile only needs one bound to draw
+        glGenVertexArrays(1, &vertex_array);
+        glGenBuffers(1, &height_buffer);
+        glGenBuffers(1, &command_buffer);
+        glGenBuffers(1, &draw_buffer);
+        grow(INITIAL_SLOTS);
+    }
+
+    FarTerrainRenderer::~FarTerrainRenderer() {
+        glDeleteBuffers(1, &draw_buffer);
+        glDeleteBuffers(1, &command_buffer);
+        glDeleteBuffers(1, &height_buffer);
+        glDeleteVertexArrays(1, &vertex_array);
+    }
+
+    void FarTerrainRenderer::grow(uint32_t new_capacity) {
+        //NOTE: the content is dropped, every tile is uploaded again by the caller
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, height_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(new_capacity) * SLOT_BYTES, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        capacity = new_capacity;
+        resident.clear();
+        free_slots.clear();
+        for (uint32_t slot = capacity; slot > 0; slot--) free_slots.push_back(slot - 1);
+    }
+
+    void FarTerrainRenderer::update(const FarTerrain& terrain) {
+        if (terrain.get_version() == synced_version) return;
+        synced_version = terrain.get_version();
+
+        const auto& tiles = terrain.get_visible_tiles();
+        if (tiles.size() > capacity) {
+            uint32_t new_capacity = capacity;
+            while (new_capacity < tiles.size()) new_capacity *= 2;
+            grow(new_capacity);
+        }
+
+        //RELEASE: tiles that are no longer visible
+        std::unordered_set<int64_t> keys;
+        for (const FarTerrain::Tile* tile : tiles) keys.insert(tile->key);
+        for (auto it = resident.begin(); it != resident.end();) {
+            if (keys.contains(it->first)) {
+                it++;
+                continue;
+            }
+            free_slots.push_back(it->second);
+            it = resident.erase(it);
+        }
+
+        //UPLOAD: a few KB per new tile
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, height_buffer);
+        commands.clear();
+        draws.clear();
+        for (const FarTerrain::Tile* tile : tiles) {
+            auto [it, inserted] = resident.try_emplace(tile->key, 0);
+            if (inserted) {
+                it->second = free_slots.back();
+                free_slots.pop_back();
+                glBufferSubData(GL_SHADER_STORAGE_BUFFER, static_cast<GLintptr>(it->second) * SLOT_BYTES, SLOT_BYTES, tile->heights.data());
+            }
+            commands.push_back(DrawArraysIndirectCommand { VERTICES_PER_TILE, 1, 0, static_cast<uint32_t>(commands.size()) });
+            draws.push_back(glm::vec4(tile->origin.x, tile->origin.y, tile->spacing, static_cast<float>(it->second * FarTerrain::NUM_SAMPLES)));
+        }
+
+        //COMMANDS: new storage every time (orphaned), the gpu may still read the previous frame's
+        num_draws = static_cast<GLsizei>(commands.size());
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, draw_buffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, static_cast<GLsizeiptr>(draws.size() * sizeof(glm::vec4)), draws.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glBufferData(GL_DRAW_INDIRECT_BUFFER, static_cast<GLsizeiptr>(commands.size() * sizeof(DrawArraysIndirectCommand)), commands.data(), GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+
+    void FarTerrainRenderer::render(Shader& shader, const glm::mat4& view_projection, glm::vec3 camera_position, float inner_distance, glm::vec3 light_direction) {
+        if (num_draws == 0) return;
+
+        shader.use()
+            .set_uniform_mat4("view_projection", view_projection)
+            .set_uniform_vec4("camera", glm::vec4(camera_position, inner_distance))
+            .set_uniform_vec3("light_direction", light_direction);
+
+        //NOTE: the skirts are seen from both sides
+        const GLboolean cull_face = glIsEnabled(GL_CULL_FACE);
+        glDisable(GL_CULL_FACE);
+        glBindVertexArray(vertex_array);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, HEIGHT_BINDING, height_buffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, DRAW_BINDING, draw_buffer);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, command_buffer);
+        glMultiDrawArraysIndirect(GL_TRIANGLES, nullptr, num_draws, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+        glBindVertexArray(0);
+        if (cull_face) glEnable(GL_CULL_FACE);
+    }
+}
\ No newline at end of file
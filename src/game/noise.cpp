@@ -1,11 +1,19 @@
 #include "game/noise.h"
 
+#include <algorithm>
+#include <bit>
+#include <vector>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "core/log.h"
+
 namespace Voxel {
     inline float normalize_noise(float noise) {
         return (noise + 1.f) * .5f;
     }
 
-    Noise::Noise() {
+    static void configure(FastNoiseLite& terrain_noise, FastNoiseLite& biome_noise) {
         biome_noise.SetNoiseType(FastNoiseLite::NoiseType_Perlin);
 
         terrain_noise.SetNoiseType(FastNoiseLite::NoiseType_OpenSimplex2);
@@ -14,6 +22,315 @@ namespace Voxel {
         terrain_noise.SetFractalLacunarity(2.f);
     }
 
+#ifdef __AVX2__
+    //SIMD: 8 samples of FastNoiseLite's Perlin (2d), OpenSimplex2 (2d and 3d) and FBm per call, ported operation by operation
+    //      (same constants, same evaluation order, its FastFloor/FastRound), noise.cpp is built with -ffp-contract=off so neither
+    //      side fuses a multiply-add, vectorization_supported() compares both before the kernels are used
+    namespace Simd {
+        constexpr int PRIME_X = 501125321;
+        constexpr int PRIME_Y = 1136930381;
+        constexpr int PRIME_Z = 1720413743;
+        //NOTE: FastNoiseLite's defaults, configure() keeps them
+        constexpr int SEED = 1337;
+        constexpr float FREQUENCY = .01f;
+        constexpr float GAIN = .5f;
+        //NOTE: terrain fbm, as configure() sets it
+        constexpr int OCTAVES = 5;
+        constexpr float LACUNARITY = 2.f;
+
+        //NOTE: FastNoiseLite's Gradients2D / Gradients3D
+        #define GRADIENTS_2D_CYCLE \
+            0.130526192220052f, 0.99144486137381f, 0.38268343236509f, 0.923879532511287f, 0.608761429008721f, 0.793353340291235f, 0.793353340291235f, 0.608761429008721f, \
+            0.923879532511287f, 0.38268343236509f, 0.99144486137381f, 0.130526192220051f, 0.99144486137381f, -0.130526192220051f, 0.923879532511287f, -0.38268343236509f, \
+            0.793353340291235f, -0.60876142900872f, 0.608761429008721f, -0.793353340291235f, 0.38268343236509f, -0.923879532511287f, 0.130526192220052f, -0.99144486137381f, \
+            -0.130526192220052f, -0.99144486137381f, -0.38268343236509f, -0.923879532511287f, -0.608761429008721f, -0.793353340291235f, -0.793353340291235f, -0.608761429008721f, \
+            -0.923879532511287f, -0.38268343236509f, -0.99144486137381f, -0.130526192220052f, -0.99144486137381f, 0.130526192220051f, -0.923879532511287f, 0.38268343236509f, \
+            -0.793353340291235f, 0.608761429008721f, -0.608761429008721f, 0.793353340291235f, -0.38268343236509f, 0.923879532511287f, -0.130526192220052f, 0.99144486137381f,
+        alignas(32) static constexpr float GRADIENTS_2D[256] {
+            GRADIENTS_2D_CYCLE GRADIENTS_2D_CYCLE GRADIENTS_2D_CYCLE GRADIENTS_2D_CYCLE GRADIENTS_2D_CYCLE
+            0.38268343236509f, 0.923879532511287f, 0.923879532511287f, 0.38268343236509f, 0.923879532511287f, -0.38268343236509f, 0.38268343236509f, -0.923879532511287f,
+            -0.38268343236509f, -0.923879532511287f, -0.923879532511287f, -0.38268343236509f, -0.923879532511287f, 0.38268343236509f, -0.38268343236509f, 0.923879532511287f,
+        };
+        #undef GRADIENTS_2D_CYCLE
+
+        #define GRADIENTS_3D_CYCLE \
+            0, 1, 1, 0,  0, -1, 1, 0,  0, 1, -1, 0,  0, -1, -1, 0, \
+            1, 0, 1, 0,  -1, 0, 1, 0,  1, 0, -1, 0,  -1, 0, -1, 0, \
+            1, 1, 0, 0,  -1, 1, 0, 0,  1, -1, 0, 0,  -1, -1, 0, 0,
+        alignas(32) static constexpr float GRADIENTS_3D[256] {
+            GRADIENTS_3D_CYCLE GRADIENTS_3D_CYCLE GRADIENTS_3D_CYCLE GRADIENTS_3D_CYCLE GRADIENTS_3D_CYCLE
+            1, 1, 0, 0,  0, -1, 1, 0,  -1, 1, 0, 0,  0, -1, -1, 0,
+        };
+        #undef GRADIENTS_3D_CYCLE
+
+        static __m256 add(__m256 a, __m256 b) { return _mm256_add_ps(a, b); }
+        static __m256 sub(__m256 a, __m256 b) { return _mm256_sub_ps(a, b); }
+        static __m256 mul(__m256 a, __m256 b) { return _mm256_mul_ps(a, b); }
+        static __m256 set(float value) { return _mm256_set1_ps(value); }
+        static __m256i set(int value) { return _mm256_set1_epi32(value); }
+        static __m256 to_float(__m256i value) { return _mm256_cvtepi32_ps(value); }
+
+        //NOTE: FastFloor, (int)f - 1 for every negative f (integers too), FastRound, (int)(f -+ .5f)
+        static __m256i fast_floor(__m256 f) {
+            const __m256 negative = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_NGE_UQ);
+            return _mm256_add_epi32(_mm256_cvttps_epi32(f), _mm256_castps_si256(negative));
+        }
+
+        static __m256i fast_round(__m256 f) {
+            const __m256 positive = _mm256_cmp_ps(f, _mm256_setzero_ps(), _CMP_GE_OQ);
+            return _mm256_cvttps_epi32(_mm256_blendv_ps(sub(f, set(.5f)), add(f, set(.5f)), positive));
+        }
+
+        static __m256 lerp(__m256 a, __m256 b, __m256 t) {
+            return add(a, mul(t, sub(b, a)));
+        }
+
+        static __m256 interp_quintic(__m256 t) {
+            return mul(mul(mul(t, t), t), add(mul(t, sub(mul(t, set(6.f)), set(15.f))), set(10.f)));
+        }
+
+        //NOTE: (a * a) * (a * a) * gradient where a > 0, else 0
+        static __m256 falloff(__m256 a, __m256 gradient) {
+            const __m256 positive = _mm256_cmp_ps(a, _mm256_setzero_ps(), _CMP_GT_OQ);
+            const __m256 a2 = mul(a, a);
+            return _mm256_and_ps(mul(mul(a2, a2), gradient), positive);
+        }
+
+        static __m256i hash(__m256i seed, __m256i x_primed, __m256i y_primed) {
+            return _mm256_mullo_epi32(_mm256_xor_si256(_mm256_xor_si256(seed, x_primed), y_primed), set(0x27d4eb2d));
+        }
+
+        static __m256 gradient(__m256i seed, __m256i x_primed, __m256i y_primed, __m256 xd, __m256 yd) {
+            __m256i index = hash(seed, x_primed, y_primed);
+            index = _mm256_and_si256(_mm256_xor_si256(index, _mm256_srai_epi32(index, 15)), set(127 << 1));
+            const __m256 xg = _mm256_i32gather_ps(GRADIENTS_2D, index, 4);
+            const __m256 yg = _mm256_i32gather_ps(GRADIENTS_2D, _mm256_or_si256(index, set(1)), 4);
+            return add(mul(xd, xg), mul(yd, yg));
+        }
+
+        static __m256 gradient(__m256i seed, __m256i x_primed, __m256i y_primed, __m256i z_primed, __m256 xd, __m256 yd, __m256 zd) {
+            __m256i index = hash(_mm256_xor_si256(seed, x_primed), y_primed, z_primed);
+            index = _mm256_and_si256(_mm256_xor_si256(index, _mm256_srai_epi32(index, 15)), set(63 << 2));
+            const __m256 xg = _mm256_i32gather_ps(GRADIENTS_3D, index, 4);
+            const __m256 yg = _mm256_i32gather_ps(GRADIENTS_3D, _mm256_or_si256(index, set(1)), 4);
+            const __m256 zg = _mm256_i32gather_ps(GRADIENTS_3D, _mm256_or_si256(index, set(2)), 4);
+            return add(add(mul(xd, xg), mul(yd, yg)), mul(zd, zg));
+        }
+
+        //NOTE: SinglePerlin
+        static __m256 perlin(__m256i seed, __m256 x, __m256 y) {
+            __m256i x0 = fast_floor(x);
+            __m256i y0 = fast_floor(y);
+            const __m256 xd0 = sub(x, to_float(x0));
+            const __m256 yd0 = sub(y, to_float(y0));
+            const __m256 xd1 = sub(xd0, set(1.f));
+            const __m256 yd1 = sub(yd0, set(1.f));
+            const __m256 xs = interp_quintic(xd0);
+            const __m256 ys = interp_quintic(yd0);
+
+            x0 = _mm256_mullo_epi32(x0, set(PRIME_X));
+            y0 = _mm256_mullo_epi32(y0, set(PRIME_Y));
+            const __m256i x1 = _mm256_add_epi32(x0, set(PRIME_X));
+            const __m256i y1 = _mm256_add_epi32(y0, set(PRIME_Y));
+
+            const __m256 xf0 = lerp(gradient(seed, x0, y0, xd0, yd0), gradient(seed, x1, y0, xd1, yd0), xs);
+            const __m256 xf1 = lerp(gradient(seed, x0, y1, xd0, yd1), gradient(seed, x1, y1, xd1, yd1), xs);
+            return mul(lerp(xf0, xf1, ys), set(1.4247691104677813f));
+        }
+
+        //NOTE: SingleSimplex (2d OpenSimplex2), x and y are already skewed
+        static __m256 simplex(__m256i seed, __m256 x, __m256 y) {
+            constexpr float SQRT3 = 1.7320508075688772935274463415059f;
+            constexpr float G2 = (3 - SQRT3) / 6;
+
+            __m256i i = fast_floor(x);
+            __m256i j = fast_floor(y);
+            const __m256 xi = sub(x, to_float(i));
+            const __m256 yi = sub(y, to_float(j));
+            const __m256 t = mul(add(xi, yi), set(G2));
+            const __m256 x0 = sub(xi, t);
+            const __m256 y0 = sub(yi, t);
+
+            i = _mm256_mullo_epi32(i, set(PRIME_X));
+            j = _mm256_mullo_epi32(j, set(PRIME_Y));
+
+            const __m256 a = sub(sub(set(.5f), mul(x0, x0)), mul(y0, y0));
+            const __m256 n0 = falloff(a, gradient(seed, i, j, x0, y0));
+
+            const __m256 c = add(
+                mul(set(static_cast<float>(2 * (1 - 2 * G2) * (1 / G2 - 2))), t),
+                add(set(static_cast<float>(-2 * (1 - 2 * G2) * (1 - 2 * G2))), a)
+            );
+            const __m256 x2 = add(x0, set(2 * G2 - 1));
+            const __m256 y2 = add(y0, set(2 * G2 - 1));
+            const __m256 n2 = falloff(c, gradient(seed, _mm256_add_epi32(i, set(PRIME_X)), _mm256_add_epi32(j, set(PRIME_Y)), x2, y2));
+
+            //NOTE: y0 > x0 takes the corner (0, 1), otherwise (1, 0)
+            const __m256 upper = _mm256_cmp_ps(y0, x0, _CMP_GT_OQ);
+            const __m256 x1 = _mm256_blendv_ps(add(x0, set(G2 - 1)), add(x0, set(G2)), upper);
+            const __m256 y1 = _mm256_blendv_ps(add(y0, set(G2)), add(y0, set(G2 - 1)), upper);
+            const __m256i i1 = _mm256_blendv_epi8(_mm256_add_epi32(i, set(PRIME_X)), i, _mm256_castps_si256(upper));
+            const __m256i j1 = _mm256_blendv_epi8(j, _mm256_add_epi32(j, set(PRIME_Y)), _mm256_castps_si256(upper));
+            const __m256 b = sub(sub(set(.5f), mul(x1, x1)), mul(y1, y1));
+            const __m256 n1 = falloff(b, gradient(seed, i1, j1, x1, y1));
+
+            return mul(add(add(n0, n1), n2), set(99.83685446303647f));
+        }
+
+        //NOTE: SingleOpenSimplex2 (3d), x, y and z are already rotated
+        static __m256 open_simplex(__m256i seed, __m256 x, __m256 y, __m256 z) {
+            __m256i i = fast_round(x);
+            __m256i j = fast_round(y);
+            __m256i k = fast_round(z);
+            __m256 x0 = sub(x, to_float(i));
+            __m256 y0 = sub(y, to_float(j));
+            __m256 z0 = sub(z, to_float(k));
+
+            //NOTE: -1 or 1, (int)(-1.0f - x0) | 1
+            __m256i x_sign = _mm256_or_si256(_mm256_cvttps_epi32(sub(set(-1.f), x0)), set(1));
+            __m256i y_sign = _mm256_or_si256(_mm256_cvttps_epi32(sub(set(-1.f), y0)), set(1));
+            __m256i z_sign = _mm256_or_si256(_mm256_cvttps_epi32(sub(set(-1.f), z0)), set(1));
+
+            const __m256 sign_bit = set(-0.f);
+            __m256 ax0 = mul(to_float(x_sign), _mm256_xor_ps(x0, sign_bit));
+            __m256 ay0 = mul(to_float(y_sign), _mm256_xor_ps(y0, sign_bit));
+            __m256 az0 = mul(to_float(z_sign), _mm256_xor_ps(z0, sign_bit));
+
+            i = _mm256_mullo_epi32(i, set(PRIME_X));
+            j = _mm256_mullo_epi32(j, set(PRIME_Y));
+            k = _mm256_mullo_epi32(k, set(PRIME_Z));
+
+            __m256 value = _mm256_setzero_ps();
+            __m256 a = sub(sub(set(.6f), mul(x0, x0)), add(mul(y0, y0), mul(z0, z0)));
+
+            for (int lattice {0}; ; lattice++) {
+                value = add(value, falloff(a, gradient(seed, i, j, k, x0, y0, z0)));
+
+                //NOTE: the nearest corner of the other lattice along the dominant axis
+                const __m256 along_x = _mm256_and_ps(_mm256_cmp_ps(ax0, ay0, _CMP_GE_OQ), _mm256_cmp_ps(ax0, az0, _CMP_GE_OQ));
+                const __m256 along_y = _mm256_andnot_ps(along_x, _mm256_and_ps(_mm256_cmp_ps(ay0, ax0, _CMP_GT_OQ), _mm256_cmp_ps(ay0, az0, _CMP_GE_OQ)));
+                const __m256 along_z = _mm256_andnot_ps(_mm256_or_ps(along_x, along_y), _mm256_castsi256_ps(set(-1)));
+
+                const __m256 x1_moved = add(x0, to_float(x_sign));
+                const __m256 y1_moved = add(y0, to_float(y_sign));
+                const __m256 z1_moved = add(z0, to_float(z_sign));
+                const __m256 x1 = _mm256_blendv_ps(x0, x1_moved, along_x);
+                const __m256 y1 = _mm256_blendv_ps(y0, y1_moved, along_y);
+                const __m256 z1 = _mm256_blendv_ps(z0, z1_moved, along_z);
+
+                const __m256 x_term = mul(to_float(_mm256_slli_epi32(x_sign, 1)), x1_moved);
+                const __m256 y_term = mul(to_float(_mm256_slli_epi32(y_sign, 1)), y1_moved);
+                const __m256 z_term = mul(to_float(_mm256_slli_epi32(z_sign, 1)), z1_moved);
+                const __m256 b = sub(add(a, set(1.f)), _mm256_blendv_ps(_mm256_blendv_ps(z_term, y_term, along_y), x_term, along_x));
+
+                const __m256i i1 = _mm256_blendv_epi8(i, _mm256_sub_epi32(i, _mm256_mullo_epi32(x_sign, set(PRIME_X))), _mm256_castps_si256(along_x));
+                const __m256i j1 = _mm256_blendv_epi8(j, _mm256_sub_epi32(j, _mm256_mullo_epi32(y_sign, set(PRIME_Y))), _mm256_castps_si256(along_y));
+                const __m256i k1 = _mm256_blendv_epi8(k, _mm256_sub_epi32(k, _mm256_mullo_epi32(z_sign, set(PRIME_Z))), _mm256_castps_si256(along_z));
+
+                value = add(value, falloff(b, gradient(seed, i1, j1, k1, x1, y1, z1)));
+                if (lattice == 1) break;
+
+                ax0 = sub(set(.5f), ax0);
+                ay0 = sub(set(.5f), ay0);
+                az0 = sub(set(.5f), az0);
+                x0 = mul(to_float(x_sign), ax0);
+                y0 = mul(to_float(y_sign), ay0);
+                z0 = mul(to_float(z_sign), az0);
+                a = add(a, sub(sub(set(.75f), ax0), add(ay0, az0)));
+
+                i = _mm256_add_epi32(i, _mm256_and_si256(_mm256_srai_epi32(x_sign, 1), set(PRIME_X)));
+                j = _mm256_add_epi32(j, _mm256_and_si256(_mm256_srai_epi32(y_sign, 1), set(PRIME_Y)));
+                k = _mm256_add_epi32(k, _mm256_and_si256(_mm256_srai_epi32(z_sign, 1), set(PRIME_Z)));
+                x_sign = _mm256_sub_epi32(_mm256_setzero_si256(), x_sign);
+                y_sign = _mm256_sub_epi32(_mm256_setzero_si256(), y_sign);
+                z_sign = _mm256_sub_epi32(_mm256_setzero_si256(), z_sign);
+                seed = _mm256_xor_si256(seed, set(-1));
+            }
+            return mul(value, set(32.69428253173828125f));
+        }
+
+        //NOTE: CalculateFractalBounding
+        static float fractal_bounding() {
+            float amp = GAIN;
+            float amp_fractal = 1.0f;
+            for (int i {1}; i < OCTAVES; i++) {
+                amp_fractal += amp;
+                amp *= GAIN;
+            }
+            return 1 / amp_fractal;
+        }
+
+        //NOTE: biome_noise.GetNoise(x, y)
+        static __m256 biome_noise(__m256 x, __m256 y) {
+            return perlin(set(SEED), mul(x, set(FREQUENCY)), mul(y, set(FREQUENCY)));
+        }
+
+        //NOTE: terrain_noise.GetNoise(x, y), weighted strength 0 leaves the amplitude alone (Lerp(1, .., 0) = 1)
+        static __m256 terrain_noise(__m256 x, __m256 y) {
+            constexpr float SQRT3 = static_cast<float>(1.7320508075688772935274463415059);
+            constexpr float F2 = .5f * (SQRT3 - 1);
+            x = mul(x, set(FREQUENCY));
+            y = mul(y, set(FREQUENCY));
+            const __m256 t = mul(add(x, y), set(F2));
+            x = add(x, t);
+            y = add(y, t);
+
+            __m256 sum = _mm256_setzero_ps();
+            float amp = fractal_bounding();
+            for (int octave {0}; octave < OCTAVES; octave++) {
+                sum = add(sum, mul(simplex(set(SEED + octave), x, y), set(amp)));
+                x = mul(x, set(LACUNARITY));
+                y = mul(y, set(LACUNARITY));
+                amp *= GAIN;
+            }
+            return sum;
+        }
+
+        //NOTE: terrain_noise.GetNoise(x, y, z), the default OpenSimplex2 rotation
+        static __m256 terrain_noise(__m256 x, __m256 y, __m256 z) {
+            constexpr float R3 = static_cast<float>(2.0 / 3.0);
+            x = mul(x, set(FREQUENCY));
+            y = mul(y, set(FREQUENCY));
+            z = mul(z, set(FREQUENCY));
+            const __m256 r = mul(add(add(x, y), z), set(R3));
+            x = sub(r, x);
+            y = sub(r, y);
+            z = sub(r, z);
+
+            __m256 sum = _mm256_setzero_ps();
+            float amp = fractal_bounding();
+            for (int octave {0}; octave < OCTAVES; octave++) {
+                sum = add(sum, mul(open_simplex(set(SEED + octave), x, y, z), set(amp)));
+                x = mul(x, set(LACUNARITY));
+                y = mul(y, set(LACUNARITY));
+                z = mul(z, set(LACUNARITY));
+                amp *= GAIN;
+            }
+            return sum;
+        }
+
+        static __m256 normalize_noise(__m256 noise) {
+            return mul(add(noise, set(1.f)), set(.5f));
+        }
+
+        //NOTE: Noise::column_height of 8 columns
+        static __m256i column_heights(__m256 x, __m256 z) {
+            const __m256 biome = sub(normalize_noise(biome_noise(mul(x, set(.1f)), mul(z, set(.1f)))), set(.4f));
+            const __m256 terrain = normalize_noise(terrain_noise(x, z));
+            return _mm256_cvttps_epi32(add(set(4.0f * 16.0f), mul(terrain, mul(biome, set(128.0f)))));
+        }
+
+        static __m256i lane_indices() {
+            return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        }
+    }
+#endif
+
+    Noise::Noise() {
+        configure(terrain_noise, biome_noise);
+        vectorized = vectorization_supported();
+    }
+
     float Noise::fetch_heightmap(float x, float z) {
         // return 1;
         // return (x < 16 && z < 16 && x >= 0 && z >= 0) ? 1 : 0;
@@ -30,4 +347,117 @@ namespace Voxel {
     float Noise::fetch_cave(float x, float y, float z) {
         return normalize_noise(terrain_noise.GetNoise(x *.8f, y*.8f, z*.8f));
     }
+
+    int Noise::column_height(float x, float z) {
+        return static_cast<int>(fetch_heightmap(x, z));
+    }
+
+    void Noise::set_vectorized(bool enabled) {
+        #ifdef __AVX2__
+        vectorized = enabled;
+        #endif
+    }
+
+    bool Noise::vectorization_supported() {
+        #ifdef __AVX2__
+        //PROBE: raw noise of both sides at a spread of coordinates (negative, integer, far away), any bit differing keeps the scalar path
+        static const bool supported = [] {
+            FastNoiseLite terrain_noise, biome_noise;
+            configure(terrain_noise, biome_noise);
+
+            std::size_t num_samples {0}, num_differing {0};
+            auto compare = [&](__m256 values, const auto& expected) {
+                alignas(32) float lanes[8];
+                _mm256_store_ps(lanes, values);
+                for (int lane {0}; lane < 8; lane++) {
+                    num_samples++;
+                    if (std::bit_cast<uint32_t>(lanes[lane]) != std::bit_cast<uint32_t>(expected(lane))) num_differing++;
+                }
+            };
+
+            for (float origin : { 0.f, -1.f, 13.37f, -8192.f, 524288.5f, -3000001.f }) {
+                for (int step {0}; step < 64; step++) {
+                    alignas(32) float xs[8], ys[8], zs[8];
+                    for (int lane {0}; lane < 8; lane++) {
+                        xs[lane] = origin + step * 3.7f + lane * 1.3f;
+                        ys[lane] = origin * .5f - step * 2.9f + lane * .7f;
+                        zs[lane] = -origin + step * 5.1f - lane * 2.3f;
+                    }
+                    const __m256 x = _mm256_load_ps(xs), y = _mm256_load_ps(ys), z = _mm256_load_ps(zs);
+                    compare(Simd::biome_noise(x, z), [&](int lane) { return biome_noise.GetNoise(xs[lane], zs[lane]); });
+                    compare(Simd::terrain_noise(x, z), [&](int lane) { return terrain_noise.GetNoise(xs[lane], zs[lane]); });
+                    compare(Simd::terrain_noise(x, y, z), [&](int lane) { return terrain_noise.GetNoise(xs[lane], ys[lane], zs[lane]); });
+                }
+            }
+
+            if (num_differing > 0) plog_warn("noise: avx2 kernels differ from FastNoiseLite in {} of {} samples, using the scalar path", num_differing, num_samples);
+            return num_differing == 0;
+        }();
+        return supported;
+        #else
+        return false;
+        #endif
+    }
+
+    void Noise::fetch_heightmap_row(float origin_x, float z, int size, int spacing, int* out) {
+        int x {0};
+        #ifdef __AVX2__
+        if (vectorized) {
+            const __m256 world_z = _mm256_set1_ps(z);
+            for (; x + 8 <= size; x += 8) {
+                const __m256i columns = _mm256_mullo_epi32(_mm256_add_epi32(_mm256_set1_epi32(x), Simd::lane_indices()), _mm256_set1_epi32(spacing));
+                const __m256 world_x = _mm256_add_ps(_mm256_set1_ps(origin_x), _mm256_cvtepi32_ps(columns));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + x), Simd::column_heights(world_x, world_z));
+            }
+        }
+        #endif
+        for (; x < size; x++) {
+            out[x] = column_height(origin_x + x * spacing, z);
+        }
+    }
+
+    void Noise::fetch_heightmap_grid(float origin_x, float origin_z, int size, int* out) {
+        for (int z = 0; z < size; z++) {
+            fetch_heightmap_row(origin_x, origin_z + z, size, 1, out + (z * size));
+        }
+    }
+
+    void Noise::fetch_heightmap_samples(float origin_x, float origin_z, int size, int spacing, float* out) {
+        std::vector<int> row(size);
+        for (int z = 0; z < size; z++) {
+            fetch_heightmap_row(origin_x, origin_z + z * spacing, size, spacing, row.data());
+            std::copy(row.begin(), row.end(), out + (z * size));
+        }
+    }
+
+    void Noise::fetch_cave_columns(float origin_x, float origin_y, float origin_z, int size, const int* column_heights, float* out) {
+        for (int z = 0; z < size; z++) {
+            const float sample_z = (origin_z + z) * .8f;
+            int x = 0;
+            #ifdef __AVX2__
+            //NOTE: 8 columns per pass up to the highest of them, the lanes above their own column are not stored
+            if (vectorized) {
+                for (; x + 8 <= size; x += 8) {
+                    const int* heights = column_heights + x + (z * size);
+                    const int max_height = *std::max_element(heights, heights + 8);
+                    const __m256i lane_heights = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(heights));
+                    const __m256 sample_x = _mm256_mul_ps(_mm256_add_ps(_mm256_set1_ps(origin_x), _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x), Simd::lane_indices()))), _mm256_set1_ps(.8f));
+                    for (int y = 0; y < max_height; y++) {
+                        const __m256i below_surface = _mm256_cmpgt_epi32(lane_heights, _mm256_set1_epi32(y));
+                        const __m256 values = Simd::normalize_noise(Simd::terrain_noise(sample_x, _mm256_set1_ps((origin_y + y) * .8f), _mm256_set1_ps(sample_z)));
+                        _mm256_maskstore_ps(out + x + (y * size) + (z * size * size), below_surface, values);
+                    }
+                }
+            }
+            #endif
+            for (; x < size; x++) {
+                const float sample_x = (origin_x + x) * .8f;
+                const int column_height = column_heights[x + (z * size)];
+                float* column = out + x + (z * size * size);
+                for (int y = 0; y < column_height; y++) {
+                    column[y * size] = normalize_noise(terrain_noise.GetNoise(sample_x, (origin_y + y) * .8f, sample_z));
+                }
+            }
+        }
+    }
 }
\ No newline at end of file
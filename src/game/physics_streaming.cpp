@@ -0,0 +1,153 @@
+#include "game/physics_streaming.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <mutex>
+#include <unordered_map>
+#include "game/chunk.h"
+#include "game/voxel_shape.h"
+
+namespace Voxel::Game::PhysicsStreaming {
+    //NOTE: chunk (index, not position) the center of the sphere lies in
+    static glm::ivec3 sphere_chunk(glm::vec4 sphere) {
+        return glm::ivec3(glm::floor(glm::vec3(sphere) / static_cast<float>(SIZE)));
+    }
+
+    bool is_in_range(glm::ivec3 chunk_position, glm::vec4 sphere) {
+        //NOTE: gap between the two chunk boxes per axis, whole chunks apart
+        const glm::ivec3 distance = glm::abs(chunk_position / SIZE - sphere_chunk(sphere));
+        const glm::vec3 gap = glm::vec3(glm::max(distance - 1, glm::ivec3(0)) * SIZE);
+        return glm::dot(gap, gap) <= sphere.w * sphere.w;
+    }
+
+    static std::mutex streaming_mutex;
+    //NOTE: chunks that got their body from here, keyed by ChunkRegistry::chunk_key
+    static std::unordered_map<uint64_t, glm::ivec3> resident;
+    //NOTE: chunk (xyz) and radius bits (w) of every sphere of the last rebuild
+    static std::vector<glm::ivec4> last_signature;
+    static uint64_t last_generation {~0ull};
+    //NOTE: a chunk was skipped because it was being meshed, the next update diffs the ring again
+    static bool retry {false};
+    static Stats stats;
+
+    void update() {
+        static std::vector<glm::vec4> spheres;
+        Physics::PhysicsManager::get_instance().collect_streaming_spheres(spheres);
+        update(spheres);
+    }
+
+    void update(const std::vector<glm::vec4>& spheres) {
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+
+        //SIGNATURE: the ring only changes when a sphere enters another chunk, its radius changes or a chunk got a shape/lost its body
+        std::vector<glm::ivec4> signature;
+        signature.reserve(spheres.size());
+        for (const glm::vec4& sphere : spheres) signature.emplace_back(sphere_chunk(sphere), std::bit_cast<int>(sphere.w));
+        const uint64_t generation = Chunk::shape_generation.load();
+        if (signature == last_signature && generation == last_generation && !retry) return;
+        last_signature = std::move(signature);
+        last_generation = generation;
+        retry = false;
+        stats.num_rebuilds++;
+
+        //WANTED: chunks in range of a sphere's chunk
+        std::unordered_map<uint64_t, glm::ivec3> wanted;
+        for (const glm::vec4& sphere : spheres) {
+            const glm::ivec3 center = sphere_chunk(sphere);
+            const int reach = static_cast<int>(std::ceil(sphere.w / SIZE)) + 1;
+
+            for (int y = std::max(center.y - reach, 0); y <= std::min(center.y + reach, NUM_CHUNKS_PER_COMPOUND - 1); y++) {
+                for (int z = center.z - reach; z <= center.z + reach; z++) {
+                    for (int x = center.x - reach; x <= center.x + reach; x++) {
+                        const glm::ivec3 position = glm::ivec3(x, y, z) * SIZE;
+                        if (is_in_range(position, sphere)) wanted[ChunkRegistry::chunk_key(position)] = position;
+                    }
+                }
+            }
+        }
+
+        auto& physics_manager = Physics::PhysicsManager::get_instance();
+        auto& registry = ChunkRegistry::get_instance();
+        ChunkRegistry::Guard guard;
+        std::unordered_map<uint64_t, glm::ivec3> next_resident;
+
+        //ADD: the mesh locks are held until the slots are recorded, a remesh in between must see the body
+        //NOTE: a chunk being meshed (a worker holds mesh_mutex through the whole build) is skipped, not waited for
+        std::vector<Chunk*> adding;
+        std::vector<BodyCreationSettings> settings;
+        std::vector<std::unique_lock<std::mutex>> mesh_locks;
+        for (auto& [key, position] : wanted) {
+            Chunk* chunk = registry.find(position);
+            if (!chunk) continue;
+
+            std::unique_lock<std::mutex> mesh_lock(chunk->mesh_mutex, std::try_to_lock);
+            if (!mesh_lock.owns_lock()) {
+                //NOTE: a resident chunk stays resident, its body is untouched
+                if (resident.contains(key)) next_resident[key] = position;
+                stats.num_deferred++;
+                retry = true;
+                continue;
+            }
+            //NOTE: ~ChunkCompound removes the chunk from the registry before its unload() takes mesh_mutex, a chunk still
+            //      registered under the lock gets its body released by that unload, one removed since find() must not get a body
+            if (registry.find(position) != chunk) continue;
+            if (chunk->affected_by_physics) {
+                next_resident[key] = position;
+                continue;
+            }
+            if (!chunk->shape) continue;
+
+            settings.emplace_back(chunk->shape, RVec3(position.x, position.y, position.z), Quat::sIdentity(), EMotionType::Static, PhysicsLayers::NON_MOVING);
+            adding.push_back(chunk);
+            mesh_locks.push_back(std::move(mesh_lock));
+        }
+
+        if (!settings.empty()) {
+            std::vector<unsigned int> slots(settings.size());
+            const std::size_t num_added = physics_manager.add_bodies(settings, slots);
+            for (std::size_t i {0}; i < num_added; i++) {
+                adding[i]->slot_physics = slots[i];
+                adding[i]->affected_by_physics = true;
+                next_resident[ChunkRegistry::chunk_key(adding[i]->position)] = adding[i]->position;
+            }
+            stats.num_added += num_added;
+        }
+        mesh_locks.clear();
+
+        //REMOVE: chunks that left the ring, evicted ones are gone from the registry (their unload released the body)
+        std::vector<unsigned int> removing;
+        for (auto& [key, position] : resident) {
+            if (wanted.contains(key)) continue;
+            Chunk* chunk = registry.find(position);
+            if (!chunk) continue;
+
+            std::unique_lock<std::mutex> mesh_lock(chunk->mesh_mutex, std::try_to_lock);
+            if (!mesh_lock.owns_lock()) {
+                next_resident[key] = position;
+                stats.num_deferred++;
+                retry = true;
+                continue;
+            }
+            if (!chunk->affected_by_physics) continue;
+            removing.push_back(chunk->slot_physics);
+            chunk->affected_by_physics = false;
+            mesh_locks.push_back(std::move(mesh_lock));
+        }
+        physics_manager.remove_bodies(removing);
+        mesh_locks.clear();
+        stats.num_removed += removing.size();
+
+        resident = std::move(next_resident);
+        stats.num_bodies = resident.size();
+    }
+
+    void clear() {
+        update(std::vector<glm::vec4> {});
+    }
+
+    Stats get_stats() {
+        std::lock_guard<std::mutex> lock(streaming_mutex);
+        return stats;
+    }
+}
\ No newline at end of file
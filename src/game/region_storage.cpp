@@ -0,0 +1,333 @@
+#include "game/region_storage.h"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include "core/log.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Voxel::Game {
+    static constexpr uint32_t REGION_MAGIC = 0x47525856; // "VXRG"
+    //NOTE: the chunk size is part of the version (upper bits), 16 keeps the original version 1
+    static constexpr uint32_t REGION_VERSION = 1 | (SIZE != 16 ? static_cast<uint32_t>(SIZE) << 16 : 0);
+    static constexpr std::size_t REGION_HEADER_BYTES = 2 * sizeof(uint32_t);
+    static constexpr std::size_t REGION_TABLE_ENTRY_BYTES = 2 * sizeof(uint32_t);
+    static constexpr std::size_t REGION_TABLE_BYTES = RegionStorage::REGION_SIZE * RegionStorage::REGION_SIZE * REGION_TABLE_ENTRY_BYTES;
+    static constexpr std::size_t RUN_BYTES = sizeof(uint16_t) + sizeof(uint8_t);
+
+    //NOTE: records are written in native byte order, every supported target is little-endian
+    template <typename T> static void write_value(std::vector<uint8_t>& out, T value) {
+        const std::size_t offset = out.size();
+        out.resize(offset + sizeof(T));
+        std::memcpy(out.data() + offset, &value, sizeof(T));
+    }
+
+    template <typename T> static bool read_value(const uint8_t*& data, const uint8_t* end, T& value) {
+        if (static_cast<std::size_t>(end - data) < sizeof(T)) return false;
+        std::memcpy(&value, data, sizeof(T));
+        data += sizeof(T);
+        return true;
+    }
+
+    struct RegionStorage::Region {
+        std::shared_mutex mutex;
+        std::filesystem::path path;
+
+        const uint8_t* mapped {nullptr};
+        std::size_t mapped_size {0};
+#ifdef _WIN32
+        HANDLE file_handle {INVALID_HANDLE_VALUE};
+        HANDLE mapping_handle {nullptr};
+#endif
+
+        explicit Region(std::filesystem::path path) : path(std::move(path)) {
+            map();
+        }
+
+        ~Region() {
+            unmap();
+        }
+
+        //NOTE: a missing or empty file simply leaves the region unmapped (nothing stored yet)
+        void map() {
+            std::error_code error;
+            const auto file_size = std::filesystem::file_size(path, error);
+            if (error || file_size < REGION_HEADER_BYTES + REGION_TABLE_BYTES) return;
+
+#ifdef _WIN32
+            file_handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_handle == INVALID_HANDLE_VALUE) return;
+
+            mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (!mapping_handle) {
+                unmap();
+                return;
+            }
+
+            mapped = static_cast<const uint8_t*>(MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0));
+            if (!mapped) {
+                unmap();
+                return;
+            }
+#else
+            const int fd = open(path.c_str(), O_RDONLY);
+            if (fd < 0) return;
+
+            void* address = mmap(nullptr, file_size, PROT_READ, MAP_SHARED, fd, 0);
+            //NOTE: the mapping keeps its own reference to the file
+            close(fd);
+            if (address == MAP_FAILED) return;
+            mapped = static_cast<const uint8_t*>(address);
+#endif
+            mapped_size = file_size;
+
+            uint32_t magic {0}, version {0};
+            std::memcpy(&magic, mapped, sizeof(uint32_t));
+            std::memcpy(&version, mapped + sizeof(uint32_t), sizeof(uint32_t));
+            if (magic != REGION_MAGIC || version != REGION_VERSION) {
+                plog_error("region file {} has an unknown format, ignoring it", path.string());
+                unmap();
+            }
+        }
+
+        void unmap() {
+#ifdef _WIN32
+            if (mapped) UnmapViewOfFile(mapped);
+            if (mapping_handle) CloseHandle(mapping_handle);
+            if (file_handle != INVALID_HANDLE_VALUE) CloseHandle(file_handle);
+            mapping_handle = nullptr;
+            file_handle = INVALID_HANDLE_VALUE;
+#else
+            if (mapped) munmap(const_cast<uint8_t*>(mapped), mapped_size);
+#endif
+            mapped = nullptr;
+            mapped_size = 0;
+        }
+    };
+
+    RegionStorage::RegionStorage(std::filesystem::path directory) : directory(std::move(directory)) {
+        std::error_code error;
+        std::filesystem::create_directories(this->directory, error);
+        if (error) plog_error("failed to create region directory {}: {}", this->directory.string(), error.message());
+    }
+
+    RegionStorage::~RegionStorage() = default;
+
+    std::filesystem::path RegionStorage::region_path(glm::ivec2 region_position) const {
+        return directory / ("r." + std::to_string(region_position.x) + "." + std::to_string(region_position.y) + ".region");
+    }
+
+    std::shared_ptr<RegionStorage::Region> RegionStorage::open_region(glm::ivec2 region_position) {
+        const int64_t key = (static_cast<int64_t>(region_position.x) << 32) | static_cast<uint32_t>(region_position.y);
+
+        //NOTE: regions without a file are cached too, lookups in never stored areas don't touch the filesystem again
+        std::lock_guard<std::mutex> lock(regions_mutex);
+        auto& region = regions[key];
+        if (!region) region = std::make_shared<Region>(region_path(region_position));
+        return region;
+    }
+
+    static void compound_to_region(glm::ivec3 position, glm::ivec2& region_position, std::size_t& table_index) {
+        const int compound_x = position.x / SIZE;
+        const int compound_z = position.z / SIZE;
+        region_position = glm::ivec2(compound_x >> RegionStorage::REGION_SHIFT, compound_z >> RegionStorage::REGION_SHIFT);
+        table_index = static_cast<std::size_t>((compound_x & (RegionStorage::REGION_SIZE - 1)) + (compound_z & (RegionStorage::REGION_SIZE - 1)) * RegionStorage::REGION_SIZE);
+    }
+
+    //NOTE: byte ranges [first, second) of the records the table points at, sorted by offset
+    static std::vector<std::pair<uint64_t, uint64_t>> live_records(std::fstream& file) {
+        std::vector<uint8_t> table(REGION_TABLE_BYTES);
+        file.seekg(REGION_HEADER_BYTES);
+        file.read(reinterpret_cast<char*>(table.data()), table.size());
+
+        std::vector<std::pair<uint64_t, uint64_t>> records;
+        for (std::size_t i {0}; i < static_cast<std::size_t>(RegionStorage::REGION_SIZE * RegionStorage::REGION_SIZE); i++) {
+            uint32_t offset {0}, size {0};
+            std::memcpy(&offset, table.data() + i * REGION_TABLE_ENTRY_BYTES, sizeof(uint32_t));
+            std::memcpy(&size, table.data() + i * REGION_TABLE_ENTRY_BYTES + sizeof(uint32_t), sizeof(uint32_t));
+            if (size > 0) records.push_back({ offset, static_cast<uint64_t>(offset) + size });
+        }
+        std::sort(records.begin(), records.end());
+        return records;
+    }
+
+    //NOTE: first gap after the table that holds size bytes, the end of the last record if none does
+    static uint64_t find_free_range(const std::vector<std::pair<uint64_t, uint64_t>>& records, std::size_t size) {
+        uint64_t cursor = REGION_HEADER_BYTES + REGION_TABLE_BYTES;
+        for (const auto& [begin, end] : records) {
+            if (begin >= cursor + size) return cursor;
+            cursor = std::max(cursor, end);
+        }
+        return cursor;
+    }
+
+    bool RegionStorage::load_compound(glm::ivec3 position, int* height_map, uint8_t* blocks) {
+        glm::ivec2 region_position;
+        std::size_t table_index;
+        compound_to_region(position, region_position, table_index);
+
+        auto region = open_region(region_position);
+        std::shared_lock<std::shared_mutex> lock(region->mutex);
+        if (!region->mapped) return false;
+
+        uint32_t offset {0}, size {0};
+        const uint8_t* entry = region->mapped + REGION_HEADER_BYTES + table_index * REGION_TABLE_ENTRY_BYTES;
+        std::memcpy(&offset, entry, sizeof(uint32_t));
+        std::memcpy(&size, entry + sizeof(uint32_t), sizeof(uint32_t));
+        if (size == 0) return false;
+
+        if (static_cast<std::size_t>(offset) + size > region->mapped_size) {
+            plog_error("region file {} has a record past its end, regenerating", region->path.string());
+            return false;
+        }
+
+        if (!decode_compound(region->mapped + offset, size, height_map, blocks)) {
+            plog_error("region file {} has a corrupt record, regenerating", region->path.string());
+            return false;
+        }
+        return true;
+    }
+
+    bool RegionStorage::save_compound(glm::ivec3 position, const int* height_map, const uint8_t* blocks) {
+        glm::ivec2 region_position;
+        std::size_t table_index;
+        compound_to_region(position, region_position, table_index);
+
+        std::vector<uint8_t> record;
+        encode_compound(height_map, blocks, record);
+
+        auto region = open_region(region_position);
+        std::unique_lock<std::shared_mutex> lock(region->mutex);
+        //NOTE: readers only ever see complete mappings, remapped once the record and its table entry are written
+        region->unmap();
+
+        bool written {false};
+        uint64_t live_end {0};
+        {
+            if (!std::filesystem::exists(region->path)) {
+                std::ofstream create(region->path, std::ios::binary);
+                std::vector<uint8_t> header;
+                write_value(header, REGION_MAGIC);
+                write_value(header, REGION_VERSION);
+                header.resize(REGION_HEADER_BYTES + REGION_TABLE_BYTES, 0);
+                create.write(reinterpret_cast<const char*>(header.data()), header.size());
+            }
+
+            std::fstream file(region->path, std::ios::binary | std::ios::in | std::ios::out);
+            //FREE-SPACE: the compound's current record counts as live, a crash before the table entry is written keeps it readable
+            auto records = live_records(file);
+            const uint64_t offset = find_free_range(records, record.size());
+            if (file && offset + record.size() <= UINT32_MAX) {
+                file.seekp(static_cast<std::streamoff>(offset));
+                file.write(reinterpret_cast<const char*>(record.data()), record.size());
+
+                std::vector<uint8_t> entry;
+                write_value(entry, static_cast<uint32_t>(offset));
+                write_value(entry, static_cast<uint32_t>(record.size()));
+                file.seekp(REGION_HEADER_BYTES + table_index * REGION_TABLE_ENTRY_BYTES);
+                file.write(reinterpret_cast<const char*>(entry.data()), entry.size());
+                written = static_cast<bool>(file);
+            }
+
+            //NOTE: the replaced record's bytes are free now, everything past the last live record can go
+            if (written) {
+                live_end = REGION_HEADER_BYTES + REGION_TABLE_BYTES;
+                for (const auto& [_, end] : live_records(file)) live_end = std::max(live_end, end);
+            }
+        }
+
+        std::error_code error;
+        if (written && live_end < std::filesystem::file_size(region->path, error) && !error) {
+            std::filesystem::resize_file(region->path, live_end, error);
+        }
+
+        if (!written) plog_error("failed to write compound ({}, {}) to {}", position.x, position.z, region->path.string());
+        region->map();
+        return written;
+    }
+
+    void RegionStorage::encode_compound(const int* height_map, const uint8_t* blocks, std::vector<uint8_t>& out) {
+        out.clear();
+
+        for (int i {0}; i < SIZE * SIZE; i++) {
+            write_value(out, static_cast<int16_t>(height_map[i]));
+        }
+
+        //PALETTE: block types in order of first appearance
+        std::array<int, 256> palette_index;
+        palette_index.fill(-1);
+        std::vector<uint8_t> palette;
+        for (std::size_t i {0}; i < NUM_BLOCKS_PER_COMPOUND; i++) {
+            if (palette_index[blocks[i]] >= 0) continue;
+            palette_index[blocks[i]] = static_cast<int>(palette.size());
+            palette.push_back(blocks[i]);
+        }
+        write_value(out, static_cast<uint16_t>(palette.size()));
+        out.insert(out.end(), palette.begin(), palette.end());
+
+        //RLE: runs never exceed 65536 blocks so the length fits into a uint16 (stored minus one)
+        const std::size_t run_count_offset = out.size();
+        write_value(out, static_cast<uint32_t>(0));
+
+        uint32_t num_runs {0};
+        std::size_t i {0};
+        while (i < NUM_BLOCKS_PER_COMPOUND) {
+            const uint8_t block = blocks[i];
+            std::size_t length {1};
+            while (i + length < NUM_BLOCKS_PER_COMPOUND && length < 65536 && blocks[i + length] == block) length++;
+
+            write_value(out, static_cast<uint16_t>(length - 1));
+            write_value(out, static_cast<uint8_t>(palette_index[block]));
+            num_runs++;
+            i += length;
+        }
+        std::memcpy(out.data() + run_count_offset, &num_runs, sizeof(uint32_t));
+    }
+
+    bool RegionStorage::decode_compound(const uint8_t* data, std::size_t size, int* height_map, uint8_t* blocks) {
+        const uint8_t* end = data + size;
+
+        for (int i {0}; i < SIZE * SIZE; i++) {
+            int16_t height {0};
+            if (!read_value(data, end, height)) return false;
+            height_map[i] = height;
+        }
+
+        uint16_t palette_size {0};
+        if (!read_value(data, end, palette_size) || palette_size == 0 || palette_size > 256) return false;
+        if (static_cast<std::size_t>(end - data) < palette_size) return false;
+        const uint8_t* palette = data;
+        data += palette_size;
+
+        uint32_t num_runs {0};
+        if (!read_value(data, end, num_runs)) return false;
+        if (static_cast<std::size_t>(end - data) != static_cast<std::size_t>(num_runs) * RUN_BYTES) return false;
+
+        std::size_t i {0};
+        for (uint32_t run {0}; run < num_runs; run++) {
+            uint16_t length_minus_one {0};
+            uint8_t index {0};
+            read_value(data, end, length_minus_one);
+            read_value(data, end, index);
+
+            const std::size_t length = static_cast<std::size_t>(length_minus_one) + 1;
+            if (index >= palette_size || i + length > NUM_BLOCKS_PER_COMPOUND) return false;
+
+            std::memset(blocks + i, palette[index], length);
+            i += length;
+        }
+
+        return i == NUM_BLOCKS_PER_COMPOUND;
+    }
+}
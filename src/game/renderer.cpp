@@ -13,6 +13,7 @@ namespace Voxel::Game {
     static FBO::FramebufferAttachment framebuffer_color_attachment_multisampled;
     static FBO::FramebufferAttachment framebuffer_depth_stencil_attachment_multisampled;
     static FBO::FramebufferAttachment framebuffer_color_attachment;
+    static FBO::FramebufferAttachment framebuffer_depth_stencil_attachment;
     static FBO::FramebufferAttachment framebuffer_shadow_map_attachment;
 
     static std::unique_ptr<Mesh<float>> mesh_screen_quad;
@@ -77,11 +78,27 @@ namespace Voxel::Game {
         framebuffer_color_attachment_create_info.mag_filter = GL_LINEAR;
         auto& framebuffer_color_attachment_texture = ResourceManager::create_resource<Texture>(TEXTURE_FRAMEBUFFER_COLOR_ATTACHMENT2, framebuffer_color_attachment_create_info);
 
+        //NOTE: resolved scene depth, the hi-z pyramid for the gpu occlusion culling is built from it
+        Texture::TextureCreateInfo framebuffer_depth_stencil_attachment_create_info {};
+        framebuffer_depth_stencil_attachment_create_info.target = GL_TEXTURE_2D;
+        framebuffer_depth_stencil_attachment_create_info.internal_format = GL_DEPTH24_STENCIL8;
+        framebuffer_depth_stencil_attachment_create_info.format = GL_DEPTH_STENCIL;
+        framebuffer_depth_stencil_attachment_create_info.type = GL_UNSIGNED_INT_24_8;
+        framebuffer_depth_stencil_attachment_create_info.width = (unsigned int)width;
+        framebuffer_depth_stencil_attachment_create_info.height = (unsigned int)height;
+        framebuffer_depth_stencil_attachment_create_info.min_filter = GL_NEAREST;
+        framebuffer_depth_stencil_attachment_create_info.mag_filter = GL_NEAREST;
+        auto& framebuffer_depth_stencil_attachment_texture = ResourceManager::create_resource<Texture>(TEXTURE_FRAMEBUFFER_DEPTH_STENCIL_ATTACHMENT2, framebuffer_depth_stencil_attachment_create_info);
+
         intermediate_framebuffer->bind();
         framebuffer_color_attachment = {
             GL_COLOR_ATTACHMENT0, framebuffer_color_attachment_create_info.target, &framebuffer_color_attachment_texture
         };
         intermediate_framebuffer->attach(&framebuffer_color_attachment);
+        framebuffer_depth_stencil_attachment = {
+            GL_DEPTH_STENCIL_ATTACHMENT, framebuffer_depth_stencil_attachment_create_info.target, &framebuffer_depth_stencil_attachment_texture
+        };
+        intermediate_framebuffer->attach(&framebuffer_depth_stencil_attachment);
 
         if (GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
             plog_error("error -> framebuffer error: {}", std::to_string(status).c_str());
@@ -142,6 +159,9 @@ namespace Voxel::Game {
 
         //SHADER-INIT
         {
+            //NOTE: the greedy mesh shaders index block types for the chunk size of this build
+            const std::string chunk_defines = "#define CHUNK_SIZE " + std::to_string(SIZE) + "\n";
+
             ResourceManager::create_resource<Shader>(
                 SHADER_DEFAULT,
                 std::unordered_map<unsigned int, std::string_view>{
@@ -170,7 +190,8 @@ namespace Voxel::Game {
                 SHADER_GREEDY_MESH_FOR_SHADOW_PASS,
                 std::unordered_map<unsigned int, std::string_view> {
                     { GL_VERTEX_SHADER, ASSETS_DIR "shaders/greedy-mesh/vert.glsl" }
-                }
+                },
+                chunk_defines
             );
 
             ResourceManager::create_resource<Shader>(
@@ -178,8 +199,32 @@ namespace Voxel::Game {
                 std::unordered_map<unsigned int, std::string_view> {
                     { GL_VERTEX_SHADER, ASSETS_DIR "shaders/greedy-mesh/vert.glsl" },
                     { GL_FRAGMENT_SHADER, ASSETS_DIR "shaders/greedy-mesh/frag.glsl" },
+                },
+                chunk_defines
+            );
+
+            ResourceManager::create_resource<Shader>(
+                SHADER_CHUNK_CULL,
+                std::unordered_map<unsigned int, std::string_view> {
+                    { GL_COMPUTE_SHADER, ASSETS_DIR "shaders/cull/comp.glsl" }
                 }
             );
+
+            ResourceManager::create_resource<Shader>(
+                SHADER_HIZ_DOWNSAMPLE,
+                std::unordered_map<unsigned int, std::string_view> {
+                    { GL_COMPUTE_SHADER, ASSETS_DIR "shaders/hiz/comp.glsl" }
+                }
+            );
+
+            ResourceManager::create_resource<Shader>(
+                SHADER_FAR_TERRAIN,
+                std::unordered_map<unsigned int, std::string_view> {
+                    { GL_VERTEX_SHADER, ASSETS_DIR "shaders/far-terrain/vert.glsl" },
+                    { GL_FRAGMENT_SHADER, ASSETS_DIR "shaders/far-terrain/frag.glsl" }
+                },
+                "#define FAR_RESOLUTION " + std::to_string(FarTerrain::RESOLUTION) + "\n"
+            );
         }
 
         //SCREEN-FRAMEBUFFER-INIT
@@ -220,7 +265,10 @@ namespace Voxel::Game {
         {
             camera = &ResourceManager::create_resource<Camera>("camera_game", width, height, glm::vec3(0, 64, 0));
 
+            chunk_renderer = std::make_unique<ChunkRenderer>();
             chunk_manager = std::make_unique<ChunkManager>(camera->position);
+            far_terrain = std::make_unique<FarTerrain>();
+            far_terrain_renderer = std::make_unique<FarTerrainRenderer>();
             matrices_ubo = std::make_unique<UBO>(0, nullptr, 2 * sizeof(glm::mat4));
             matrices_ubo->bind();
             matrices_ubo->sub_data((void*)glm::value_ptr(camera->get_projection()), sizeof(glm::mat4), 0);
@@ -345,8 +393,10 @@ namespace Voxel::Game {
     }
 
     void Renderer::update(float delta_time) {
+        PhysicsStreaming::update();
         physics_manager ->update();
-        chunk_manager   ->update(camera->position);
+        chunk_manager   ->update(camera->position, camera->front);
+        far_terrain     ->update(camera->position, static_cast<float>(ChunkManager::chunk_render_distance * SIZE));
         camera          ->update(delta_time);
         directional_light.update(camera);
 
@@ -373,6 +423,18 @@ namespace Voxel::Game {
             }
             if (ImGui::CollapsingHeader("physics", ImGuiTreeNodeFlags_DefaultOpen)) {
                 ImGui::Text("physics powered by jolt-physics");
+                const auto streaming_stats = PhysicsStreaming::get_stats();
+                ImGui::Text(
+                    std::format(
+                        "chunk bodies: {} (radius {:.0f} blocks)\n"
+                        "streamed: {} added, {} removed in {} rebuilds",
+                        streaming_stats.num_bodies,
+                        Physics::PhysicsManager::default_streaming_radius,
+                        streaming_stats.num_added,
+                        streaming_stats.num_removed,
+                        streaming_stats.num_rebuilds
+                    ).c_str()
+                );
             }
             if (ImGui::CollapsingHeader("textures")) {
                 static std::string current_item = TEXTURE_FRAMEBUFFER_SHADOW_MAP_ATTACHMENT;
@@ -393,19 +455,85 @@ namespace Voxel::Game {
                 ImGui::Image(framebuffer_textures[current_item], ImVec2(256, 256), ImVec2(0, 1), ImVec2(1, 0));
             }
             if (ImGui::CollapsingHeader("lights")) {}
+            if (ImGui::CollapsingHeader("far-terrain")) {
+                ImGui::SliderInt("far_distance", &FarTerrain::far_distance, 256, 8192);
+                ImGui::SliderInt("max_pending_tiles", &FarTerrain::max_pending_tiles, 1, 64);
+                const auto far_stats = far_terrain->get_stats();
+                ImGui::Text(
+                    std::format(
+                        "tiles: {} / {} visible, {} cached ({:.1f} MB, {} evicted)\n"
+                        "generated: {} ({:.2f} ms/tile avg, {} pending), update {:.2f} ms",
+                        far_stats.num_visible,
+                        far_stats.num_selected,
+                        far_stats.num_cached,
+                        far_stats.cache_bytes / 1000000.f,
+                        far_stats.num_evicted,
+                        far_stats.num_generated,
+                        far_stats.num_generated > 0 ? far_stats.generation_seconds * 1000. / far_stats.num_generated : 0.,
+                        far_stats.num_pending,
+                        far_stats.update_seconds * 1000.
+                    ).c_str()
+                );
+            }
             if (ImGui::CollapsingHeader("chunk-system", ImGuiTreeNodeFlags_DefaultOpen)) {
                 ImGui::Checkbox("show_gizmos", &Gizmo::show_gizmos);
+                ImGui::Checkbox("cave_culling", &ChunkRenderer::cave_culling);
+                ImGui::Checkbox("occlusion_culling", &ChunkRenderer::occlusion_culling);
+                ImGui::Checkbox("verify_culling", &ChunkRenderer::verify_culling);
+                ImGui::SliderInt("upload_budget_kb", &ChunkRenderer::upload_budget_kb, 64, 65536);
+                const std::size_t cache_estimated_bytes = ChunkManager::cache_estimated_bytes;
                 ImGui::Text(
                     std::format(
-                        "{} MB/Chunk\n"
-                        "{} MB/ChunkCompound\n"
-                        "memory: {} MB",
-                        (sizeof(Chunk)/1000000.f),
-                        (sizeof(ChunkCompound)/1000000.f),
-                        (
-                            (ChunkManager::num_chunks * NUM_CHUNKS_PER_COMPOUND * sizeof(Chunk)) +
-                            (ChunkManager::num_chunks * sizeof(ChunkCompound))
-                        ) / 1000000.f
+                        "compounds: {} cached ({} evicted), {} requested ({} cancelled)\n"
+                        "{:.3f} MB/ChunkCompound (avg)\n"
+                        "memory (estimate): {:.1f} / {} MB",
+                        ChunkManager::num_chunks,
+                        ChunkManager::num_evicted.load(),
+                        ChunkManager::num_requests_pending.load(),
+                        ChunkManager::num_cancelled.load(),
+                        ChunkManager::num_chunks > 0 ? (cache_estimated_bytes / ChunkManager::num_chunks) / 1000000.f : 0.f,
+                        cache_estimated_bytes / 1000000.f,
+                        ChunkManager::cache_budget_mb
+                    ).c_str()
+                );
+
+                //GPU-ARENAS: used / capacity, fragmentation = 1 - largest free block / free space
+                const auto quad_stats = chunk_renderer->get_quad_stats();
+                ImGui::Text(
+                    std::format(
+                        "gpu: {} chunks, {} blocks in arena\n"
+                        "cave culling: {} of {} chunks culled\n"
+                        "gpu culled: {} drawn, {} in the shadow pass ({} of {} verifications failed)\n"
+                        "quads: {:.1f} / {:.1f} MB ({:.0f}% fragmented)",
+                        chunk_renderer->get_num_slots(),
+                        chunk_renderer->get_block_stats().num_allocations,
+                        chunk_renderer->get_num_cave_culled(),
+                        chunk_renderer->get_num_drawable(),
+                        chunk_renderer->get_num_draws(ChunkRenderer::Pass::Scene),
+                        chunk_renderer->get_num_draws(ChunkRenderer::Pass::Shadow),
+                        ChunkRenderer::num_failed_verifications,
+                        ChunkRenderer::num_verified_passes,
+                        quad_stats.used * sizeof(ChunkMesh::PackedQuad) / 1000000.f,
+                        quad_stats.capacity * sizeof(ChunkMesh::PackedQuad) / 1000000.f,
+                        quad_stats.fragmentation() * 100.f
+                    ).c_str()
+                );
+
+                //UPLOADS: queue depth = staged meshes waiting for budget, in flight = copies waiting for their fence
+                const auto upload_stats = chunk_renderer->get_upload_stats();
+                ImGui::Text(
+                    std::format(
+                        "uploads: {:.2f} MB this frame ({:.2f} MB max), {} uploaded\n"
+                        "upload queue: {} chunks ({:.2f} MB), {} in flight\n"
+                        "upload ring: {:.1f} / {:.1f} MB",
+                        upload_stats.frame_bytes / 1000000.f,
+                        upload_stats.max_frame_bytes / 1000000.f,
+                        upload_stats.num_uploaded,
+                        upload_stats.num_queued,
+                        upload_stats.queued_bytes / 1000000.f,
+                        upload_stats.num_in_flight,
+                        upload_stats.ring_used / 1000000.f,
+                        upload_stats.ring_capacity / 1000000.f
                     ).c_str()
                 );
             }
@@ -416,6 +544,10 @@ namespace Voxel::Game {
     }
 
     void Renderer::render() {
+        chunk_renderer->set_camera_position(camera->position);
+        chunk_renderer->update();
+        far_terrain_renderer->update(*far_terrain);
+
         //SHADOW-RENDER-PASS
         {
             glViewport(0, 0, SHADOW_MAP_SIZE, SHADOW_MAP_SIZE);
@@ -428,7 +560,7 @@ namespace Voxel::Game {
 
             glClear(GL_DEPTH_BUFFER_BIT);
             {
-                chunk_manager->render_chunk_compounds(directional_light.frustum, ResourceManager::get_resource<Shader>(SHADER_GREEDY_MESH_FOR_SHADOW_PASS));
+                chunk_renderer->render(directional_light.frustum, ResourceManager::get_resource<Shader>(SHADER_GREEDY_MESH_FOR_SHADOW_PASS), ChunkRenderer::Pass::Shadow);
             }
             shadow_map_fbo->unbind();
         }
@@ -444,6 +576,30 @@ namespace Voxel::Game {
             matrices_ubo->unbind();
 
             glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+            //DRAW-SKYBOX-AND-FAR-TERRAIN: behind everything, the far terrain with its own projection (it reaches past the camera's
+            //                             far plane), the depth is cleared afterwards so the voxel chunks always end up in front
+            {
+                glDepthFunc(GL_LEQUAL);
+                ResourceManager::get_resource<Shader>(SHADER_SKYBOX_CUBEMAP)
+                    .use()
+                    .set_uniform_mat4("view_non_translated", glm::mat4(glm::mat3(camera->get_matrix())));
+                instance_skybox->render();
+                glDepthFunc(GL_LESS);
+
+                const float inner_distance = static_cast<float>(ChunkManager::chunk_render_distance * SIZE);
+                //NOTE: the camera's fov, only the depth range differs
+                const glm::mat4 far_projection = glm::perspective(glm::radians(camera->get_fov()), static_cast<float>(width) / height, inner_distance * .5f, FarTerrain::far_distance * 2.f);
+                far_terrain_renderer->render(
+                    ResourceManager::get_resource<Shader>(SHADER_FAR_TERRAIN),
+                    far_projection * camera->get_matrix(),
+                    camera->position,
+                    inner_distance,
+                    directional_light.direction
+                );
+                glClear(GL_DEPTH_BUFFER_BIT);
+            }
+
             {
                 glActiveTexture(GL_TEXTURE1);
                 std::get<Texture*>(shadow_map_fbo->attachments[0]->attachment_buffer)->bind();
@@ -453,18 +609,12 @@ namespace Voxel::Game {
                     .set_uniform_mat4("light_space_matrix", directional_light.get_light_space_matrix())
                     .set_uniform_vec3("light_direction", directional_light.direction);
                 glActiveTexture(GL_TEXTURE0);
-                chunk_manager->render_chunk_compounds(camera->frustum, shader_greedy);
+                chunk_renderer->render(camera->frustum, shader_greedy, ChunkRenderer::Pass::Scene);
                 instance_pig->render();
             }
 
-            //DRAW-SKYBOX
+            //DRAW-GIZMOS
             {
-                glDepthFunc(GL_LEQUAL);
-                ResourceManager::get_resource<Shader>(SHADER_SKYBOX_CUBEMAP)
-                    .use()
-                    .set_uniform_mat4("view_non_translated", glm::mat4(glm::mat3(camera->get_matrix())));
-                instance_skybox->render();
-
                 glDepthFunc(GL_ALWAYS);
                 if (debug) Gizmo::render_axis_gizmo(*camera);
                 glDepthFunc(GL_LESS);
@@ -478,9 +628,20 @@ namespace Voxel::Game {
             glBindFramebuffer(GL_READ_FRAMEBUFFER, msaa_framebuffer->get_id());
             glBindFramebuffer(GL_DRAW_FRAMEBUFFER, intermediate_framebuffer->get_id());
             glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+            glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
             glBindFramebuffer(GL_FRAMEBUFFER, 0);
         }
 
+        //HI-Z-PYRAMID (occlusion culling of the next frame)
+        {
+            chunk_renderer->update_occlusion(
+                ResourceManager::get_resource<Texture>(TEXTURE_FRAMEBUFFER_DEPTH_STENCIL_ATTACHMENT2).get_id(),
+                width,
+                height,
+                camera->get_projection() * camera->get_matrix()
+            );
+        }
+
         //FRAMEBUFFER-PASS
         {
             glDisable(GL_DEPTH_TEST);
@@ -0,0 +1,156 @@
+#include "game/voxel_collision.h"
+
+#include <algorithm>
+#include <bit>
+#include <limits>
+
+namespace Voxel::Game::VoxelCollision {
+    bool compute_bounds(const ChunkRow* rows, glm::ivec3& min, glm::ivec3& max) {
+        min = glm::ivec3(SIZE);
+        max = glm::ivec3(0);
+        for (int y {0}; y < SIZE; y++) {
+            for (int z {0}; z < SIZE; z++) {
+                const ChunkRow row = rows[z + (y * SIZE)];
+                if (!row) continue;
+
+                min = glm::min(min, glm::ivec3(std::countr_zero(row), y, z));
+                max = glm::max(max, glm::ivec3(std::bit_width(row), y + 1, z + 1));
+            }
+        }
+        return min.x < max.x;
+    }
+
+    void copy_borders(const ChunkRow* const* neighbours, BorderRows& borders) {
+        borders.fill(0);
+        for (int i {0}; i < SIZE; i++) {
+            //NOTE: the slice of the neighbour facing the chunk, read from the orientation whose rows run along it
+            if (neighbours[0]) borders[i] = neighbours[0][(SIZE - 1) + (i * SIZE) + (SIZE * SIZE)];
+            if (neighbours[1]) borders[SIZE + i] = neighbours[1][i * SIZE + (SIZE * SIZE)];
+            if (neighbours[2]) borders[(2 * SIZE) + i] = neighbours[2][(SIZE - 1) + (i * SIZE)];
+            if (neighbours[3]) borders[(3 * SIZE) + i] = neighbours[3][i * SIZE];
+            if (neighbours[4]) borders[(4 * SIZE) + i] = neighbours[4][i + ((SIZE - 1) * SIZE)];
+            if (neighbours[5]) borders[(5 * SIZE) + i] = neighbours[5][i];
+        }
+    }
+
+    glm::vec3 exposed_normal(const ChunkRow* rows, const BorderRows& borders, int x, int y, int z, glm::vec3 normal, glm::vec3 offset) {
+        const glm::ivec3 voxel(x, y, z);
+        auto covered = [&](int axis, int sign) {
+            glm::ivec3 across = voxel;
+            across[axis] += sign;
+            return is_solid(rows, borders, across.x, across.y, across.z);
+        };
+
+        for (int axis {0}; axis < 3; axis++) {
+            if (normal[axis] != 0.0f && covered(axis, normal[axis] > 0.0f ? 1 : -1)) normal[axis] = 0.0f;
+        }
+        const float length = glm::length(normal);
+        if (length > 0.0f) return normal / length;
+
+        //FALLBACK: the normal only pointed into internal faces (a shape entering the next box of a flat floor from the side)
+        glm::vec3 face(0.0f);
+        float closest {-std::numeric_limits<float>::infinity()};
+        for (int axis {0}; axis < 3; axis++) {
+            for (const int sign : { -1, 1 }) {
+                if (covered(axis, sign) || offset[axis] * sign <= closest) continue;
+
+                closest = offset[axis] * sign;
+                face = glm::vec3(0.0f);
+                face[axis] = static_cast<float>(sign);
+            }
+        }
+        return face;
+    }
+
+    bool cast_ray(const ChunkRow* rows, glm::vec3 origin, glm::vec3 direction, float max_fraction, bool starts_inside_hit, float& fraction, int& voxel) {
+        //CLIP: the part of the ray inside [0, SIZE]^3
+        float t_enter {0.0f};
+        float t_exit {max_fraction};
+        for (int axis {0}; axis < 3; axis++) {
+            if (direction[axis] == 0.0f) {
+                if (origin[axis] < 0.0f || origin[axis] > SIZE) return false;
+                continue;
+            }
+
+            float t0 = -origin[axis] / direction[axis];
+            float t1 = (SIZE - origin[axis]) / direction[axis];
+            if (t0 > t1) std::swap(t0, t1);
+            t_enter = std::max(t_enter, t0);
+            t_exit = std::min(t_exit, t1);
+        }
+        if (t_enter > t_exit) return false;
+
+        //DDA: t_next is the fraction at which the ray crosses the next voxel boundary of an axis
+        const glm::vec3 start = origin + direction * t_enter;
+        glm::ivec3 cell = glm::clamp(glm::ivec3(glm::floor(start)), glm::ivec3(0), glm::ivec3(SIZE - 1));
+        glm::ivec3 step;
+        glm::vec3 t_next;
+        glm::vec3 t_delta;
+        for (int axis {0}; axis < 3; axis++) {
+            if (direction[axis] > 0.0f) {
+                step[axis] = 1;
+                t_next[axis] = (cell[axis] + 1 - origin[axis]) / direction[axis];
+                t_delta[axis] = 1.0f / direction[axis];
+            }
+            else if (direction[axis] < 0.0f) {
+                step[axis] = -1;
+                t_next[axis] = (cell[axis] - origin[axis]) / direction[axis];
+                t_delta[axis] = -1.0f / direction[axis];
+            }
+            else {
+                step[axis] = 0;
+                t_next[axis] = std::numeric_limits<float>::infinity();
+                t_delta[axis] = 0.0f;
+            }
+        }
+
+        //NOTE: only a ray that starts inside the chunk can start inside a voxel, one entering from outside hits the border voxel
+        bool inside_solid = t_enter == 0.0f && !starts_inside_hit && is_solid(rows, cell.x, cell.y, cell.z);
+        float t = t_enter;
+        while (true) {
+            const bool solid = is_solid(rows, cell.x, cell.y, cell.z);
+            if (solid && !inside_solid) {
+                fraction = t;
+                voxel = voxel_index(cell.x, cell.y, cell.z);
+                return true;
+            }
+            if (!solid) inside_solid = false;
+
+            const int axis = t_next.x < t_next.y ? (t_next.x < t_next.z ? 0 : 2) : (t_next.y < t_next.z ? 1 : 2);
+            t = t_next[axis];
+            if (t > t_exit) return false;
+
+            cell[axis] += step[axis];
+            if (cell[axis] < 0 || cell[axis] >= SIZE) return false;
+            t_next[axis] += t_delta[axis];
+        }
+    }
+
+    void visit_surface_voxels(const ChunkRow* rows, glm::ivec3 min, glm::ivec3 max, const std::function<bool(int x, int y, int z)>& visit) {
+        min = glm::max(min, glm::ivec3(0));
+        max = glm::min(max, glm::ivec3(SIZE - 1));
+        if (min.x > max.x || min.y > max.y || min.z > max.z) return;
+
+        const int width = max.x - min.x + 1;
+        const ChunkRow ones = width >= SIZE ? static_cast<ChunkRow>(~ChunkRow {0}) : static_cast<ChunkRow>((ChunkRow {1} << width) - 1);
+        const ChunkRow x_range = static_cast<ChunkRow>(ones << min.x);
+
+        for (int y {min.y}; y <= max.y; y++) {
+            for (int z {min.z}; z <= max.z; z++) {
+                const ChunkRow row = rows[z + (y * SIZE)];
+                if (!(row & x_range)) continue;
+
+                //ENCLOSED: all 6 neighbours solid, shifts bring in zeros at the chunk border
+                ChunkRow enclosed = static_cast<ChunkRow>((row << 1) & (row >> 1));
+                enclosed &= y > 0 ? rows[z + ((y - 1) * SIZE)] : ChunkRow {0};
+                enclosed &= y < SIZE - 1 ? rows[z + ((y + 1) * SIZE)] : ChunkRow {0};
+                enclosed &= z > 0 ? rows[(z - 1) + (y * SIZE)] : ChunkRow {0};
+                enclosed &= z < SIZE - 1 ? rows[(z + 1) + (y * SIZE)] : ChunkRow {0};
+
+                for (ChunkRow bits = row & ~enclosed & x_range; bits != 0; bits &= bits - 1) {
+                    if (!visit(std::countr_zero(bits), y, z)) return;
+                }
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "game/voxel_shape.h"
+
+#include <algorithm>
+#include <Jolt/Geometry/Plane.h>
+#include <Jolt/Physics/Body/MassProperties.h>
+#include <Jolt/Physics/Collision/ActiveEdgeMode.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollidePointResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionDispatch.h>
+#include <Jolt/Physics/Collision/PhysicsMaterial.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <Jolt/Physics/Collision/TransformedShape.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#ifdef JPH_DEBUG_RENDERER
+#include <Jolt/Renderer/DebugRenderer.h>
+#endif
+
+namespace Voxel::Game {
+    using namespace JPH;
+
+    static glm::vec3 to_glm(Vec3Arg value) {
+        return glm::vec3(value.GetX(), value.GetY(), value.GetZ());
+    }
+
+    static Vec3 voxel_center(uint index) {
+        return Vec3(index % SIZE + 0.5f, (index / SIZE) % SIZE + 0.5f, index / (SIZE * SIZE) + 0.5f);
+    }
+
+    //NOTE: voxels whose unit box can overlap the chunk space bounds (clamped first, far away bounds must not overflow the int conversion)
+    static void visit_surface_voxels(const VoxelShape& shape, const AABox& bounds, const std::function<bool(uint index)>& visit) {
+        const glm::vec3 min = glm::clamp(to_glm(bounds.mMin), glm::vec3(-1.0f), glm::vec3(SIZE));
+        const glm::vec3 max = glm::clamp(to_glm(bounds.mMax), glm::vec3(-1.0f), glm::vec3(SIZE));
+        VoxelCollision::visit_surface_voxels(shape.get_rows(), glm::ivec3(glm::floor(min)), glm::ivec3(glm::floor(max)), [&](int x, int y, int z) {
+            return visit(static_cast<uint>(VoxelCollision::voxel_index(x, y, z)));
+        });
+    }
+
+    //NOTE: one unit box shared by all voxels, the queries move it to the voxel's center
+    //NOTE: no convex radius, rounded box edges would leave a groove between every two voxels of a flat floor
+    //      (a 0.5 sphere sinks 2.3 mm into it, a rolling one bumps along every seam)
+    static const Shape* voxel_box() {
+        static RefConst<Shape> box = new BoxShape(Vec3::sReplicate(0.5f), 0.0f);
+        return box.GetPtr();
+    }
+
+    //ACTIVE-FACES: forwards the hits of one voxel box with the penetration axis turned away from the voxel's internal faces,
+    //              the axis moves shape 2 (the voxel) out, the voxel's outward normal is its negation (transform2 = chunk to world)
+    template <class Collector>
+    class ActiveFaceCollector final : public Collector {
+    public:
+        ActiveFaceCollector(Collector& collector, const VoxelShape& voxels, Mat44Arg center_of_mass_transform2) :
+            Collector(collector), collector(collector), voxels(voxels), center_of_mass_transform2(center_of_mass_transform2) {}
+
+        void AddHit(const typename Collector::ResultType& result) override {
+            typename Collector::ResultType fixed = result;
+            const float depth = result.mPenetrationAxis.Length();
+            if (depth > 0.0f) {
+                const Vec3 normal = center_of_mass_transform2.Multiply3x3Transposed(-result.mPenetrationAxis / depth);
+                const Vec3 contact = center_of_mass_transform2.Multiply3x3Transposed(result.mContactPointOn2 - center_of_mass_transform2.GetTranslation());
+                const glm::vec3 offset = to_glm(contact) - glm::vec3(voxel) - glm::vec3(0.5f);
+                const glm::vec3 exposed = VoxelCollision::exposed_normal(voxels.get_rows(), voxels.get_borders(), voxel.x, voxel.y, voxel.z, to_glm(normal), offset);
+                if (exposed != glm::vec3(0.0f) && glm::dot(exposed, to_glm(normal)) < 0.999f) {
+                    fixed.mPenetrationAxis = center_of_mass_transform2.Multiply3x3(-Vec3(exposed.x, exposed.y, exposed.z)) * depth;
+                    //NOTE: the faces were picked along the old axis, one contact point instead of a manifold clipped against the wrong face
+                    fixed.mShape1Face.clear();
+                    fixed.mShape2Face.clear();
+                }
+            }
+            collector.AddHit(fixed);
+            Collector::UpdateEarlyOutFraction(collector.GetEarlyOutFraction());
+        }
+
+        glm::ivec3 voxel {0};
+    private:
+        Collector& collector;
+        const VoxelShape& voxels;
+        Mat44 center_of_mass_transform2;
+    };
+
+    static glm::ivec3 voxel_position(uint index) {
+        return glm::ivec3(index % SIZE, (index / SIZE) % SIZE, index / (SIZE * SIZE));
+    }
+
+    VoxelShape::VoxelShape(const ChunkRow* rows, const ChunkRow* const* neighbours) : Shape(EShapeType::User1, EShapeSubType::User1) {
+        std::copy(rows, rows + (SIZE * SIZE), this->rows.begin());
+        VoxelCollision::copy_borders(neighbours, borders);
+
+        glm::ivec3 min, max;
+        if (VoxelCollision::compute_bounds(rows, min, max)) local_bounds = AABox(Vec3(min.x, min.y, min.z), Vec3(max.x, max.y, max.z));
+        else local_bounds = AABox(Vec3::sZero(), Vec3::sZero());
+    }
+
+    MassProperties VoxelShape::GetMassProperties() const {
+        //NOTE: static only (MustBeStatic), never simulated
+        return MassProperties();
+    }
+
+    const PhysicsMaterial* VoxelShape::GetMaterial(const SubShapeID& sub_shape_id) const {
+        return PhysicsMaterial::sDefault.GetPtr();
+    }
+
+    Vec3 VoxelShape::GetSurfaceNormal(const SubShapeID& sub_shape_id, Vec3Arg local_surface_position) const {
+        SubShapeID remainder;
+        const uint index = sub_shape_id.PopID(SUB_SHAPE_ID_BITS, remainder);
+
+        //NOTE: the face of the voxel the position lies on is the axis it is furthest away from the center
+        const Vec3 offset = local_surface_position - voxel_center(index);
+        const int axis = offset.Abs().GetHighestComponentIndex();
+        Vec3 normal = Vec3::sZero();
+        normal.SetComponent(axis, offset[axis] > 0.0f ? 1.0f : -1.0f);
+        return normal;
+    }
+
+    void VoxelShape::GetSubmergedVolume(
+        Mat44Arg center_of_mass_transform, Vec3Arg scale, const JPH::Plane& surface,
+        float& total_volume, float& submerged_volume, Vec3& center_of_buoyancy
+        JPH_IF_DEBUG_RENDERER(, RVec3Arg base_offset)
+    ) const {
+        //NOTE: static terrain does not float
+        total_volume = 0.0f;
+        submerged_volume = 0.0f;
+        center_of_buoyancy = Vec3::sZero();
+    }
+
+    #ifdef JPH_DEBUG_RENDERER
+    void VoxelShape::Draw(DebugRenderer* renderer, RMat44Arg center_of_mass_transform, Vec3Arg scale, ColorArg color, bool use_material_colors, bool draw_wireframe) const {
+        renderer->DrawWireBox(center_of_mass_transform.PreScaled(scale), local_bounds, color);
+    }
+    #endif
+
+    bool VoxelShape::CastRay(const RayCast& ray, const SubShapeIDCreator& sub_shape_id_creator, RayCastResult& hit) const {
+        float fraction;
+        int voxel;
+        if (!VoxelCollision::cast_ray(rows.data(), to_glm(ray.mOrigin), to_glm(ray.mDirection), hit.mFraction, true, fraction, voxel)) return false;
+        if (fraction >= hit.mFraction) return false;
+
+        hit.mFraction = fraction;
+        hit.mSubShapeID2 = sub_shape_id_creator.PushID(static_cast<uint>(voxel), SUB_SHAPE_ID_BITS).GetID();
+        return true;
+    }
+
+    void VoxelShape::CastRay(
+        const RayCast& ray, const RayCastSettings& settings, const SubShapeIDCreator& sub_shape_id_creator,
+        CastRayCollector& collector, const ShapeFilter& shape_filter
+    ) const {
+        if (!shape_filter.ShouldCollide(this, sub_shape_id_creator.GetID())) return;
+
+        float fraction;
+        int voxel;
+        if (!VoxelCollision::cast_ray(rows.data(), to_glm(ray.mOrigin), to_glm(ray.mDirection), collector.GetEarlyOutFraction(), settings.mTreatConvexAsSolid, fraction, voxel)) return;
+
+        RayCastResult hit;
+        hit.mBodyID = TransformedShape::sGetBodyID(collector.GetContext());
+        hit.mFraction = fraction;
+        hit.mSubShapeID2 = sub_shape_id_creator.PushID(static_cast<uint>(voxel), SUB_SHAPE_ID_BITS).GetID();
+        collector.AddHit(hit);
+    }
+
+    void VoxelShape::CollidePoint(Vec3Arg point, const SubShapeIDCreator& sub_shape_id_creator, CollidePointCollector& collector, const ShapeFilter& shape_filter) const {
+        if (!shape_filter.ShouldCollide(this, sub_shape_id_creator.GetID())) return;
+
+        const glm::ivec3 voxel(glm::floor(glm::clamp(to_glm(point), glm::vec3(-1.0f), glm::vec3(SIZE))));
+        if (!VoxelCollision::is_solid(rows.data(), voxel.x, voxel.y, voxel.z)) return;
+
+        CollidePointResult result;
+        result.mBodyID = TransformedShape::sGetBodyID(collector.GetContext());
+        result.mSubShapeID2 = sub_shape_id_creator.PushID(static_cast<uint>(VoxelCollision::voxel_index(voxel.x, voxel.y, voxel.z)), SUB_SHAPE_ID_BITS).GetID();
+        collector.AddHit(result);
+    }
+
+    void VoxelShape::CollideSoftBodyVertices(
+        Mat44Arg center_of_mass_transform, Vec3Arg scale,
+        const CollideSoftBodyVertexIterator& vertices, uint num_vertices, int colliding_shape_index
+    ) const {
+        //NOTE: there are no soft bodies in the world
+    }
+
+    void VoxelShape::GetTrianglesStart(GetTrianglesContext& context, const AABox& box, Vec3Arg position_com, QuatArg rotation, Vec3Arg scale) const {
+        //NOTE: the shape has no triangles (GetTrianglesNext returns none), the chunk mesh is the visual representation
+    }
+
+    int VoxelShape::GetTrianglesNext(GetTrianglesContext& context, int max_triangles_requested, Float3* triangle_vertices, const PhysicsMaterial** materials) const {
+        return 0;
+    }
+
+    //COLLIDE: convex shape 1 against the unit boxes of the surface voxels its bounds overlap
+    static void collide_convex_vs_voxels(
+        const Shape* shape1, const Shape* shape2, Vec3Arg scale1, Vec3Arg scale2,
+        Mat44Arg center_of_mass_transform1, Mat44Arg center_of_mass_transform2,
+        const SubShapeIDCreator& sub_shape_id_creator1, const SubShapeIDCreator& sub_shape_id_creator2,
+        const CollideShapeSettings& settings, CollideShapeCollector& collector, const ShapeFilter& shape_filter
+    ) {
+        //NOTE: chunks are never scaled, scale2 is ignored
+        const VoxelShape* voxels = static_cast<const VoxelShape*>(shape2);
+        const Mat44 shape1_to_chunk = center_of_mass_transform2.InversedRotationTranslation() * center_of_mass_transform1;
+        AABox bounds = shape1->GetWorldSpaceBounds(shape1_to_chunk, scale1);
+        bounds.ExpandBy(Vec3::sReplicate(settings.mMaxSeparationDistance));
+
+        const bool active_only = settings.mActiveEdgeMode == EActiveEdgeMode::CollideOnlyWithActive;
+        ActiveFaceCollector<CollideShapeCollector> active_faces(collector, *voxels, center_of_mass_transform2);
+        CollideShapeCollector& voxel_collector = active_only ? active_faces : collector;
+
+        const ShapeFilter no_filter;
+        visit_surface_voxels(*voxels, bounds, [&](uint index) {
+            const SubShapeIDCreator voxel_id = sub_shape_id_creator2.PushID(index, VoxelShape::SUB_SHAPE_ID_BITS);
+            if (!shape_filter.ShouldCollide(shape1, sub_shape_id_creator1.GetID(), voxels, voxel_id.GetID())) return true;
+
+            active_faces.voxel = voxel_position(index);
+            CollisionDispatch::sCollideShapeVsShape(
+                shape1, voxel_box(), scale1, Vec3::sOne(),
+                center_of_mass_transform1, center_of_mass_transform2 * Mat44::sTranslation(voxel_center(index)),
+                sub_shape_id_creator1, voxel_id, settings, voxel_collector, no_filter
+            );
+            return !collector.ShouldEarlyOut();
+        });
+    }
+
+    //CAST: the swept bounds of the convex shape select the voxels, the cast arrives in the chunk's local space
+    static void cast_convex_vs_voxels(
+        const ShapeCast& shape_cast, const ShapeCastSettings& settings, const Shape* shape, Vec3Arg scale,
+        const ShapeFilter& shape_filter, Mat44Arg center_of_mass_transform2,
+        const SubShapeIDCreator& sub_shape_id_creator1, const SubShapeIDCreator& sub_shape_id_creator2, CastShapeCollector& collector
+    ) {
+        const VoxelShape* voxels = static_cast<const VoxelShape*>(shape);
+        AABox bounds = shape_cast.mShapeWorldBounds;
+        bounds.Encapsulate(AABox(bounds.mMin + shape_cast.mDirection, bounds.mMax + shape_cast.mDirection));
+
+        const bool active_only = settings.mActiveEdgeMode == EActiveEdgeMode::CollideOnlyWithActive;
+        ActiveFaceCollector<CastShapeCollector> active_faces(collector, *voxels, center_of_mass_transform2);
+        CastShapeCollector& voxel_collector = active_only ? active_faces : collector;
+
+        const ShapeFilter no_filter;
+        visit_surface_voxels(*voxels, bounds, [&](uint index) {
+            const SubShapeIDCreator voxel_id = sub_shape_id_creator2.PushID(index, VoxelShape::SUB_SHAPE_ID_BITS);
+            if (!shape_filter.ShouldCollide(shape_cast.mShape, sub_shape_id_creator1.GetID(), voxels, voxel_id.GetID())) return true;
+
+            const Vec3 center = voxel_center(index);
+            active_faces.voxel = voxel_position(index);
+            CollisionDispatch::sCastShapeVsShapeLocalSpace(
+                shape_cast.PostTranslated(-center), settings, voxel_box(), Vec3::sOne(), no_filter,
+                center_of_mass_transform2 * Mat44::sTranslation(center), sub_shape_id_creator1, voxel_id, voxel_collector
+            );
+            return !collector.ShouldEarlyOut();
+        });
+    }
+
+    void VoxelShape::register_collisions() {
+        ShapeFunctions::sGet(EShapeSubType::User1).mColor = Color::sDarkGreen;
+
+        for (const EShapeSubType sub_type : sConvexSubShapeTypes) {
+            CollisionDispatch::sRegisterCollideShape(sub_type, EShapeSubType::User1, collide_convex_vs_voxels);
+            CollisionDispatch::sRegisterCastShape(sub_type, EShapeSubType::User1, cast_convex_vs_voxels);
+            CollisionDispatch::sRegisterCollideShape(EShapeSubType::User1, sub_type, CollisionDispatch::sReversedCollideShape);
+            CollisionDispatch::sRegisterCastShape(EShapeSubType::User1, sub_type, CollisionDispatch::sReversedCastShape);
+        }
+
+        //NOTE: two static chunks never collide
+        CollisionDispatch::sRegisterCollideShape(EShapeSubType::User1, EShapeSubType::User1,
+            [](const Shape*, const Shape*, Vec3Arg, Vec3Arg, Mat44Arg, Mat44Arg, const SubShapeIDCreator&, const SubShapeIDCreator&, const CollideShapeSettings&, CollideShapeCollector&, const ShapeFilter&) {});
+        CollisionDispatch::sRegisterCastShape(EShapeSubType::User1, EShapeSubType::User1,
+            [](const ShapeCast&, const ShapeCastSettings&, const Shape*, Vec3Arg, const ShapeFilter&, Mat44Arg, const SubShapeIDCreator&, const SubShapeIDCreator&, CastShapeCollector&) {});
+    }
+}
\ No newline at end of file